@@ -9,6 +9,6 @@ public class proceduralPlanetTarget : TargetRules
 	{
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
-		ExtraModuleNames.AddRange( new string[] { "proceduralPlanet" } );
+		ExtraModuleNames.AddRange( new string[] { "proceduralPlanet", "proceduralPlanetCompute" } );
 	}
 }
@@ -195,33 +195,42 @@ void ADebugPlayerPawn::UpdateMovementWalking(float DeltaTime)
     // 4. Collision / Ground Snap
     FVector NewLocation = GetActorLocation() + (HorizontalVelocity * DeltaTime) + (GravityDirection * VerticalSpeed * DeltaTime);
 
-    FHitResult Hit;
-    // Simple capsule sweep
-    // FIX: Lift the trace start slightly against gravity.
-    // This prevents the trace from starting "inside" the ground if the pawn is slightly embedded.
-    FVector TraceStart = GetActorLocation() - (GravityDirection * 10.0f);
-    FVector TraceEnd = NewLocation + (GravityDirection * 50.0f);  // Look ahead slightly
-
-    FCollisionQueryParams Params;
-    Params.AddIgnoredActor(this);
-
-    // DEBUG: Visualize the ground check
-    // DrawDebugLine(GetWorld(), TraceStart, TraceEnd, FColor::Red, false, -1.0f, 0, 2.0f);
-
     bool bLanded = false;
 
-    // If we hit something
-    if (GetWorld()->SweepSingleByChannel(Hit, TraceStart, TraceEnd, GetActorQuat(), ECC_WorldStatic, CapsuleComponent->GetCollisionShape(), Params))
+    // The planet answers from its density field: no collision has to be cooked under the pawn
+    FVector GroundLocation;
+    if (TargetPlanet && TargetPlanet->GetSurfaceLocation(NewLocation, GroundLocation))
+    {
+        // Capsule center resting on the ground. Same 50 units of look-ahead as the sweep, so walking downhill stays grounded.
+        const FVector RestLocation = GroundLocation + SurfaceNormal * CapsuleComponent->GetScaledCapsuleHalfHeight();
+        if (FVector::DotProduct(NewLocation - RestLocation, SurfaceNormal) <= 50.0f)
+        {
+            NewLocation = RestLocation + (SurfaceNormal * 0.1f);
+            VerticalSpeed = 0.0f;  // Reset gravity accumulation
+            bLanded = true;
+        }
+    }
+    else
     {
-        // Snap to floor
-        // FIX: For a Sweep, Hit.Location is already the location of the Capsule Center.
-        // We just add a tiny offset (0.1f) to prevent Z-fighting/penetration in the next frame.
-        NewLocation = Hit.Location + (SurfaceNormal * 0.1f);
-        VerticalSpeed = 0.0f;  // Reset gravity accumulation
-        bLanded = true;
-
-        // DEBUG: Visualize hit
-        // DrawDebugPoint(GetWorld(), Hit.Location, 10.0f, FColor::Green, false, -1.0f);
+        // Planet not generated: fall back to a sweep against whatever collision exists
+        FHitResult Hit;
+        // FIX: Lift the trace start slightly against gravity.
+        // This prevents the trace from starting "inside" the ground if the pawn is slightly embedded.
+        FVector TraceStart = GetActorLocation() - (GravityDirection * 10.0f);
+        FVector TraceEnd = NewLocation + (GravityDirection * 50.0f);  // Look ahead slightly
+
+        FCollisionQueryParams Params;
+        Params.AddIgnoredActor(this);
+
+        if (GetWorld()->SweepSingleByChannel(Hit, TraceStart, TraceEnd, GetActorQuat(), ECC_WorldStatic, CapsuleComponent->GetCollisionShape(), Params))
+        {
+            // Snap to floor
+            // FIX: For a Sweep, Hit.Location is already the location of the Capsule Center.
+            // We just add a tiny offset (0.1f) to prevent Z-fighting/penetration in the next frame.
+            NewLocation = Hit.Location + (SurfaceNormal * 0.1f);
+            VerticalSpeed = 0.0f;  // Reset gravity accumulation
+            bLanded = true;
+        }
     }
 
     FVector OldLocation = GetActorLocation();
@@ -2,6 +2,18 @@
 
 #include "CoreMinimal.h"
 #include "DataTypes.h"
+#include "Components/MeshComponent.h"
+
+
+class FChunk;
+
+
+// Links of an intrusive chunk list. The lists themselves are owned by FChunkManager.
+struct FChunkListLink
+{
+        FChunk *Prev = nullptr;
+        FChunk *Next = nullptr;
+};
 
 
 // A pure C++ representation of a terrain chunk.
@@ -10,17 +22,36 @@ class FChunk
 {
     public:
         FChunkId Id;          // Identity
-        EChunkState State;    // Lifecycle State
+        EChunkState State;    // Lifecycle State. Only written through FChunkManager::SetChunkState, which indexes it
         uint32 GenerationId;  // To handle async cancellations (if GenerationId changes, ignore old task results)
 
         FChunkTransform Transform;  // Spatial Info
 
-        GenData DensityField;                  // This holds the actual density field
-        bool bIsDensityDataGenerated = false;  // Is the data ready to be turned into a mesh?
+        // Noise-band samples of the last generation, kept until the children of a split no longer need them.
+        // Shared with the workers seeding those children. Null if not retained (max LOD, cache hit, reuse disabled).
+        FRetainedDensityPtr DensityField;
+
+        bool bPrefetched = false;  // Requested by the look-ahead pass before anything needed it
+        bool bDemanded = false;    // Has been part of LoadSet at least once (prefetch accounting)
+        double DemandTime = 0.0;   // When it first became part of LoadSet, cleared once shown (request -> visible latency)
+
+        bool bSeamRefreshPending = false;  // Regenerating for new neighbour LODs, the current mesh stays until the result arrives
 
         TUniquePtr<FChunkMeshData> MeshData;  // The generated mesh data (Valid only when State >= DataReady)
 
-        TWeakObjectPtr<UProceduralMeshComponent> RenderProxy;  // Reference to the actual component rendering this chunk (Valid only when State == MeshReady)
+        // Reference to the actual component rendering this chunk (Valid only when State == MeshReady).
+        // UChunkMeshComponent or UProceduralMeshComponent depending on the render backend.
+        TWeakObjectPtr<UMeshComponent> RenderProxy;
+
+        // Intrusive bookkeeping, only touched by FChunkManager
+        FChunkListLink StateLink;     // In the manager's list of chunks in State
+        FChunkListLink NeededLink;    // In the manager's list ordered by LastNeededFrame
+        uint32 LastNeededFrame = 0;  // Last update in which the chunk was in LoadSet or PrefetchSet
+
+        // Share of the manager's resident memory totals, so each re-count only applies the difference
+        int64 ResidentCPUBytes = 0;
+        int64 ResidentGPUBytes = 0;
+        bool bResidentComponent = false;
 
         // Constructor
         FChunk(const FChunkId &InId) :
@@ -43,4 +74,67 @@ class FChunk
             // TUniquePtr automatically cleans up MeshData
             // WeakObjectPtr handles itself (doesn't destroy the component)
         }
-};
\ No newline at end of file
+};
+
+
+// Intrusive doubly linked list of chunks, threaded through one FChunkListLink member of FChunk.
+// O(1) insertion and removal, never allocates. A chunk is in at most one list per link member.
+template <FChunkListLink FChunk::*Link>
+class TChunkList
+{
+    public:
+        FChunk *GetHead() const { return Head; }
+        int32 Num() const { return Count; }
+
+        static FChunk *GetNext(const FChunk *Chunk) { return (Chunk->*Link).Next; }
+
+        void AddTail(FChunk *Chunk)
+        {
+            FChunkListLink &ChunkLink = Chunk->*Link;
+            ChunkLink.Prev = Tail;
+            ChunkLink.Next = nullptr;
+
+            if (Tail)
+                (Tail->*Link).Next = Chunk;
+            else
+                Head = Chunk;
+
+            Tail = Chunk;
+            Count++;
+        }
+
+        void Remove(FChunk *Chunk)
+        {
+            FChunkListLink &ChunkLink = Chunk->*Link;
+
+            if (ChunkLink.Prev)
+                (ChunkLink.Prev->*Link).Next = ChunkLink.Next;
+            else
+                Head = ChunkLink.Next;
+
+            if (ChunkLink.Next)
+                (ChunkLink.Next->*Link).Prev = ChunkLink.Prev;
+            else
+                Tail = ChunkLink.Prev;
+
+            ChunkLink.Prev = nullptr;
+            ChunkLink.Next = nullptr;
+            Count--;
+        }
+
+        void MoveToTail(FChunk *Chunk)
+        {
+            if (Tail == Chunk)
+                return;
+
+            Remove(Chunk);
+            AddTail(Chunk);
+        }
+
+    private:
+        FChunk *Head = nullptr;
+        FChunk *Tail = nullptr;
+        int32 Count = 0;
+};
+
+using FChunkStateList = TChunkList<&FChunk::StateLink>;
\ No newline at end of file
@@ -0,0 +1,312 @@
+#include "ChunkCollisionManager.h"
+#include "Engine/Engine.h"  // For GIsRequestingExit
+#include "PlanetStats.h"
+#include "Tasks/Task.h"
+
+
+FChunkCollisionManager::FChunkCollisionManager(AActor *InOwner, const FPlanetConfig &InConfig) :
+    OwnerActor(InOwner),
+    Config(InConfig)
+{
+    BuiltQueue = MakeShared<FBuiltCollisionQueue, ESPMode::ThreadSafe>();
+}
+
+
+FChunkCollisionManager::~FChunkCollisionManager()
+{
+    Stop();
+
+    // Same rule as the renderer: during engine exit the components may already be gone
+    if (GIsRequestingExit)
+        return;
+
+    for (TPair<FChunkId, FCollisionEntry> &Pair : Entries)
+    {
+        if (UProceduralMeshComponent *Comp = Pair.Value.Component.Get())
+            FreeComponentPool.Add(Comp);
+    }
+    Entries.Empty();
+
+    for (TWeakObjectPtr<UProceduralMeshComponent> &WeakComp : FreeComponentPool)
+    {
+        if (UProceduralMeshComponent *Comp = WeakComp.Get())
+        {
+            if (!Comp->IsBeingDestroyed())
+                Comp->DestroyComponent();
+        }
+    }
+    FreeComponentPool.Empty();
+}
+
+
+void FChunkCollisionManager::Stop()
+{
+    bIsStopping = true;
+
+    // Builds still running push into the shared queue, nobody reads it anymore
+    BuiltQueue->Empty();
+    Stats.BuildsInFlight = 0;
+}
+
+
+void FChunkCollisionManager::Update(TArray<FCollisionRequest> &Requests)
+{
+    if (bIsStopping)
+        return;
+
+    UpdateFrame++;
+
+    // Nearest first: the build slots and the cook budget go to the chunks a pawn will touch soonest
+    Requests.Sort([](const FCollisionRequest &A, const FCollisionRequest &B) { return A.Distance < B.Distance; });
+
+    for (const FCollisionRequest &Request : Requests)
+    {
+        const FChunk *Chunk = Request.Chunk;
+
+        FCollisionEntry *Entry = Entries.Find(Chunk->Id);
+        if (!Entry)
+        {
+            if (!Request.bAllowBuild)
+                continue;
+
+            Entry = &Entries.Add(Chunk->Id);
+        }
+        Entry->LastRequestedFrame = UpdateFrame;
+
+        const bool bUpToDate = Entry->bCooked && Entry->GenerationId == Chunk->GenerationId;
+        if (Request.bAllowBuild && !bUpToDate && !Entry->bBuilding && Chunk->MeshData && Stats.BuildsInFlight < Config.MaxConcurrentCollisionBuilds)
+        {
+            StartBuild(Chunk, *Entry);
+        }
+    }
+
+    // Out of range, or no longer rendered: free the component for a nearer chunk
+    for (auto It = Entries.CreateIterator(); It; ++It)
+    {
+        if (It->Value.LastRequestedFrame != UpdateFrame)
+        {
+            ReleaseComponent(It->Value);
+            It.RemoveCurrent();
+        }
+    }
+
+    CookBuiltMeshes();
+
+    Stats.CollidingChunks = Entries.Num();
+}
+
+
+void FChunkCollisionManager::ReleaseChunk(const FChunkId &Id)
+{
+    if (FCollisionEntry *Entry = Entries.Find(Id))
+    {
+        ReleaseComponent(*Entry);
+        Entries.Remove(Id);
+    }
+}
+
+
+void FChunkCollisionManager::StartBuild(const FChunk *Chunk, FCollisionEntry &Entry)
+{
+    Entry.bBuilding = true;
+    Entry.BuildGenerationId = Chunk->GenerationId;
+    Stats.BuildsInFlight++;
+
+    // Clusters are measured in voxels of the chunk's own LOD, so every LOD is decimated by the same ratio
+    const float CellSize = Config.CollisionDecimation > 1 ? Config.CollisionDecimation * Config.VoxelSize * Chunk->Transform.Scale : 0.f;
+
+    // The chunk's mesh can be replaced while the worker runs: it builds from its own copy
+    FBuiltCollision Seed;
+    Seed.Id = Chunk->Id;
+    Seed.GenerationId = Chunk->GenerationId;
+    Seed.Location = Chunk->Transform.Location;
+    Seed.Rotation = Chunk->Transform.Rotation;
+    Seed.SourceTriangleCount = Chunk->MeshData->Triangles.Num() / 3;
+
+    TSharedPtr<FBuiltCollisionQueue, ESPMode::ThreadSafe> Queue = BuiltQueue;
+
+    const FChunkMeshData &Source = *Chunk->MeshData;
+
+    UE::Tasks::Launch(
+        UE_SOURCE_LOCATION,
+        [Seed = MoveTemp(Seed), SourcePositions = Source.Positions, SourceSeamPositions = Source.SeamPositions, QuantMin = Source.QuantizationMin,
+         QuantSize = Source.QuantizationSize, SourceTriangles = Source.Triangles, CellSize, Queue]() mutable
+        {
+            PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetCollisionBuild);
+            TArray<FVector> SourceVertices;
+            FChunkMeshData::DecodePositions(SourcePositions, SourceSeamPositions, QuantMin, QuantSize, SourceVertices);
+            BuildCollisionMesh(SourceVertices, SourceTriangles, CellSize, SourcePositions.Num() / 3, Seed.Vertices, Seed.Triangles);
+            Queue->Enqueue(MoveTemp(Seed));
+        });
+}
+
+
+void FChunkCollisionManager::CookBuiltMeshes()
+{
+    const double StartTime = FPlatformTime::Seconds();
+    const double BudgetSeconds = Config.CollisionCookBudgetMs / 1000.0;
+    int32 Cooked = 0;
+
+    // The budget only applies once a mesh was cooked: at least one is per frame, even over budget or with a zero budget
+    FBuiltCollision Built;
+    while ((Cooked == 0 || FPlatformTime::Seconds() - StartTime < BudgetSeconds) && BuiltQueue->Dequeue(Built))
+    {
+        Stats.BuildsInFlight--;
+
+        // Released, or re-requested for a newer mesh, while building
+        FCollisionEntry *Entry = Entries.Find(Built.Id);
+        if (!Entry || !Entry->bBuilding || Entry->BuildGenerationId != Built.GenerationId)
+            continue;
+
+        Entry->bBuilding = false;
+        Entry->bCooked = true;
+        Entry->GenerationId = Built.GenerationId;
+
+        Stats.SourceTriangles += Built.SourceTriangleCount;
+        Stats.CollisionTriangles += Built.Triangles.Num() / 3;
+
+        if (Built.Triangles.Num() == 0)
+        {
+            ReleaseComponent(*Entry);
+            continue;
+        }
+
+        UProceduralMeshComponent *Comp = Entry->Component.Get();
+        if (!Comp)
+        {
+            Comp = GetFreeComponent();
+            if (!Comp)
+                continue;
+            Entry->Component = Comp;
+        }
+
+        Comp->SetRelativeLocationAndRotation(Built.Location, Built.Rotation);
+
+        // Async cooking: the previous body keeps colliding until the new trimesh is ready
+        Comp->CreateMeshSection(0,
+                                Built.Vertices,
+                                Built.Triangles,
+                                TArray<FVector>(),
+                                TArray<FVector2D>(),
+                                TArray<FColor>(),
+                                TArray<FProcMeshTangent>(),
+                                true);
+        Cooked++;
+    }
+
+    Stats.CookedLastFrame = Cooked;
+    Stats.LastFrameMs = (float)((FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+
+UProceduralMeshComponent *FChunkCollisionManager::GetFreeComponent()
+{
+    while (FreeComponentPool.Num() > 0)
+    {
+        if (UProceduralMeshComponent *Comp = FreeComponentPool.Pop().Get())
+            return Comp;
+    }
+
+    if (!OwnerActor)
+        return nullptr;
+
+    // Collision only: never rendered, only the physics body is used
+    UProceduralMeshComponent *Comp = NewObject<UProceduralMeshComponent>(OwnerActor);
+    Comp->bUseAsyncCooking = true;
+    Comp->bUseComplexAsSimpleCollision = true;
+    Comp->SetCollisionProfileName(TEXT("BlockAll"));
+    Comp->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+    Comp->SetVisibility(false);
+    Comp->SetCastShadow(false);
+
+    Comp->RegisterComponent();
+    Comp->AttachToComponent(OwnerActor->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+    Comp->SetComponentTickEnabled(false);
+
+    return Comp;
+}
+
+
+void FChunkCollisionManager::ReleaseComponent(FCollisionEntry &Entry)
+{
+    if (UProceduralMeshComponent *Comp = Entry.Component.Get())
+    {
+        // Clearing the section also drops its physics body
+        if (!GIsRequestingExit && !Comp->IsBeingDestroyed())
+        {
+            Comp->ClearAllMeshSections();
+            FreeComponentPool.Add(Comp);
+        }
+    }
+    Entry.Component.Reset();
+}
+
+
+void FChunkCollisionManager::BuildCollisionMesh(const TArray<FVector> &Vertices, const TArray<int32> &Triangles, float CellSize, int32 FirstPinnedVertex,
+                                                TArray<FVector> &OutVertices, TArray<int32> &OutTriangles)
+{
+    OutVertices.Reset();
+    OutTriangles.Reset();
+
+    if (CellSize <= 0.f)
+    {
+        OutVertices = Vertices;
+        OutTriangles = Triangles;
+        return;
+    }
+
+    // Every vertex falling in the same cell collapses to the cell's average position
+    const float InvCellSize = 1.0f / CellSize;
+    TMap<FIntVector, int32> CellToCluster;
+    CellToCluster.Reserve(Vertices.Num() / 2);
+    TArray<int32> ClusterSizes;
+    TArray<int32> Remap;
+    Remap.SetNumUninitialized(Vertices.Num());
+
+    for (int32 i = 0; i < Vertices.Num(); i++)
+    {
+        const FVector &V = Vertices[i];
+        if (i >= FirstPinnedVertex)
+        {
+            // Pinned: a cluster of its own, never averaged
+            Remap[i] = OutVertices.Add(V);
+            ClusterSizes.Add(1);
+            continue;
+        }
+
+        const FIntVector Cell(FMath::FloorToInt(V.X * InvCellSize), FMath::FloorToInt(V.Y * InvCellSize), FMath::FloorToInt(V.Z * InvCellSize));
+
+        if (const int32 *Cluster = CellToCluster.Find(Cell))
+        {
+            OutVertices[*Cluster] += V;
+            ClusterSizes[*Cluster]++;
+            Remap[i] = *Cluster;
+        }
+        else
+        {
+            Remap[i] = OutVertices.Add(V);
+            ClusterSizes.Add(1);
+            CellToCluster.Add(Cell, Remap[i]);
+        }
+    }
+
+    for (int32 c = 0; c < OutVertices.Num(); c++)
+    {
+        OutVertices[c] /= ClusterSizes[c];
+    }
+
+    // Triangles whose corners merged have no area left
+    OutTriangles.Reserve(Triangles.Num());
+    for (int32 t = 0; t + 2 < Triangles.Num(); t += 3)
+    {
+        const int32 A = Remap[Triangles[t]];
+        const int32 B = Remap[Triangles[t + 1]];
+        const int32 C = Remap[Triangles[t + 2]];
+        if (A != B && B != C && A != C)
+        {
+            OutTriangles.Add(A);
+            OutTriangles.Add(B);
+            OutTriangles.Add(C);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "ProceduralMeshComponent.h"
+#include "Chunk.h"
+
+
+// Chunk wanted with collision this frame, chosen by FChunkManager.
+struct FCollisionRequest
+{
+        const FChunk *Chunk = nullptr;
+        float Distance = 0.f;     // To the nearest physics actor. Nearer chunks are built and cooked first
+        bool bAllowBuild = true;  // False = only keep the collision the chunk already has (hidden, on its way out)
+};
+
+
+// Decimated collision mesh of one chunk, built on a worker and handed to the game thread.
+struct FBuiltCollision
+{
+        FChunkId Id;
+        uint32 GenerationId = 0;  // Generation of the visual mesh it was decimated from
+        FVector Location = FVector::ZeroVector;
+        FQuat Rotation = FQuat::Identity;
+        TArray<FVector> Vertices;
+        TArray<int32> Triangles;
+        int32 SourceTriangleCount = 0;
+};
+
+using FBuiltCollisionQueue = TQueue<FBuiltCollision, EQueueMode::Mpsc>;
+
+
+// Collision pipeline statistics (used by the debug HUD).
+struct FCollisionStats
+{
+        int32 CollidingChunks = 0;  // Chunks holding a cooked (or cooking) collision mesh
+        int32 BuildsInFlight = 0;   // Decimation tasks running on the workers
+        int32 CookedLastFrame = 0;  // Meshes handed to the physics cooker during the last frame
+        float LastFrameMs = 0.f;    // Game-thread time of that hand-off
+        int64 SourceTriangles = 0;  // Totals since startup, for the decimation ratio
+        int64 CollisionTriangles = 0;
+};
+
+
+// Cooks chunk collision near physics actors only, independently of the visual upload.
+// Decimation (vertex clustering) runs on the task system, the game thread only hands the result to a hidden
+// UProceduralMeshComponent within its own time budget, and the trimesh is then cooked asynchronously by the engine.
+// Game thread only, except BuildCollisionMesh.
+class FChunkCollisionManager
+{
+    public:
+        FChunkCollisionManager(AActor *InOwner, const FPlanetConfig &InConfig);
+        ~FChunkCollisionManager();
+
+        // Builds or refreshes the collision of the requested chunks and releases it for every chunk not requested.
+        void Update(TArray<FCollisionRequest> &Requests);
+
+        // Drops the chunk's collision right away (the chunk is being destroyed).
+        void ReleaseChunk(const FChunkId &Id);
+
+        // True if the chunk holds collision or is building it.
+        bool HasCollision(const FChunkId &Id) const { return Entries.Contains(Id); }
+
+        // Discards in-flight builds. Components are destroyed with the manager.
+        void Stop();
+
+        const FCollisionStats &GetStats() const { return Stats; }
+
+        // Vertex clustering on a CellSize grid of the chunk's local space. Degenerate triangles are dropped. Thread-safe.
+        // Vertices from FirstPinnedVertex on (the seam vertices, see FChunkMeshData) are kept as they are, so the border
+        // matches the neighbour's collision exactly: that grid is not aligned with the neighbour's.
+        static void BuildCollisionMesh(const TArray<FVector> &Vertices, const TArray<int32> &Triangles, float CellSize, int32 FirstPinnedVertex,
+                                       TArray<FVector> &OutVertices, TArray<int32> &OutTriangles);
+
+    private:
+        struct FCollisionEntry
+        {
+                TWeakObjectPtr<UProceduralMeshComponent> Component;  // Null until the first non-empty result arrived
+                uint32 GenerationId = 0;                             // Generation the component was cooked from
+                uint32 BuildGenerationId = 0;                        // Generation being built, valid while bBuilding
+                uint32 LastRequestedFrame = 0;
+                bool bCooked = false;
+                bool bBuilding = false;
+        };
+
+        AActor *OwnerActor;
+        FPlanetConfig Config;
+
+        TMap<FChunkId, FCollisionEntry> Entries;
+        TArray<TWeakObjectPtr<UProceduralMeshComponent>> FreeComponentPool;
+        uint32 UpdateFrame = 0;
+
+        // Shared so a worker finishing after the manager is gone still has a valid queue to push to.
+        TSharedPtr<FBuiltCollisionQueue, ESPMode::ThreadSafe> BuiltQueue;
+        bool bIsStopping = false;
+
+        FCollisionStats Stats;
+
+        void StartBuild(const FChunk *Chunk, FCollisionEntry &Entry);
+
+        // Hands built meshes to their components until the frame's budget is spent. The rest waits in the queue.
+        void CookBuiltMeshes();
+
+        UProceduralMeshComponent *GetFreeComponent();
+        void ReleaseComponent(FCollisionEntry &Entry);
+};
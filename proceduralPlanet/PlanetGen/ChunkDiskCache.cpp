@@ -0,0 +1,264 @@
+#include "ChunkDiskCache.h"
+#include "IPlanetNoise.h"
+#include "HAL/FileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+
+FChunkDiskCache::FChunkDiskCache(uint32 InConfigHash, int64 InMaxSizeBytes) :
+    MaxSizeBytes(InMaxSizeBytes)
+{
+    Directory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("PlanetCache"), FString::Printf(TEXT("%08x"), InConfigHash));
+    IFileManager::Get().MakeDirectory(*Directory, true);
+
+    BuildIndex();
+}
+
+
+uint32 FChunkDiskCache::ComputeConfigHash(const FPlanetConfig &Config, const DensityConfig &Density, const IPlanetNoise *Noise)
+{
+    uint32 Hash = GetTypeHash(FormatVersion);
+    if (Noise)
+    {
+        Hash = HashCombine(Hash, GetTypeHash(FString(Noise->getName())));
+        Hash = HashCombine(Hash, GetTypeHash(Noise->getVersion()));
+    }
+    Hash = HashCombine(Hash, GetTypeHash(Config.Seed));
+    Hash = HashCombine(Hash, GetTypeHash(Config.PlanetRadius));
+    Hash = HashCombine(Hash, GetTypeHash(Config.GridResolution));
+    Hash = HashCombine(Hash, GetTypeHash(Density.Seed));
+    Hash = HashCombine(Hash, GetTypeHash(Density.VoxelSize));
+    Hash = HashCombine(Hash, GetTypeHash(Density.Noise.Amplitude));
+    Hash = HashCombine(Hash, GetTypeHash(Density.Noise.Frequency));
+    Hash = HashCombine(Hash, GetTypeHash(Density.Noise.Octaves));
+    Hash = HashCombine(Hash, GetTypeHash(Density.Noise.Lacunarity));
+    Hash = HashCombine(Hash, GetTypeHash(Density.Noise.Persistence));
+    Hash = HashCombine(Hash, GetTypeHash((uint8)Density.NormalMode));
+    Hash = HashCombine(Hash, GetTypeHash((uint8)Config.DensityBackend));
+    return Hash;
+}
+
+
+bool FChunkDiskCache::Load(const FChunkId &Id, FChunkMeshData &OutMeshData)
+{
+    // Cheap early out: never touch the disk for chunks we know are not there.
+    {
+        FScopeLock Lock(&IndexLock);
+        if (!Index.Contains(Id))
+        {
+            Misses.Increment();
+            return false;
+        }
+    }
+
+    TArray<uint8> FileData;
+    bool bValid = FFileHelper::LoadFileToArray(FileData, *GetChunkPath(Id), FILEREAD_Silent);
+
+    // Header: magic, version, uncompressed size. Followed by the zlib stream.
+    uint32 Magic = 0;
+    uint32 Version = 0;
+    int32 UncompressedSize = 0;
+    FMemoryReader HeaderReader(FileData);
+    if (bValid)
+    {
+        HeaderReader << Magic << Version << UncompressedSize;
+        bValid = !HeaderReader.IsError() && Magic == BlobMagic && Version == FormatVersion && UncompressedSize > 0;
+    }
+
+    TArray<uint8> Uncompressed;
+    if (bValid)
+    {
+        const int32 HeaderSize = (int32)HeaderReader.Tell();
+        Uncompressed.SetNumUninitialized(UncompressedSize);
+        bValid = FCompression::UncompressMemory(NAME_Zlib, Uncompressed.GetData(), UncompressedSize, FileData.GetData() + HeaderSize,
+                                                FileData.Num() - HeaderSize);
+    }
+
+    if (bValid)
+    {
+        FMemoryReader BodyReader(Uncompressed);
+        SerializeMeshData(BodyReader, OutMeshData);
+        bValid = !BodyReader.IsError();
+    }
+
+    FScopeLock Lock(&IndexLock);
+    if (!bValid)
+    {
+        // Truncated or stale blob: drop it so it gets regenerated and rewritten.
+        UE_LOG(LogTemp, Warning, TEXT("FChunkDiskCache: discarding unreadable blob %s"), *GetChunkPath(Id));
+        RemoveEntry(Id);
+        OutMeshData.Empty();
+        Misses.Increment();
+        return false;
+    }
+
+    if (FCacheEntry *Entry = Index.Find(Id))
+    {
+        Entry->LastAccess = ++AccessSerial;
+    }
+    Hits.Increment();
+    return true;
+}
+
+
+void FChunkDiskCache::Store(const FChunkId &Id, const FChunkMeshData &MeshData)
+{
+    TArray<uint8> Uncompressed;
+    FMemoryWriter BodyWriter(Uncompressed);
+    SerializeMeshData(BodyWriter, const_cast<FChunkMeshData &>(MeshData));  // Saving archive, the data is only read
+
+    int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Uncompressed.Num());
+    TArray<uint8> Compressed;
+    Compressed.SetNumUninitialized(CompressedSize);
+    if (!FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Uncompressed.GetData(), Uncompressed.Num()))
+    {
+        return;
+    }
+
+    TArray<uint8> FileData;
+    FMemoryWriter FileWriter(FileData);
+    uint32 Magic = BlobMagic;
+    uint32 Version = FormatVersion;
+    int32 UncompressedSize = Uncompressed.Num();
+    FileWriter << Magic << Version << UncompressedSize;
+    FileWriter.Serialize(Compressed.GetData(), CompressedSize);
+
+    // Write next to the final file and move it in place, so a crash never leaves a half-written blob behind.
+    const FString FinalPath = GetChunkPath(Id);
+    const FString TempPath = FinalPath + TEXT(".tmp");
+    if (!FFileHelper::SaveArrayToFile(FileData, *TempPath) || !IFileManager::Get().Move(*FinalPath, *TempPath, true, true))
+    {
+        IFileManager::Get().Delete(*TempPath, false, false, true);
+        return;
+    }
+
+    FScopeLock Lock(&IndexLock);
+    FCacheEntry &Entry = Index.FindOrAdd(Id);
+    TotalSizeBytes += FileData.Num() - Entry.SizeBytes;
+    Entry.SizeBytes = FileData.Num();
+    Entry.LastAccess = ++AccessSerial;
+
+    EvictIfNeeded();
+}
+
+
+FString FChunkDiskCache::GetChunkPath(const FChunkId &Id) const
+{
+    return FPaths::Combine(Directory, FString::Printf(TEXT("F%d_L%d_%d_%d.chunk"), Id.FaceIndex, Id.LODLevel, Id.Coords.X, Id.Coords.Y));
+}
+
+
+void FChunkDiskCache::BuildIndex()
+{
+    struct FFoundBlob
+    {
+            FChunkId Id;
+            int64 SizeBytes;
+            FDateTime Timestamp;
+    };
+    TArray<FFoundBlob> Found;
+
+    IFileManager::Get().IterateDirectoryStat(*Directory,
+                                             [&Found](const TCHAR *Path, const FFileStatData &StatData)
+                                             {
+                                                 FChunkId Id;
+                                                 if (!StatData.bIsDirectory && ParseChunkFileName(FPaths::GetCleanFilename(Path), Id))
+                                                 {
+                                                     Found.Add({Id, StatData.FileSize, StatData.ModificationTime});
+                                                 }
+                                                 return true;  // Keep iterating
+                                             });
+
+    // Replay the blobs oldest first so the access serials follow the on-disk timestamps.
+    Found.Sort([](const FFoundBlob &A, const FFoundBlob &B) { return A.Timestamp < B.Timestamp; });
+
+    FScopeLock Lock(&IndexLock);
+    for (const FFoundBlob &Blob : Found)
+    {
+        FCacheEntry &Entry = Index.Add(Blob.Id);
+        Entry.SizeBytes = Blob.SizeBytes;
+        Entry.LastAccess = ++AccessSerial;
+        TotalSizeBytes += Blob.SizeBytes;
+    }
+
+    // The cap may have been lowered since the last session.
+    EvictIfNeeded();
+}
+
+
+void FChunkDiskCache::EvictIfNeeded()
+{
+    if (TotalSizeBytes <= MaxSizeBytes)
+        return;
+
+    // Evict down to 90% of the cap, so we don't pay a sort on every single store once full.
+    const int64 TargetSize = MaxSizeBytes - MaxSizeBytes / 10;
+
+    TArray<TPair<uint64, FChunkId>> ByAge;
+    ByAge.Reserve(Index.Num());
+    for (const TPair<FChunkId, FCacheEntry> &Pair : Index)
+    {
+        ByAge.Emplace(Pair.Value.LastAccess, Pair.Key);
+    }
+    ByAge.Sort([](const TPair<uint64, FChunkId> &A, const TPair<uint64, FChunkId> &B) { return A.Key < B.Key; });
+
+    for (const TPair<uint64, FChunkId> &Oldest : ByAge)
+    {
+        if (TotalSizeBytes <= TargetSize)
+            break;
+
+        RemoveEntry(Oldest.Value);
+    }
+}
+
+
+void FChunkDiskCache::RemoveEntry(const FChunkId &Id)
+{
+    FCacheEntry Entry;
+    if (Index.RemoveAndCopyValue(Id, Entry))
+    {
+        TotalSizeBytes -= Entry.SizeBytes;
+    }
+    IFileManager::Get().Delete(*GetChunkPath(Id), false, false, true);
+}
+
+
+bool FChunkDiskCache::ParseChunkFileName(const FString &FileName, FChunkId &OutId)
+{
+    // "F<Face>_L<LOD>_<X>_<Y>.chunk"
+    if (!FileName.EndsWith(TEXT(".chunk")))
+        return false;
+
+    TArray<FString> Parts;
+    FPaths::GetBaseFilename(FileName).ParseIntoArray(Parts, TEXT("_"));
+    if (Parts.Num() != 4 || !Parts[0].StartsWith(TEXT("F")) || !Parts[1].StartsWith(TEXT("L")))
+        return false;
+
+    OutId.FaceIndex = (uint8)FCString::Atoi(*Parts[0] + 1);
+    OutId.LODLevel = FCString::Atoi(*Parts[1] + 1);
+    OutId.Coords = FIntVector(FCString::Atoi(*Parts[2]), FCString::Atoi(*Parts[3]), 0);
+
+    // Hashing an id packs it into an FChunkKey, which checks its ranges: a stray file name must not get that far
+    if (OutId.FaceIndex >= 6 || OutId.LODLevel < 0 || OutId.LODLevel > FChunkKey::MaxLOD)
+        return false;
+    const int32 FaceSize = 1 << OutId.LODLevel;
+    return OutId.Coords.X >= 0 && OutId.Coords.Y >= 0 && OutId.Coords.X < FaceSize && OutId.Coords.Y < FaceSize;
+}
+
+
+void FChunkDiskCache::SerializeMeshData(FArchive &Ar, FChunkMeshData &MeshData)
+{
+    Ar << MeshData.QuantizationMin;
+    Ar << MeshData.QuantizationSize;
+    Ar << MeshData.BoundsMin;
+    Ar << MeshData.BoundsSize;
+    Ar << MeshData.Positions;
+    Ar << MeshData.SeamPositions;
+    Ar << MeshData.Triangles;
+    Ar << MeshData.Normals;
+    Ar << MeshData.Colors;
+}
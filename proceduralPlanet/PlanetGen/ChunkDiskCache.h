@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "DataTypes.h"
+
+class IPlanetNoise;
+
+
+// Persistent cache of generated chunk meshes.
+// Generation is deterministic (config + FChunkId), so a chunk generated once can be reloaded instead of recomputed.
+// One zlib-compressed FChunkMeshData blob per chunk under Saved/PlanetCache/<ConfigHash>/, capped in size (LRU eviction).
+// Thread-safe: Load() and Store() are called from the generation workers.
+class FChunkDiskCache
+{
+    public:
+        FChunkDiskCache(uint32 InConfigHash, int64 InMaxSizeBytes);
+
+        // Hash of every setting that affects the generated geometry, noise algorithm and its version included.
+        // Different configs never share blobs.
+        static uint32 ComputeConfigHash(const FPlanetConfig &Config, const DensityConfig &Density, const IPlanetNoise *Noise);
+
+        // Returns false on a miss or an unreadable blob (which is then dropped).
+        bool Load(const FChunkId &Id, FChunkMeshData &OutMeshData);
+
+        // Writes the blob and evicts the least recently used ones if the cache grew over its cap.
+        void Store(const FChunkId &Id, const FChunkMeshData &MeshData);
+
+        int32 GetHitCount() const { return Hits.GetValue(); }
+        int32 GetMissCount() const { return Misses.GetValue(); }
+
+    private:
+        // Bump whenever the blob layout or the generator output changes, so old caches are ignored.
+        static constexpr uint32 FormatVersion = 4;
+        static constexpr uint32 BlobMagic = 0x50434348;  // "PCCH"
+
+        struct FCacheEntry
+        {
+                int64 SizeBytes = 0;
+                uint64 LastAccess = 0;  // Monotonic access serial, lower = older
+        };
+
+        FString Directory;
+        int64 MaxSizeBytes;
+
+        FCriticalSection IndexLock;  // Guards everything below
+        TMap<FChunkId, FCacheEntry> Index;
+        int64 TotalSizeBytes = 0;
+        uint64 AccessSerial = 0;
+
+        FThreadSafeCounter Hits;
+        FThreadSafeCounter Misses;
+
+        FString GetChunkPath(const FChunkId &Id) const;
+
+        // Registers the blobs already on disk, oldest first.
+        void BuildIndex();
+
+        // Deletes least recently used blobs until the cache fits its cap. Caller holds IndexLock.
+        void EvictIfNeeded();
+
+        void RemoveEntry(const FChunkId &Id);
+
+        static bool ParseChunkFileName(const FString &FileName, FChunkId &OutId);
+        static void SerializeMeshData(FArchive &Ar, FChunkMeshData &MeshData);
+};
@@ -1,17 +1,77 @@
 #include "ChunkGenerator.h"
-#include "Async/Async.h"
 #include "HAL/PlatformProcess.h"
+#include "Tasks/Task.h"
 #include "MeshGenerator.h"
+#include "ChunkMeshComponent.h"
 #include "MathUtils.h"
+#include "PlanetStats.h"
+#include "Misc/ScopeExit.h"
+#include "PlanetDensityCompute.h"
+
+
+namespace
+{
+    // Inputs of the compute backend for a field started by BeginDensityField()
+    FPlanetDensityDispatch MakeDensityDispatch(const DensityGenerator &Generator, const GenData &Field)
+    {
+        const DensityConfig &Density = Generator.GetConfig();
+
+        FPlanetDensityDispatch Dispatch;
+        Dispatch.SampleCount = Field.SampleCount;
+        Dispatch.ColumnDirections.Reserve(Field.ColumnDirections.Num());
+        for (const FVector &Direction : Field.ColumnDirections)
+        {
+            Dispatch.ColumnDirections.Add(FVector3f(Direction));
+        }
+        Dispatch.AltitudeRadii.SetNumUninitialized(Field.SampleCount);
+        for (int32 z = 0; z < Field.SampleCount; z++)
+        {
+            Dispatch.AltitudeRadii[z] = Field.GetAltitudeRadius(z);
+        }
+
+        Dispatch.PlanetRadius = Density.PlanetRadius;
+        Dispatch.VoxelSize = Density.VoxelSize;
+        Dispatch.Seed = Density.Seed;
+        Dispatch.Octaves = Generator.GetNoiseProvider() ? Density.Noise.Octaves : 0;  // No provider: sphere only, like the CPU
+        Dispatch.Frequency = Density.Noise.Frequency;
+        Dispatch.Lacunarity = Density.Noise.Lacunarity;
+        Dispatch.Persistence = Density.Noise.Persistence;
+        Dispatch.Amplitude = Density.Noise.Amplitude;
+        return Dispatch;
+    }
+}
 
 
 FChunkGenerator::FChunkGenerator(const FPlanetConfig &InConfig, const DensityGenerator *InDensityGen) :
     Config(InConfig),
     DensityGen(InDensityGen)
 {
+    ConcurrencyLimit = Config.MaxConcurrentGenerations;
     bIsStopping = false;
-    AliveToken = MakeShared<bool, ESPMode::ThreadSafe>(true);
+    CompletedQueue = MakeShared<FCompletedChunkQueue, ESPMode::ThreadSafe>();
     ActiveThreadsCounter = MakeShared<FThreadSafeCounter, ESPMode::ThreadSafe>(0);
+
+    // The compute shader is a port of SimpleNoise: any other noise stays on the CPU
+    if (Config.DensityBackend == EChunkDensityBackend::GPUCompute && DensityGen)
+    {
+        const IPlanetNoise *Noise = DensityGen->GetNoiseProvider();
+        IPlanetDensityCompute *Compute = IPlanetDensityCompute::Get();
+        if (Compute && Compute->IsAvailable() && (!Noise || FCString::Strcmp(Noise->getName(), TEXT("SimpleNoise")) == 0))
+        {
+            DensityCompute = Compute;
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("GPU density backend unavailable (module not loaded, no SM5 RHI or unsupported noise): using the CPU."));
+            Config.DensityBackend = EChunkDensityBackend::CPU;  // Also keys the disk cache on the backend actually used
+        }
+    }
+
+    if (Config.bEnableDiskCache && DensityGen)
+    {
+        const uint32 ConfigHash = FChunkDiskCache::ComputeConfigHash(Config, DensityGen->GetConfig(), DensityGen->GetNoiseProvider());
+        DiskCache = MakeShared<FChunkDiskCache, ESPMode::ThreadSafe>(ConfigHash, (int64)Config.DiskCacheMaxSizeMB * 1024 * 1024);
+    }
 }
 
 FChunkGenerator::~FChunkGenerator()
@@ -24,12 +84,6 @@ FChunkGenerator::~FChunkGenerator()
                 "This is acceptable during normal shutdown but may indicate a lifecycle issue "
                 "if seen during gameplay."));
 
-    // Mark the token as false so any pending async tasks know we are dead.
-    if (AliveToken.IsValid())
-    {
-        *AliveToken = false;
-    }
-
     // Wait for background threads to finish.
     // If we destroy this object (and subsequently the APlanet's NoiseProvider),
     // any running threads accessing the noise provider will crash.
@@ -49,38 +103,117 @@ FChunkGenerator::~FChunkGenerator()
     }
 }
 
-void FChunkGenerator::RequestChunk(const FChunkId &Id, uint32 GenerationId)
+void FChunkGenerator::RequestChunk(const FChunkId &Id, uint32 GenerationId, bool bPrefetch, const FRetainedDensityPtr &ParentDensity,
+                                   const FChunkSeams &Seams)
 {
-    if (ActiveTasks.Contains(Id))
-        return;  // Already in queue
+    if (ActiveTasks.Contains(Id) && !CancelledTasks.Contains(Id))
+        return;  // Already being generated. A cancelled run can't be revived: queue a new one behind it
+
+    // Already queued: just refresh the generation ID so the result is not rejected as stale.
+    if (const int32 *Slot = RequestIndex.Find(Id))
+    {
+        RequestsQueue[*Slot].GenerationId = GenerationId;
+        RequestsQueue[*Slot].bPrefetch &= bPrefetch;  // Demand wins over prefetch
+        RequestsQueue[*Slot].Seams = Seams;
+        if (ParentDensity.IsValid())
+            RequestsQueue[*Slot].ParentDensity = ParentDensity;
+        return;
+    }
 
-    // Add the request to queue
-    RequestsQueue.Add({Id, GenerationId});
+    FChunkRequest Request;
+    Request.Id = Id;
+    Request.GenerationId = GenerationId;
+    Request.Center = FMathUtils::GetChunkCenter(Id, Config.PlanetRadius);
+    Request.EnqueueTime = FPlatformTime::Seconds();
+    Request.bPrefetch = bPrefetch;
+    Request.ParentDensity = ParentDensity;
+    Request.Seams = Seams;
+
+    // Add the request to queue. Priority is assigned on the next Update().
+    const int32 NewSlot = RequestsQueue.Add(Request);
+    RequestIndex.Add(Id, NewSlot);
 }
 
 void FChunkGenerator::Stop()
 {
     bIsStopping = true;
+
+    // In-flight work stops at its next slice, so shutdown does not wait for full chunks
+    for (const TPair<FChunkId, FGenerationCancelFlag> &Task : ActiveTasks)
+    {
+        *Task.Value = true;
+    }
+
     RequestsQueue.Empty();
+    RequestIndex.Empty();
 
     // Clear active tasks set immediately so no new tasks can be added or processed by logic relying on this set.
     ActiveTasks.Empty();
+
+    // Results already delivered to the queue are discarded, later ones by ProcessCompletedTasks()
+    CompletedQueue->Empty();
+}
+
+void FChunkGenerator::ProcessCompletedTasks()
+{
+    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetProcessCompleted);
+
+    FCompletedChunk Completed;
+    while (CompletedQueue->Dequeue(Completed))
+    {
+        // If the generator is stopping, discard the result.
+        // This prevents callbacks to a potentially destroyed ChunkManager.
+        if (bIsStopping)
+        {
+            continue;
+        }
+
+        ActiveTasks.Remove(Completed.Id);
+
+        // Check if this task was cancelled while it was running
+        if (CancelledTasks.Remove(Completed.Id) > 0)
+        {
+            CancelStats.CancelledCount++;
+            INC_DWORD_STAT(STAT_PlanetCancelledInFlight);
+            CancelStats.EarlyExitCount += Completed.MeshData ? 0 : 1;
+            CancelStats.WastedSeconds += Completed.WorkSeconds;
+            continue;  // Do not call the callback
+        }
+
+        if (OnGeneratedCallback)
+        {
+            OnGeneratedCallback(Completed.Id, Completed.GenerationId, MoveTemp(Completed.MeshData), MoveTemp(Completed.Density));
+        }
+    }
 }
 
 void FChunkGenerator::CancelRequest(const FChunkId &Id)
 {
-    // If it's in the queue, remove it. This is O(n), but the queue is not expected to be huge.
-    RequestsQueue.RemoveAll([&Id](const FChunkRequest &Request) { return Request.Id == Id; });
+    // If it's in the queue, swap-remove it and patch the index of the element that took its slot.
+    if (const int32 *SlotPtr = RequestIndex.Find(Id))
+    {
+        const int32 Slot = *SlotPtr;
+        const int32 LastSlot = RequestsQueue.Num() - 1;
+        if (Slot != LastSlot)
+        {
+            RequestsQueue[Slot] = RequestsQueue[LastSlot];
+            RequestIndex[RequestsQueue[Slot].Id] = Slot;
+        }
+        RequestsQueue.Pop(EAllowShrinking::No);
+        RequestIndex.Remove(Id);
+        INC_DWORD_STAT(STAT_PlanetCancelledQueued);
+    }
 
-    // If it's an active task, we can't stop it.
-    // Add it to a "cancelled" set. The task will complete, but we'll check this set before firing the callback.
-    if (ActiveTasks.Contains(Id))
+    // If it's an active task, raise its flag: the worker bails out at its next z-slice.
+    // It still reports back, so the ID also goes to the "cancelled" set, which is checked before firing the callback.
+    if (const FGenerationCancelFlag *Flag = ActiveTasks.Find(Id))
     {
+        **Flag = true;
         CancelledTasks.Add(Id);
     }
 }
 
-void FChunkGenerator::Update()
+void FChunkGenerator::Update(const FPlanetViewContext &Context)
 {
     // If stopping, don't start any new tasks.
     if (bIsStopping)
@@ -88,40 +221,48 @@ void FChunkGenerator::Update()
         return;
     }
 
+    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetDispatch);
+
+    // Sampled after dispatching, whichever way the update returns
+    ON_SCOPE_EXIT
+    {
+        SET_DWORD_STAT(STAT_PlanetQueuedRequests, RequestsQueue.Num());
+        SET_DWORD_STAT(STAT_PlanetTasksInFlight, ActiveTasks.Num());
+    };
+
     // Prune any cancelled IDs that are no longer active.
     // This handles the case where a task was cancelled and the chunk was destroyed before the async callback ever fired — meaning the callback never will,
     // and the ID would otherwise leak in CancelledTasks indefinitely.
-    if (CancelledTasks.Num() > 0)
+    for (auto It = CancelledTasks.CreateIterator(); It; ++It)
     {
-        TArray<FChunkId> StaleCancellations;
-        for (const FChunkId &Id : CancelledTasks)
+        if (!ActiveTasks.Contains(*It))
         {
-            if (!ActiveTasks.Contains(Id))
-            {
-                StaleCancellations.Add(Id);
-            }
-        }
-        for (const FChunkId &Id : StaleCancellations)
-        {
-            CancelledTasks.Remove(Id);
+            It.RemoveCurrent();
         }
     }
 
     // Check limits
-    if (ActiveTasks.Num() >= Config.MaxConcurrentGenerations)
+    if (ActiveTasks.Num() >= ConcurrencyLimit || RequestsQueue.Num() == 0)
         return;
 
+    // The observer moves every frame, so priorities are recomputed before anything is dispatched.
+    RefreshPriorities(Context.ObserverLocation);
+
+    // Max-heap on Priority: the most urgent request sits at index 0.
+    const auto ByPriority = [](const FChunkRequest &A, const FChunkRequest &B) { return A.Priority > B.Priority; };
+    RequestsQueue.Heapify(ByPriority);
+
     int32 StartedThisTick = 0;
 
     // Process Queue
     while (RequestsQueue.Num() > 0 && StartedThisTick < Config.ChunkGenerationRate)
     {
-        if (ActiveTasks.Num() >= Config.MaxConcurrentGenerations)
+        if (ActiveTasks.Num() >= ConcurrencyLimit)
             break;
 
-        // Pop from front (index 0) for FIFO ordering — oldest request processed first.
-        FChunkRequest Request = RequestsQueue[0];
-        RequestsQueue.RemoveAt(0, 1, false);  // false = don't shrink allocation each removal
+        FChunkRequest Request;
+        RequestsQueue.HeapPop(Request, ByPriority, EAllowShrinking::No);
+        RequestIndex.Remove(Request.Id);
 
         // If not already active (double check)
         if (!ActiveTasks.Contains(Request.Id))
@@ -129,16 +270,79 @@ void FChunkGenerator::Update()
             StartAsyncTask(Request);
             StartedThisTick++;
         }
+        else
+        {
+            BlockedRequests.Add(Request);  // Its cancelled predecessor is still draining, retried on a later tick
+        }
+    }
+
+    RequestsQueue.Append(BlockedRequests);
+    BlockedRequests.Reset();
+
+    // Heap operations moved elements around, slots must be re-synced.
+    RebuildRequestIndex();
+}
+
+void FChunkGenerator::RefreshPriorities(const FVector &ObserverLocation)
+{
+    // Screen-space error proxy: projected size of the chunk, i.e. its arc length over its distance to the observer.
+    // Near, coarse chunks (the ones under the camera waiting to split) come first; far, fine chunks come last.
+    const float RootNodeSize = Config.PlanetRadius * PI * 0.5f;
+
+    for (FChunkRequest &Request : RequestsQueue)
+    {
+        const float NodeSize = RootNodeSize / (float)(1 << Request.Id.LODLevel);
+        const float Dist = FMath::Max(FVector::Dist(Request.Center, ObserverLocation), 1.0f);
+        Request.Priority = NodeSize / Dist * (Request.bPrefetch ? FPlanetStatics::PrefetchPriorityScale : 1.0f);
     }
 }
 
+void FChunkGenerator::RebuildRequestIndex()
+{
+    RequestIndex.Reset();
+    for (int32 Slot = 0; Slot < RequestsQueue.Num(); ++Slot)
+    {
+        RequestIndex.Add(RequestsQueue[Slot].Id, Slot);
+    }
+}
+
+void FChunkGenerator::GetQueueStats(TArray<FGenerationQueueStats> &OutStats) const
+{
+    const double Now = FPlatformTime::Seconds();
+
+    for (const FChunkRequest &Request : RequestsQueue)
+    {
+        if (!OutStats.IsValidIndex(Request.Id.LODLevel))
+            continue;
+
+        FGenerationQueueStats &Stats = OutStats[Request.Id.LODLevel];
+        const float Wait = (float)(Now - Request.EnqueueTime);
+        Stats.AvgWaitSeconds += Wait;  // Accumulated here, divided below
+        Stats.MaxWaitSeconds = FMath::Max(Stats.MaxWaitSeconds, Wait);
+        Stats.QueuedCount++;
+    }
+
+    for (FGenerationQueueStats &Stats : OutStats)
+    {
+        if (Stats.QueuedCount > 0)
+            Stats.AvgWaitSeconds /= Stats.QueuedCount;
+    }
+}
+
+void FChunkGenerator::GetDiskCacheStats(int32 &OutHits, int32 &OutMisses) const
+{
+    OutHits = DiskCache.IsValid() ? DiskCache->GetHitCount() : 0;
+    OutMisses = DiskCache.IsValid() ? DiskCache->GetMissCount() : 0;
+}
+
 void FChunkGenerator::SetOnChunkGeneratedCallback(FOnChunkGenerated InCallback) { OnGeneratedCallback = InCallback; }
 
 int32 FChunkGenerator::GetPendingCount() const { return RequestsQueue.Num() + ActiveTasks.Num(); }
 
 void FChunkGenerator::StartAsyncTask(const FChunkRequest &Request)
 {
-    ActiveTasks.Add(Request.Id);
+    FGenerationCancelFlag CancelFlag = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>(false);
+    ActiveTasks.Add(Request.Id, CancelFlag);
 
     // Capture data by value for thread safety
     FChunkId Id = Request.Id;
@@ -165,16 +369,31 @@ void FChunkGenerator::StartAsyncTask(const FChunkRequest &Request)
     FVector FaceRight = FMathUtils::getFaceRight(FaceIdx);
     FVector FaceUp = FMathUtils::getFaceUp(FaceIdx);
 
-    // Capture the lifecycle token. This shared pointer keeps the bool alive
-    // even if 'this' generator is destroyed.
-    TSharedPtr<bool, ESPMode::ThreadSafe> Token = AliveToken;
+    // The worker never touches 'this': its result goes through the shared queue
+    TSharedPtr<FCompletedChunkQueue, ESPMode::ThreadSafe> Queue = CompletedQueue;
+
+    // The cache outlives the generator if a worker still holds it
+    TSharedPtr<FChunkDiskCache, ESPMode::ThreadSafe> Cache = DiskCache;
+
+    const bool bPackForGPU = Config.RenderBackend == EChunkRenderBackend::PackedVertexFactory;
+    IPlanetDensityCompute *Compute = DensityCompute;
+
+    // Finest chunks never split: nothing would ever read their samples
+    const bool bRetainDensity = Config.bReuseParentDensity && LODLevel < Config.MaxLOD;
+    FRetainedDensityPtr ParentDensity = Config.bReuseParentDensity ? Request.ParentDensity : nullptr;
+    const FIntPoint ParentOffset((Id.Coords.X & 1) * (Resolution / 2), (Id.Coords.Y & 1) * (Resolution / 2));
+
+    // Blobs are keyed by chunk only: stitched meshes depend on the neighbours and bypass the disk cache
+    const FChunkSeams Seams = Request.Seams;
+    if (!Seams.IsEmpty())
+        Cache.Reset();
 
     // Capture the thread counter to keep it alive and modify it safely
     ActiveThreadsCounter->Increment();
     TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> CounterRef = ActiveThreadsCounter;
 
     // RAII Guard: Ensure the counter is decremented when the lambda is destroyed,
-    // whether the task finished naturally or was aborted/destroyed by the thread pool on exit.
+    // whether the task finished naturally or was discarded by the scheduler on exit.
     TSharedPtr<void, ESPMode::ThreadSafe> ThreadGuard((void *)nullptr,
                                                       [CounterRef](void *)
                                                       {
@@ -184,48 +403,127 @@ void FChunkGenerator::StartAsyncTask(const FChunkRequest &Request)
                                                           }
                                                       });
 
-    // Launch Async
-    Async(EAsyncExecution::ThreadPool,
-          [this, Id, GenId, Resolution, FaceNormal, FaceRight, FaceUp, CubeMin, CubeMax, Transform, LODLevel, ThreadGen, Token, ThreadGuard]()
-          {
-              // A. Generate Density
-              GenData GeneratedData = ThreadGen.GenerateDensityField(Resolution, FaceNormal, FaceRight, FaceUp, CubeMin, CubeMax);
+    // Launch on the task system. Its work-stealing workers also run the density slabs spawned below,
+    // so a large near-camera chunk spreads over every idle core instead of one pool thread.
+    UE::Tasks::Launch(
+        UE_SOURCE_LOCATION,
+        [Id, GenId, Resolution, FaceNormal, FaceRight, FaceUp, CubeMin, CubeMax, Transform, LODLevel, ThreadGen, Queue, ThreadGuard, Cache, bPackForGPU,
+         CancelFlag, bRetainDensity, ParentDensity, ParentOffset, Seams, Compute]()
+        {
+            PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetGenerateChunk);
 
-              // B. Generate Mesh
-              FChunkMeshData MeshData = MeshGenerator::GenerateMesh(GeneratedData, Resolution, Transform, FTransform::Identity, LODLevel, ThreadGen);
+            const double StartTime = FPlatformTime::Seconds();
+            const FThreadSafeBool *Cancelled = CancelFlag.Get();
+            double WaitSeconds = 0.0;  // Spent blocked on slabs, not working
+            double SlabSeconds = 0.0;  // Spent in slabs on other workers
 
-              // C. Return to Game Thread
-              AsyncTask(ENamedThreads::GameThread,
-                        [this, Id, GenId, MeshData, Token]() mutable
+            // Known chunk: the blob read replaces the whole generation
+            FChunkMeshData MeshData;
+            FRetainedDensityPtr Density;
+            if (!*Cancelled && (!Cache.IsValid() || !Cache->Load(Id, MeshData)))
+            {
+                // A. Density, one sub-task per z-slab. The slabs write disjoint slices of the same field.
+                // Samples shared with the parent are copied from its retained field.
+                // On the GPU backend the whole field is one compute dispatch instead, and the slabs only run if it failed.
+                GenData GeneratedData = ThreadGen.BeginDensityField(Resolution, FaceNormal, FaceRight, FaceUp, CubeMin, CubeMax);
+
+                const int32 SampleCount = GeneratedData.SampleCount;
+                bool bDensityOnGPU = false;
+                if (Compute)
+                {
+                    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetDensityCompute);
+                    const double ComputeStart = FPlatformTime::Seconds();
+                    bDensityOnGPU = Compute->ComputeDensities(MakeDensityDispatch(ThreadGen, GeneratedData), GeneratedData.Densities.GetData(), Cancelled,
+                                                              FPlanetStatics::GPUDensityTimeoutSeconds);
+                    WaitSeconds += FPlatformTime::Seconds() - ComputeStart;  // The worker only waited on the GPU
+                }
+
+                const int32 SlabThickness = FPlanetStatics::DensitySlabThickness;
+                const int32 NumSlabs = bDensityOnGPU ? 0 : FMath::DivideAndRoundUp(SampleCount, SlabThickness);
+                TArray<UE::Tasks::FTask, TInlineAllocator<16>> Slabs;
+                TArray<double, TInlineAllocator<16>> SlabTimes;
+                SlabTimes.SetNumZeroed(NumSlabs);
+                for (int32 Slab = 0; Slab < NumSlabs; Slab++)
+                {
+                    const int32 FirstSlice = Slab * SlabThickness;
+                    const int32 EndSlice = FMath::Min(FirstSlice + SlabThickness, SampleCount);
+                    double *SlabTime = &SlabTimes[Slab];
+                    Slabs.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION,
+                                                [&ThreadGen, &GeneratedData, &ParentDensity, &ParentOffset, FirstSlice, EndSlice, Cancelled, SlabTime]()
+                                                {
+                                                    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetDensitySlab);
+                                                    const double SlabStart = FPlatformTime::Seconds();
+                                                    ThreadGen.GenerateDensitySlab(GeneratedData, FirstSlice, EndSlice, Cancelled, ParentDensity.Get(),
+                                                                                  ParentOffset);
+                                                    *SlabTime = FPlatformTime::Seconds() - SlabStart;
+                                                }));
+                }
+
+                // Waiting on a slab nobody has picked up yet runs it on this thread.
+                // Its time then shows up both as slab and as wait time, which cancel out.
+                int32 ReadySlabs = 0;
+                auto WaitForSlabs = [&Slabs, &ReadySlabs, &WaitSeconds](int32 EndSlab)
+                {
+                    const double WaitStart = FPlatformTime::Seconds();
+                    while (ReadySlabs < FMath::Min(EndSlab, Slabs.Num()))
+                    {
+                        Slabs[ReadySlabs++].Wait();
+                    }
+                    WaitSeconds += FPlatformTime::Seconds() - WaitStart;
+                };
+
+                // B. Generate Mesh, marching right behind the density front: only the slabs the next layer reads are waited for.
+                // Slabs run inline while waiting show up nested in the mesh scope.
+                {
+                    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetMesh);
+                    MeshData = MeshGenerator::GenerateMesh(
+                        GeneratedData, Resolution, Transform, FTransform::Identity, LODLevel, ThreadGen,
+                        [&WaitForSlabs, &ReadySlabs, SlabThickness](int32 Slice)
                         {
-                            // Safety Check: Is the generator still alive?
-                            // If *Token is false, the generator destructor has already run.
-                            // accessing 'this' (e.g. bIsStopping) would crash.
-                            if (!Token.IsValid() || !(*Token))
-                            {
-                                return;
-                            }
-
-                            // If the generator is stopping, discard the result immediately.
-                            // This prevents callbacks to a potentially destroyed ChunkManager.
-                            if (bIsStopping)
-                            {
-                                return;
-                            }
-
-                            ActiveTasks.Remove(Id);
-
-                            // Check if this task was cancelled while it was running
-                            if (CancelledTasks.Contains(Id))
-                            {
-                                CancelledTasks.Remove(Id);  // Clean up the cancellation request
-                                return;                     // Do not call the callback
-                            }
-
-                            if (OnGeneratedCallback)
-                            {
-                                OnGeneratedCallback(Id, GenId, MakeUnique<FChunkMeshData>(MoveTemp(MeshData)));
-                            }
-                        });
-          });
-}
\ No newline at end of file
+                            if (ReadySlabs <= Slice / SlabThickness)
+                                WaitForSlabs(Slice / SlabThickness + 1);
+                        },
+                        Cancelled, Seams);
+                }
+
+                // The slabs reference this frame's locals
+                WaitForSlabs(NumSlabs);
+                for (double SlabTime : SlabTimes)
+                {
+                    SlabSeconds += SlabTime;
+                }
+
+                // A cancelled field or mesh is incomplete: never cache it
+                if (Cache.IsValid() && !*Cancelled)
+                {
+                    Cache->Store(Id, MeshData);
+                }
+
+                if (bRetainDensity && !*Cancelled)
+                {
+                    Density = ThreadGen.RetainDensity(GeneratedData);
+                }
+            }
+
+            FCompletedChunk Completed;
+            Completed.Id = Id;
+            Completed.GenerationId = GenId;
+
+            if (!*Cancelled)
+            {
+                // C. Pack the GPU buffers here, so the game thread upload is only a pointer hand-off
+                if (bPackForGPU)
+                {
+                    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetPackMesh);
+                    MeshData.Packed = FChunkPackedMesh::Build(MeshData);
+                }
+                Completed.MeshData = MakeUnique<FChunkMeshData>(MoveTemp(MeshData));
+                Completed.Density = MoveTemp(Density);
+            }
+
+            Completed.WorkSeconds = FPlatformTime::Seconds() - StartTime - WaitSeconds + SlabSeconds;
+
+            // D. Hand the result over. The game thread picks the whole batch up in ProcessCompletedTasks()
+            Queue->Enqueue(MoveTemp(Completed));
+        });
+}
@@ -1,19 +1,62 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Queue.h"
 #include "HAL/ThreadSafeBool.h"
 #include "HAL/ThreadSafeCounter.h"
 #include "DataTypes.h"
 #include "DensityGenerator.h"
+#include "ChunkDiskCache.h"
 
+class IPlanetDensityCompute;
 
-// Callback signature: ChunkId, GenerationId (for validation), MeshData
-using FOnChunkGenerated = TFunction<void(const FChunkId &, uint32, TUniquePtr<FChunkMeshData>)>;
+// Callback signature: ChunkId, GenerationId (for validation), MeshData, retained density samples (may be null)
+using FOnChunkGenerated = TFunction<void(const FChunkId &, uint32, TUniquePtr<FChunkMeshData>, FRetainedDensityPtr)>;
 
 struct FChunkRequest
 {
         FChunkId Id;
         uint32 GenerationId;
+        FVector Center = FVector::ZeroVector;  // Planet-space chunk center, cached once so re-prioritizing stays cheap
+        double EnqueueTime = 0.0;              // FPlatformTime::Seconds() at the time the request was queued
+        float Priority = 0.f;                  // Higher is more urgent. Refreshed every Update()
+        bool bPrefetch = false;                // Speculative request from the look-ahead pass, scheduled after demanded chunks
+        FRetainedDensityPtr ParentDensity;     // Parent samples to seed the field with, if the parent retained them
+        FChunkSeams Seams;                     // Edges to stitch to a coarser neighbour
+};
+
+
+// Finished generation result, handed from the workers to the game thread.
+struct FCompletedChunk
+{
+        FChunkId Id;
+        uint32 GenerationId = 0;
+        TUniquePtr<FChunkMeshData> MeshData;  // Null if the task noticed its cancellation and exited early
+        FRetainedDensityPtr Density;          // Samples kept for the children of a future split, null if not retained
+        double WorkSeconds = 0.0;             // Worker CPU time spent on the task, slab sub-tasks included
+};
+
+using FCompletedChunkQueue = TQueue<FCompletedChunk, EQueueMode::Mpsc>;
+
+// Raised on the game thread to make an in-flight task stop at its next z-slice.
+using FGenerationCancelFlag = TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe>;
+
+
+// Cost of cancelled generation work since startup (used by the debug HUD).
+struct FGenerationCancelStats
+{
+        int32 CancelledCount = 0;    // In-flight tasks whose result was discarded
+        int32 EarlyExitCount = 0;    // Of these, the ones that stopped before finishing
+        double WastedSeconds = 0.0;  // Worker CPU time spent on discarded results
+};
+
+
+// Per-LOD snapshot of the generation queue (used by the debug HUD).
+struct FGenerationQueueStats
+{
+        int32 QueuedCount = 0;
+        float MaxWaitSeconds = 0.f;
+        float AvgWaitSeconds = 0.f;
 };
 
 class FChunkGenerator
@@ -22,20 +65,45 @@ class FChunkGenerator
         FChunkGenerator(const FPlanetConfig &InConfig, const DensityGenerator *InDensityGen);
         ~FChunkGenerator();
 
-        // Adds a chunk to the generation queue
-        void RequestChunk(const FChunkId &Id, uint32 GenerationId);
+        // Adds a chunk to the generation queue.
+        // Prefetch requests run at reduced priority; requesting an already queued prefetch normally promotes it.
+        // ParentDensity, if given, seeds the samples the chunk shares with its parent. Seams are the edges to stitch.
+        void RequestChunk(const FChunkId &Id, uint32 GenerationId, bool bPrefetch = false, const FRetainedDensityPtr &ParentDensity = nullptr,
+                          const FChunkSeams &Seams = FChunkSeams());
 
-        // Cancels a pending or active generation request
+        // Cancels a pending or active generation request. Queued requests are dropped in O(1),
+        // active ones are told to stop at their next z-slice and their result is discarded.
         void CancelRequest(const FChunkId &Id);
 
-        // Main update loop to process queue and dispatch threads
-        void Update();
+        // Delivers every result finished since the last call, in one batch through the generated callback. Game thread.
+        void ProcessCompletedTasks();
+
+        // Main update loop. Re-prioritizes the queue against the observer and dispatches the most urgent requests.
+        void Update(const FPlanetViewContext &Context);
 
         // Set the callback for when a chunk finishes
         void SetOnChunkGeneratedCallback(FOnChunkGenerated InCallback);
 
         int32 GetPendingCount() const;
 
+        // Tasks allowed in flight at once, at most Config.MaxConcurrentGenerations. Lowering it never cancels running tasks,
+        // dispatch just waits until enough of them finished. Takes effect on the next Update().
+        void SetConcurrencyLimit(int32 Limit) { ConcurrencyLimit = FMath::Clamp(Limit, 0, Config.MaxConcurrentGenerations); }
+        int32 GetConcurrencyLimit() const { return ConcurrencyLimit; }
+
+        int32 GetActiveTaskCount() const { return ActiveTasks.Num(); }
+
+        // True if a worker is currently generating this chunk.
+        bool IsTaskActive(const FChunkId &Id) const { return ActiveTasks.Contains(Id); }
+
+        // Per-LOD queue depth and wait times. Array must be pre-sized to MaxLOD+1.
+        void GetQueueStats(TArray<FGenerationQueueStats> &OutStats) const;
+
+        // Disk cache hit/miss counters since startup. Both 0 if the cache is disabled.
+        void GetDiskCacheStats(int32 &OutHits, int32 &OutMisses) const;
+
+        const FGenerationCancelStats &GetCancelStats() const { return CancelStats; }
+
         // Stops the generator, preventing new tasks and discarding results from in-flight tasks.
         void Stop();
 
@@ -43,22 +111,40 @@ class FChunkGenerator
         FPlanetConfig Config;
         const DensityGenerator *DensityGen;  // Owned by Planet/Manager, we just hold ref
 
-        TArray<FChunkRequest> RequestsQueue;
-        TSet<FChunkId> ActiveTasks;     // Set of IDs currently processing to prevent duplicates
-        TSet<FChunkId> CancelledTasks;  // Set of IDs that were cancelled while active
+        // GPU density backend, null on the CPU backend or if the compute module is unavailable
+        IPlanetDensityCompute *DensityCompute = nullptr;
+
+        TArray<FChunkRequest> RequestsQueue;  // Unordered between ticks, heap-ordered by Priority during Update()
+        TMap<FChunkId, int32> RequestIndex;   // ID -> slot in RequestsQueue, for O(1) lookup and cancellation
+        TMap<FChunkId, FGenerationCancelFlag> ActiveTasks;  // IDs currently processing (prevents duplicates) -> their cancellation flag
+        TSet<FChunkId> CancelledTasks;                      // Set of IDs that were cancelled while active
+        TArray<FChunkRequest> BlockedRequests;              // Dispatch scratch: re-requests waiting for their cancelled run to drain
+
+        FGenerationCancelStats CancelStats;
+
+        int32 ConcurrencyLimit = 0;
 
         FOnChunkGenerated OnGeneratedCallback;
 
+        // Optional persistent cache, shared with the workers (null if disabled).
+        TSharedPtr<FChunkDiskCache, ESPMode::ThreadSafe> DiskCache;
+
         // Flag to signal that the generator is shutting down.
         FThreadSafeBool bIsStopping;
 
-        // Token to track the lifecycle of this instance safely across threads.
-        // The bool value is true while the generator is alive, and set to false in the destructor.
-        TSharedPtr<bool, ESPMode::ThreadSafe> AliveToken;
+        // Workers push their results here instead of scheduling one game thread task each.
+        // Shared so a worker finishing after the generator is gone still has a valid queue to push to.
+        TSharedPtr<FCompletedChunkQueue, ESPMode::ThreadSafe> CompletedQueue;
 
         // Shared counter to track how many background threads are currently running.
         // We use this to force the destructor to wait until all workers are done.
         TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> ActiveThreadsCounter;
 
         void StartAsyncTask(const FChunkRequest &Request);
+
+        // Recomputes every queued request's priority for the current observer position.
+        void RefreshPriorities(const FVector &ObserverLocation);
+
+        // Rebuilds RequestIndex after the queue has been reordered.
+        void RebuildRequestIndex();
 };
\ No newline at end of file
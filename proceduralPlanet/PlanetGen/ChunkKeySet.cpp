@@ -0,0 +1,65 @@
+#include "ChunkKeySet.h"
+
+
+bool FChunkKeySet::Add(const FChunkId &Id)
+{
+    // Grow before inserting, so the table never gets more than half full
+    if ((Ids.Num() + 1) * 2 > Slots.Num())
+        Rehash(FMath::Max(Slots.Num() * 2, MinSlots));
+
+    const uint64 Key = Id.GetKey().Value;
+    const int32 Slot = FindSlot(Key);
+    if (Slots[Slot] == Key)
+        return false;
+
+    Slots[Slot] = Key;
+    Ids.Add(Id);
+    return true;
+}
+
+
+bool FChunkKeySet::Contains(const FChunkId &Id) const
+{
+    if (Ids.Num() == 0)
+        return false;
+
+    const uint64 Key = Id.GetKey().Value;
+    return Slots[FindSlot(Key)] == Key;
+}
+
+
+void FChunkKeySet::Reset()
+{
+    if (Ids.Num() == 0)
+        return;
+
+    Ids.Reset();
+    FMemory::Memset(Slots.GetData(), 0xFF, Slots.Num() * sizeof(uint64));
+}
+
+
+void FChunkKeySet::Rehash(int32 NumSlots)
+{
+    check(FMath::IsPowerOfTwo(NumSlots));
+
+    Slots.SetNumUninitialized(NumSlots, EAllowShrinking::No);
+    FMemory::Memset(Slots.GetData(), 0xFF, Slots.Num() * sizeof(uint64));
+
+    for (const FChunkId &Id : Ids)
+    {
+        const uint64 Key = Id.GetKey().Value;
+        Slots[FindSlot(Key)] = Key;
+    }
+}
+
+
+int32 FChunkKeySet::FindSlot(uint64 Key) const
+{
+    const int32 Mask = Slots.Num() - 1;
+    int32 Slot = (int32)(HashKey(Key) & Mask);
+
+    while (Slots[Slot] != Key && Slots[Slot] != EmptySlot)
+        Slot = (Slot + 1) & Mask;
+
+    return Slot;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DataTypes.h"
+
+
+// Flat open-addressing set of chunk IDs, for the sets rebuilt every frame (LoadSet, PrefetchSet).
+// Linear probing over a power-of-two table of packed keys, plus the IDs in insertion order for iteration.
+// Reset() keeps all memory: rebuilding the set every frame stops allocating once it reached its working size.
+class FChunkKeySet
+{
+    public:
+        // Returns false if the ID was already in the set.
+        bool Add(const FChunkId &Id);
+        bool Contains(const FChunkId &Id) const;
+
+        // Empties the set, keeping its memory.
+        void Reset();
+
+        int32 Num() const { return Ids.Num(); }
+        SIZE_T GetAllocatedSize() const { return Slots.GetAllocatedSize() + Ids.GetAllocatedSize(); }
+
+        // Removes every ID matching the predicate. Keeps the insertion order of the others.
+        template <typename PredicateType>
+        void RemoveAll(PredicateType Predicate)
+        {
+            if (Ids.RemoveAll(Predicate) > 0)
+                Rehash(Slots.Num());
+        }
+
+        // Iteration in insertion order
+        TArray<FChunkId>::RangedForConstIteratorType begin() const { return Ids.begin(); }
+        TArray<FChunkId>::RangedForConstIteratorType end() const { return Ids.end(); }
+
+    private:
+        static constexpr uint64 EmptySlot = ~0ull;  // Face 7, never a valid key
+        static constexpr int32 MinSlots = 64;
+
+        TArray<uint64> Slots;  // Packed keys, EmptySlot when free. Kept at most half full.
+        TArray<FChunkId> Ids;
+
+        void Rehash(int32 NumSlots);
+
+        // Slot holding Key, or the empty slot where it would go
+        int32 FindSlot(uint64 Key) const;
+
+        // 64-bit finalizer (MurmurHash3): spreads the Morton bits over the whole table
+        static uint64 HashKey(uint64 Key)
+        {
+            Key ^= Key >> 33;
+            Key *= 0xff51afd7ed558ccdull;
+            Key ^= Key >> 33;
+            Key *= 0xc4ceb9fe1a85ec53ull;
+            Key ^= Key >> 33;
+            return Key;
+        }
+};
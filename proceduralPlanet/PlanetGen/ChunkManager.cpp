@@ -1,11 +1,15 @@
 #include "ChunkManager.h"
 #include "DrawDebugHelpers.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "PlanetStats.h"
 
 
 FChunkManager::FChunkManager(const FPlanetConfig &planetConfig, const DensityGenerator *densityGen) :
     Config(planetConfig),
     Generator(densityGen)
 {
+    StateCountPerLOD.Init(0, (Config.MaxLOD + 1) * NumChunkStates);
+
     // DEBUG LOG
     UE_LOG(LogTemp, Warning, TEXT("FChunkManager created."));
     UE_LOG(LogTemp, Warning, TEXT("Collision is globally %s"), Config.bEnableCollision ? TEXT("enabled") : TEXT("disabled"));
@@ -21,6 +25,9 @@ FChunkManager::~FChunkManager()
         ChunkGenerator->Stop();
     }
 
+    // Collision components go first, while the owner is still valid
+    Collision.Reset();
+
     DeferredReleaseQueue.Empty();
 
     // Systematically clean up active chunks.
@@ -30,7 +37,7 @@ FChunkManager::~FChunkManager()
         {
             FChunk *Chunk = Pair.Value.Get();
 
-            if (UProceduralMeshComponent *Comp = Chunk->RenderProxy.Get())
+            if (UMeshComponent *Comp = Chunk->RenderProxy.Get())
             {
                 // Hand the component back to the renderer for immediate safe disposal.
                 // We do NOT use ReleaseChunk (which pools it) because we are shutting down.
@@ -48,47 +55,84 @@ FChunkManager::~FChunkManager()
 int32 FChunkManager::GetTotalChunkCount() const { return ChunkMap.Num(); }
 
 
-int32 FChunkManager::GetVisibleChunkCount() const
-{
-    int32 Count = 0;
-    for (const auto &Pair : ChunkMap)
-    {
-        if (Pair.Value->State == EChunkState::Visible)
-            Count++;
-    }
+int32 FChunkManager::GetVisibleChunkCount() const { return GetChunkCount(EChunkState::Visible); }
 
-    return Count;
+
+void FChunkManager::GetVisibleCountPerLOD(TArray<int32> &OutCounts) const
+{
+    for (int32 LOD = 0; LOD < OutCounts.Num(); LOD++)
+        OutCounts[LOD] += GetChunkCount(EChunkState::Visible, LOD);
 }
 
 
-void FChunkManager::GetVisibleCountPerLOD(TArray<int32> &OutCounts) const
+int32 FChunkManager::GetChunkCount(EChunkState State, int32 LODLevel) const
 {
-    for (const auto &Pair : ChunkMap)
-    {
-        const FChunk *Chunk = Pair.Value.Get();
-        if (Chunk->State == EChunkState::Visible)
-        {
-            const int32 LOD = Chunk->Id.LODLevel;
-            if (OutCounts.IsValidIndex(LOD))
-                OutCounts[LOD]++;
-        }
-    }
+    const int32 Index = LODLevel * NumChunkStates + (int32)State;
+    return StateCountPerLOD.IsValidIndex(Index) ? StateCountPerLOD[Index] : 0;
 }
 
 
 int32 FChunkManager::GetPendingCount() const { return ChunkGenerator ? ChunkGenerator->GetPendingCount() : 0; }
 
 
+void FChunkManager::SetGenerationBudget(int32 Budget)
+{
+    if (ChunkGenerator)
+        ChunkGenerator->SetConcurrencyLimit(Budget);
+}
+
+
+int32 FChunkManager::GetGenerationBudget() const { return ChunkGenerator ? ChunkGenerator->GetConcurrencyLimit() : 0; }
+
+
+int32 FChunkManager::GetActiveGenerationCount() const { return ChunkGenerator ? ChunkGenerator->GetActiveTaskCount() : 0; }
+
+
+bool FChunkManager::IsInGenerationRange(const FVector &ObserverLocation) const
+{
+    const float DistToSurface = ObserverLocation.Size() - Config.PlanetRadius;
+    return DistToSurface < (Config.FarDistanceThreshold * FPlanetStatics::FarDistanceSafetyMargin);
+}
+
+
+void FChunkManager::GetGenerationQueueStats(TArray<FGenerationQueueStats> &OutStats) const
+{
+    if (ChunkGenerator)
+        ChunkGenerator->GetQueueStats(OutStats);
+}
+
+
+void FChunkManager::GetDiskCacheStats(int32 &OutHits, int32 &OutMisses) const
+{
+    OutHits = 0;
+    OutMisses = 0;
+    if (ChunkGenerator)
+        ChunkGenerator->GetDiskCacheStats(OutHits, OutMisses);
+}
+
+
+FGenerationCancelStats FChunkManager::GetGenerationCancelStats() const
+{
+    return ChunkGenerator ? ChunkGenerator->GetCancelStats() : FGenerationCancelStats();
+}
+
+
 void FChunkManager::Initialize(AActor *Owner, UMaterialInterface *Material)
 {
-    Renderer = MakeUnique<ChunkRenderer>(Owner, Material);
+    Renderer = MakeUnique<ChunkRenderer>(Owner, Material, Config.RenderBackend, Config.bCastShadows);
 
     ChunkGenerator = MakeUnique<FChunkGenerator>(Config, Generator);
-    ChunkGenerator->SetOnChunkGeneratedCallback([this](const FChunkId &Id, uint32 GenId, TUniquePtr<FChunkMeshData> MeshData)
-                                                { OnGenerationComplete(Id, GenId, MoveTemp(MeshData)); });
+    ChunkGenerator->SetOnChunkGeneratedCallback([this](const FChunkId &Id, uint32 GenId, TUniquePtr<FChunkMeshData> MeshData, FRetainedDensityPtr Density)
+                                                { OnGenerationComplete(Id, GenId, MoveTemp(MeshData), MoveTemp(Density)); });
 
     Quadtree = MakeUnique<FPlanetQuadtree>(Config);
 
+    if (Config.MeshCacheBudgetMB > 0)
+        MeshCache = MakeUnique<FChunkMeshCache>((int64)Config.MeshCacheBudgetMB * 1024 * 1024);
+
+    if (Config.bEnableCollision)
+        Collision = MakeUnique<FChunkCollisionManager>(Owner, Config);
+
     InitializeRoots();
 
     // DEBUG LOG
@@ -104,10 +148,52 @@ FChunk *FChunkManager::CreateChunk(const FChunkId &Id)
     TUniquePtr<FChunk> NewChunk = MakeUnique<FChunk>(Id);
     FChunk *Ptr = NewChunk.Get();
     ChunkMap.Add(Id, MoveTemp(NewChunk));
+
+    ChunksByState[(int32)Ptr->State].AddTail(Ptr);
+    AdjustStateCount(Ptr, 1);
+    NeededOrder.AddTail(Ptr);
     return Ptr;
 }
 
 
+void FChunkManager::SetChunkState(FChunk *Chunk, EChunkState NewState)
+{
+    if (Chunk->State == NewState)
+        return;
+
+    if (NewState == EChunkState::Visible && Chunk->DemandTime > 0.0)
+    {
+        const double Latency = FPlatformTime::Seconds() - Chunk->DemandTime;
+        Chunk->DemandTime = 0.0;
+        FrameMaxLatencyMs = FMath::Max(FrameMaxLatencyMs, (float)(Latency * 1000.0));
+        RecordPlanetLatencyStat(Latency);
+    }
+
+    ChunksByState[(int32)Chunk->State].Remove(Chunk);
+    AdjustStateCount(Chunk, -1);
+
+    Chunk->State = NewState;
+
+    ChunksByState[(int32)NewState].AddTail(Chunk);
+    AdjustStateCount(Chunk, 1);
+}
+
+
+void FChunkManager::AdjustStateCount(const FChunk *Chunk, int32 Delta)
+{
+    const int32 Index = Chunk->Id.LODLevel * NumChunkStates + (int32)Chunk->State;
+    if (StateCountPerLOD.IsValidIndex(Index))
+        StateCountPerLOD[Index] += Delta;
+}
+
+
+void FChunkManager::MarkNeeded(FChunk *Chunk)
+{
+    Chunk->LastNeededFrame = UpdateFrame;
+    NeededOrder.MoveToTail(Chunk);
+}
+
+
 FChunk *FChunkManager::GetChunk(const FChunkId &Id)
 {
     // If it exists, return it
@@ -132,29 +218,100 @@ bool FChunkManager::IsChunkReady(const FChunkId &Id) const
 
 void FChunkManager::Update(const FPlanetViewContext &Context)
 {
-    const float DistToSurface = Context.ObserverLocation.Size() - Config.PlanetRadius;
-    const bool bShouldGenerateChunks = DistToSurface < (Config.FarDistanceThreshold * FPlanetStatics::FarDistanceSafetyMargin);
+    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetManagerUpdate);
+    LLM_SCOPE_BYNAME(TEXT("Planet/ManagerUpdate"));
+
+#if PLANET_TRACK_UPDATE_ALLOCATIONS
+    const int64 FootprintBefore = GetUpdateFootprint();
+#endif
+
+    UpdateFrame++;
+    FrameMaxLatencyMs = 0.f;
+
+    // Apply last frame's finished chunks first, so every stage below sees their new states
+    if (ChunkGenerator)
+        ChunkGenerator->ProcessCompletedTasks();
+
+    const bool bShouldGenerateChunks = IsInGenerationRange(Context.ObserverLocation);
 
     if (bShouldGenerateChunks && Quadtree)
+    {
         Quadtree->Update(Context);
+        bReconcileDirty |= Quadtree->HasLeafChanges();
+    }
+
+    // Switching to or from the far model swaps the desired set for an empty one
+    if (bShouldGenerateChunks != bWasGeneratingChunks)
+    {
+        bWasGeneratingChunks = bShouldGenerateChunks;
+        bReconcileDirty = true;
+    }
 
-    const TSet<FChunkId> &DesiredLeaves = (bShouldGenerateChunks && Quadtree) ? Quadtree->GetDesiredLeaves() : TSet<FChunkId>();
+    // Far model: nothing is desired. The static avoids building (or, through the conditional, copying) a set every frame.
+    static const TSet<FChunkId> NoDesiredLeaves;
+    const TSet<FChunkId> &DesiredLeaves = (bShouldGenerateChunks && Quadtree) ? Quadtree->GetDesiredLeaves() : NoDesiredLeaves;
 
     BuildLoadSet(DesiredLeaves);
 
-    ReconcileTransitions(DesiredLeaves);
-    AdvanceLoading();
+    if (bShouldGenerateChunks)
+        BuildPrefetchSet(Context);
+    else
+        PrefetchSet.Reset();
+
+    // The reconciliation only depends on DesiredLeaves, RenderSet and PendingTransitions: skip it while none of them changed
+    if (bReconcileDirty)
+        ReconcileTransitions(DesiredLeaves);
+
+    if (bShouldGenerateChunks && (ShownLeaves.Num() > 0 || SeamDirtyIds.Num() > 0))
+        RefreshSeams();
+
+    AdvanceLoading(Context);
+    AdvancePrefetch();
     CommitReadyTransitions();
     ProcessDeferredReleases();
     PruneOrphans();
+    EnforceMemoryBudget(Context);
+    UpdateCollision(Context);
 
     if (ChunkGenerator)
-        ChunkGenerator->Update();
+        ChunkGenerator->Update(Context);
+
+#if PLANET_TRACK_UPDATE_ALLOCATIONS
+    const int64 FootprintAfter = GetUpdateFootprint();
+    UpdateAllocationStats.FrameCount++;
+    UpdateAllocationStats.FootprintBytes = FootprintAfter;
+    if (FootprintAfter > FootprintBefore)
+    {
+        UpdateAllocationStats.GrowthFrames++;
+        UpdateAllocationStats.LastGrowthBytes = FootprintAfter - FootprintBefore;
+    }
+#endif
+
+#if STATS
+    SET_DWORD_STAT(STAT_PlanetChunks, ChunkMap.Num());
+    SET_DWORD_STAT(STAT_PlanetVisibleChunks, GetVisibleChunkCount());
+    SET_DWORD_STAT(STAT_PlanetUploads, UploadStats.UploadedLastFrame);
+    SET_FLOAT_STAT(STAT_PlanetLatencyMax, FrameMaxLatencyMs);
+    SET_MEMORY_STAT(STAT_PlanetResidentMeshData, MemoryStats.MeshBytes);
+    SET_MEMORY_STAT(STAT_PlanetMeshCacheData, MemoryStats.CacheBytes);
+    SET_MEMORY_STAT(STAT_PlanetResidentGPUData, MemoryStats.GPUBytes);
+    SET_DWORD_STAT(STAT_PlanetComponents, MemoryStats.Components);
+#endif
 
     // DebugRootNodes();
 }
 
 
+int64 FChunkManager::GetUpdateFootprint() const
+{
+    return ChunkMap.GetAllocatedSize() + LoadSet.GetAllocatedSize() + PrefetchSet.GetAllocatedSize() + RenderSet.GetAllocatedSize() +
+           DeferredReleaseIds.GetAllocatedSize() + PendingTransitions.GetAllocatedSize() + DeferredReleaseQueue.GetAllocatedSize() +
+           UploadCandidates.GetAllocatedSize() + PrefetchPositions.GetAllocatedSize() + ScratchIds.GetAllocatedSize() +
+           ScratchDescendants.GetAllocatedSize() + CollisionRequests.GetAllocatedSize() + EvictionCandidates.GetAllocatedSize() +
+           ShownLeaves.GetAllocatedSize() + SeamDirtyIds.GetAllocatedSize() + SeamSearchStack.GetAllocatedSize();
+}
+
+
 void FChunkManager::BuildLoadSet(const TSet<FChunkId> &DesiredLeaves)
 {
     LoadSet.Reset();
@@ -184,24 +341,122 @@ void FChunkManager::BuildLoadSet(const TSet<FChunkId> &DesiredLeaves)
 }
 
 
-void FChunkManager::PruneOrphans()
+void FChunkManager::BuildPrefetchSet(const FPlanetViewContext &Context)
+{
+    PrefetchSet.Reset();
+    PrefetchStats.InFlight = 0;
+
+    const float Speed = Context.ObserverVelocity.Size();
+    if (!Quadtree || Config.MaxPrefetchChunks <= 0 || Speed < FPlanetStatics::PrefetchMinSpeed)
+        return;
+
+    // Look further ahead when high up: chunks are bigger and the observer typically flies faster there
+    const float Altitude = FMath::Max(Context.ObserverLocation.Size() - Config.PlanetRadius, 0.0f);
+    const float AltitudeAlpha = FMath::Clamp(Altitude / FMath::Max(Config.LookAheadAltitudeScale, 1.0f), 0.0f, 1.0f);
+    const float LookAheadTime = FMath::Lerp(Config.MinLookAheadTime, Config.MaxLookAheadTime, AltitudeAlpha);
+
+    PrefetchPositions.Reset();
+    for (int32 i = 1; i <= FPlanetStatics::PrefetchSampleCount; i++)
+    {
+        FVector Future = Context.ObserverLocation + Context.ObserverVelocity * (LookAheadTime * i / FPlanetStatics::PrefetchSampleCount);
+
+        // Never extrapolate through the ground
+        if (Future.Size() < Config.PlanetRadius)
+            Future = Future.GetSafeNormal() * Config.PlanetRadius;
+
+        PrefetchPositions.Add(Future);
+    }
+
+    Quadtree->GetPrefetchLeaves(PrefetchPositions, Config.MaxPrefetchChunks, PrefetchSet);
+
+    // Whatever is already needed this frame goes through the normal path
+    PrefetchSet.RemoveAll([this](const FChunkId &Id) { return LoadSet.Contains(Id); });
+    PrefetchStats.InFlight = PrefetchSet.Num();
+}
+
+
+void FChunkManager::AdvancePrefetch()
 {
-    TArray<FChunkId> ToRemove;
+    // Over the memory budget nothing new starts. Generated chunks stay needed: pruning them would only move them into the
+    // mesh cache the budget is shrinking. Work in flight is dropped without caching anything.
+    if (MemoryStats.bPrefetchSuspended)
+    {
+        for (const FChunkId &Id : PrefetchSet)
+        {
+            FChunk *Chunk = GetChunk(Id);
+            if (!Chunk)
+                continue;
 
-    for (const auto &Pair : ChunkMap)
+            if (Chunk->State == EChunkState::Pending || Chunk->State == EChunkState::Generating)
+            {
+                if (ChunkGenerator)
+                    ChunkGenerator->CancelRequest(Id);
+                DestroyChunk(Id, false);
+            }
+            else
+            {
+                MarkNeeded(Chunk);
+            }
+        }
+        return;
+    }
+
+    for (const FChunkId &Id : PrefetchSet)
     {
-        const FChunkId &Id = Pair.Key;
-        const FChunk *Chunk = Pair.Value.Get();
+        FChunk *Chunk = GetChunk(Id);
+        if (!Chunk)
+            Chunk = CreateChunk(Id);
+        MarkNeeded(Chunk);
+
+        if (Chunk->State != EChunkState::None)
+            continue;  // Generating, or generated and waiting to be demanded (uploads are reserved for LoadSet)
+
+        Chunk->bPrefetched = true;
+
+        if (MeshCache)
+        {
+            if (TUniquePtr<FChunkMeshData> CachedMesh = MeshCache->Take(Id))
+            {
+                Chunk->MeshData = MoveTemp(CachedMesh);
+                Chunk->Transform = FMathUtils::ComputeChunkTransform(Id, Config.PlanetRadius);
+                SetChunkState(Chunk, EChunkState::DataReady);
+                UpdateResidentMemory(Chunk);
+                continue;
+            }
+        }
 
-        if (LoadSet.Contains(Id))
-            continue;  // Actively needed
+        Chunk->GenerationId++;
+        SetChunkState(Chunk, EChunkState::Pending);
+        ChunkGenerator->RequestChunk(Id, Chunk->GenerationId, true, GetParentDensity(Id), ComputeSeams(Id));
+    }
+}
+
+
+void FChunkManager::PruneOrphans()
+{
+    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetPruneOrphans);
+
+    TArray<FChunkId> &ToRemove = ScratchIds;
+    ToRemove.Reset();
+
+    // AdvanceLoading and AdvancePrefetch moved every chunk of LoadSet and PrefetchSet to the tail:
+    // only the head, not needed this frame, has to be looked at.
+    for (const FChunk *Chunk = NeededOrder.GetHead(); Chunk && Chunk->LastNeededFrame != UpdateFrame; Chunk = NeededOrder.GetNext(Chunk))
+    {
+        const FChunkId &Id = Chunk->Id;
 
         if (DeferredReleaseIds.Contains(Id))
             continue;  // Already on its way out
 
-        // Only prune chunks that are not in flight
+        // Chunks in flight are cancelled: a queued request is dropped for free, an active task stops at its next z-slice,
+        // so stale chunks don't hog the generator.
         if (Chunk->State == EChunkState::Pending || Chunk->State == EChunkState::Generating)
-            continue;
+        {
+            if (!ChunkGenerator)
+                continue;
+
+            ChunkGenerator->CancelRequest(Id);
+        }
 
         UE_LOG(LogTemp, Warning, TEXT("PruneOrphans: removing LOD:%d Face:%d State:%d"), Id.LODLevel, Id.FaceIndex, (int32)Chunk->State);
 
@@ -213,7 +468,7 @@ void FChunkManager::PruneOrphans()
         FChunk *Chunk = GetChunk(Id);
         if (Chunk && Chunk->State == EChunkState::MeshReady)
             Renderer->ReleaseChunk(Chunk);
-        ChunkMap.Remove(Id);
+        DestroyChunk(Id);
     }
 }
 
@@ -232,6 +487,11 @@ void FChunkManager::InitializeRoots()
 
 void FChunkManager::ReconcileTransitions(const TSet<FChunkId> &DesiredLeaves)
 {
+    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetReconcileTransitions);
+
+    // Any change made below dirties it again, so the next frame re-runs until nothing moves anymore
+    bReconcileDirty = false;
+
     // --- A1. Desired but not rendered → find committed ancestor → register Split ---
     for (const FChunkId &Id : DesiredLeaves)
     {
@@ -256,6 +516,7 @@ void FChunkManager::ReconcileTransitions(const TSet<FChunkId> &DesiredLeaves)
                     T.Parent = AncestorId;
                     T.Children = GetChildrenIds(AncestorId);
                     PendingTransitions.Add(AncestorId, MoveTemp(T));
+                    bReconcileDirty = true;
                     UE_LOG(LogTemp, Log, TEXT("Split registered — parent LOD:%d Face:%d"), AncestorId.LODLevel, AncestorId.FaceIndex);
                 }
                 break;
@@ -268,7 +529,8 @@ void FChunkManager::ReconcileTransitions(const TSet<FChunkId> &DesiredLeaves)
     }
 
     // --- A2. Rendered but not desired → find desired ancestor → register Merge ---
-    TArray<FChunkId> ToUnrender;
+    TArray<FChunkId> &ToUnrender = ScratchIds;
+    ToUnrender.Reset();
 
     for (const FChunkId &Id : RenderSet)
     {
@@ -312,6 +574,7 @@ void FChunkManager::ReconcileTransitions(const TSet<FChunkId> &DesiredLeaves)
                     T.Parent = AncestorId;
                     T.Children = GetChildrenIds(AncestorId);
                     PendingTransitions.Add(AncestorId, MoveTemp(T));
+                    bReconcileDirty = true;
                     UE_LOG(LogTemp, Log, TEXT("Merge registered — parent LOD:%d Face:%d"), AncestorId.LODLevel, AncestorId.FaceIndex);
                 }
                 break;
@@ -336,17 +599,19 @@ void FChunkManager::ReconcileTransitions(const TSet<FChunkId> &DesiredLeaves)
         if (Chunk && (Chunk->State == EChunkState::Visible || Chunk->State == EChunkState::MeshReady))
         {
             Renderer->HideChunk(Chunk);
-            Chunk->State = EChunkState::MeshReady;
+            SetChunkState(Chunk, EChunkState::MeshReady);
 
             // Use deferred release to prevent thrashing at the hysteresis boundary
             DeferredReleaseQueue.Add({Id, Config.ChunkDemotionFrameDelay});
             DeferredReleaseIds.Add(Id);
         }
         RenderSet.Remove(Id);
+        bReconcileDirty = true;
     }
 
     // --- A3. Conflict resolution: cancel Split if Merge now exists for same region, and vice versa ---
-    TArray<FChunkId> ToCancel;
+    TArray<FChunkId> &ToCancel = ScratchIds;
+    ToCancel.Reset();
     for (const auto &Pair : PendingTransitions)
     {
         const FLODTransition &T = Pair.Value;
@@ -377,13 +642,16 @@ void FChunkManager::ReconcileTransitions(const TSet<FChunkId> &DesiredLeaves)
     {
         UE_LOG(LogTemp, Log, TEXT("Transition cancelled — LOD:%d Face:%d"), Id.LODLevel, Id.FaceIndex);
         PendingTransitions.Remove(Id);
+        bReconcileDirty = true;
     }
 }
 
 
-void FChunkManager::AdvanceLoading()
+void FChunkManager::AdvanceLoading(const FPlanetViewContext &Context)
 {
-    int32 MeshUploadsThisFrame = 0;
+    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetAdvanceLoading);
+
+    UploadCandidates.Reset();
 
     // Advance each required chunk through its lifecycle
     for (const FChunkId &Id : LoadSet)
@@ -393,23 +661,52 @@ void FChunkManager::AdvanceLoading()
         {
             Chunk = CreateChunk(Id);
         }
+        MarkNeeded(Chunk);
+
+        // First time this chunk is actually needed: was the look-ahead early enough?
+        if (!Chunk->bDemanded)
+        {
+            Chunk->bDemanded = true;
+            Chunk->DemandTime = FPlatformTime::Seconds();
+            if (!Chunk->bPrefetched)
+                PrefetchStats.Unpredicted++;
+            else if (Chunk->State >= EChunkState::DataReady)
+                PrefetchStats.ReadyInTime++;
+            else
+                PrefetchStats.Late++;
+        }
+
+        // Queued as a prefetch: promote to a regular request now that it is needed
+        if (Chunk->bPrefetched && Chunk->State == EChunkState::Pending)
+        {
+            ChunkGenerator->RequestChunk(Id, Chunk->GenerationId, false, GetParentDensity(Id), ComputeSeams(Id));
+            Chunk->bPrefetched = false;
+        }
 
         switch (Chunk->State)
         {
             case EChunkState::None:
+                // Recently released: reuse the mesh instead of regenerating it
+                if (MeshCache)
+                {
+                    if (TUniquePtr<FChunkMeshData> CachedMesh = MeshCache->Take(Id))
+                    {
+                        Chunk->MeshData = MoveTemp(CachedMesh);
+                        Chunk->Transform = FMathUtils::ComputeChunkTransform(Id, Config.PlanetRadius);
+                        SetChunkState(Chunk, EChunkState::DataReady);
+                        UpdateResidentMemory(Chunk);
+                        break;
+                    }
+                }
+
                 UE_LOG(LogTemp, Warning, TEXT("AdvanceLoading: requesting LOD:%d Face:%d"), Id.LODLevel, Id.FaceIndex);
                 Chunk->GenerationId++;
-                Chunk->State = EChunkState::Pending;
-                ChunkGenerator->RequestChunk(Id, Chunk->GenerationId);
+                SetChunkState(Chunk, EChunkState::Pending);
+                ChunkGenerator->RequestChunk(Id, Chunk->GenerationId, false, GetParentDensity(Id), ComputeSeams(Id));
                 break;
 
             case EChunkState::DataReady:
-                if (MeshUploadsThisFrame < Config.MeshUpdatesPerFrame)
-                {
-                    Renderer->PrepareChunk(Chunk, Config.bEnableCollision);
-                    Chunk->State = EChunkState::MeshReady;
-                    MeshUploadsThisFrame++;
-                }
+                UploadCandidates.Add(Chunk);  // Uploaded below, nearest first
                 break;
 
             case EChunkState::Pending:
@@ -419,25 +716,60 @@ void FChunkManager::AdvanceLoading()
                 break;  // Already progressing or ready
         }
     }
+
+    // Upload stage: nearest chunks first until the time budget or the per-frame cap runs out, the rest carries over.
+    const FVector ObserverLocation = Context.ObserverLocation;
+    UploadCandidates.Sort(
+        [&ObserverLocation](const FChunk &A, const FChunk &B)
+        { return FVector::DistSquared(A.Transform.Location, ObserverLocation) < FVector::DistSquared(B.Transform.Location, ObserverLocation); });
+
+    const double StartTime = FPlatformTime::Seconds();
+    const double BudgetSeconds = Config.MeshUploadBudgetMs * 0.001;
+    int32 MeshUploadsThisFrame = 0;
+
+    for (FChunk *Chunk : UploadCandidates)
+    {
+        // Always upload at least one chunk per frame so a single oversized mesh can't stall loading forever
+        if (MeshUploadsThisFrame >= Config.MeshUpdatesPerFrame || (MeshUploadsThisFrame > 0 && FPlatformTime::Seconds() - StartTime >= BudgetSeconds))
+            break;
+
+        Renderer->PrepareChunk(Chunk);
+        SetChunkState(Chunk, EChunkState::MeshReady);
+        OnMeshUploaded(Chunk);
+        MeshUploadsThisFrame++;
+    }
+
+    UploadStats.LastFrameMs = MeshUploadsThisFrame > 0 ? (float)((FPlatformTime::Seconds() - StartTime) * 1000.0) : 0.f;
+    UploadStats.UploadedLastFrame = MeshUploadsThisFrame;
+    UploadStats.Backlog = UploadCandidates.Num() - MeshUploadsThisFrame;
+    if (MeshUploadsThisFrame > 0)
+    {
+        UploadStats.PeakFrameMs = FMath::Max(UploadStats.PeakFrameMs, UploadStats.LastFrameMs);
+        UploadStats.AverageFrameMs = FMath::Lerp(UploadStats.AverageFrameMs, UploadStats.LastFrameMs, 0.1f);
+    }
 }
 
 
 void FChunkManager::CommitReadyTransitions()
 {
-    for (const auto &Pair : ChunkMap)
+    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetCommitTransitions);
+
+    for (uint8 Face = 0; Face < 6; ++Face)
     {
-        const FChunkId &Id = Pair.Key;
-        const FChunk *Chunk = Pair.Value.Get();
-        if (IsRootNode(Id) && !RenderSet.Contains(Id) && IsChunkReady(Id))
+        const FChunkId Id(Face, FIntVector(0, 0, 0), 0);
+        if (!RenderSet.Contains(Id) && IsChunkReady(Id))
         {
             FChunk *Root = GetChunk(Id);
             Renderer->ShowChunk(Root);
-            Root->State = EChunkState::Visible;
+            SetChunkState(Root, EChunkState::Visible);
             RenderSet.Add(Id);
+            ShownLeaves.Add(Id);
+            bReconcileDirty = true;
         }
     }
 
-    TArray<FChunkId> ToRemove;
+    TArray<FChunkId> &ToRemove = ScratchIds;
+    ToRemove.Reset();
 
     for (auto &Pair : PendingTransitions)
     {
@@ -466,11 +798,19 @@ void FChunkManager::CommitReadyTransitions()
                 if (Child)
                 {
                     Renderer->ShowChunk(Child);
-                    Child->State = EChunkState::Visible;
+                    SetChunkState(Child, EChunkState::Visible);
                     RenderSet.Add(ChildId);
+                    ShownLeaves.Add(ChildId);
                 }
             }
 
+            // The children are generated: the parent's samples are no longer needed
+            if (FChunk *Parent = GetChunk(T.Parent))
+            {
+                Parent->DensityField.Reset();
+                UpdateResidentMemory(Parent);
+            }
+
             // Hide and defer parent
             if (!IsRootNode(T.Parent))
             {
@@ -478,7 +818,7 @@ void FChunkManager::CommitReadyTransitions()
                 if (Parent && (Parent->State == EChunkState::Visible || Parent->State == EChunkState::MeshReady))
                 {
                     Renderer->HideChunk(Parent);
-                    Parent->State = EChunkState::MeshReady;
+                    SetChunkState(Parent, EChunkState::MeshReady);
                     DeferredReleaseQueue.Add({T.Parent, Config.ChunkDemotionFrameDelay});
                     DeferredReleaseIds.Add(T.Parent);
                 }
@@ -498,12 +838,14 @@ void FChunkManager::CommitReadyTransitions()
             if (Parent)
             {
                 Renderer->ShowChunk(Parent);
-                Parent->State = EChunkState::Visible;
+                SetChunkState(Parent, EChunkState::Visible);
                 RenderSet.Add(T.Parent);
+                ShownLeaves.Add(T.Parent);
             }
 
             // Collect all committed descendants of T.Parent (depth-first from CommittedLeaves)
-            TArray<FChunkId> ToCleanup;
+            TArray<FChunkId> &ToCleanup = ScratchDescendants;
+            ToCleanup.Reset();
             for (const FChunkId &RenderedId : RenderSet)
             {
                 if (RenderedId == T.Parent)
@@ -530,7 +872,7 @@ void FChunkManager::CommitReadyTransitions()
                     if (Child->State == EChunkState::Visible || Child->State == EChunkState::MeshReady)
                     {
                         Renderer->HideChunk(Child);
-                        Child->State = EChunkState::MeshReady;
+                        SetChunkState(Child, EChunkState::MeshReady);
                         DeferredReleaseQueue.Add({ChildId, Config.ChunkDemotionFrameDelay});
                         DeferredReleaseIds.Add(ChildId);
                     }
@@ -545,20 +887,26 @@ void FChunkManager::CommitReadyTransitions()
     // Removal from pending transitions
     for (const FChunkId &Id : ToRemove)
         PendingTransitions.Remove(Id);
+
+    // Every committed transition changed RenderSet
+    if (ToRemove.Num() > 0)
+        bReconcileDirty = true;
 }
 
 
 void FChunkManager::ProcessDeferredReleases()
 {
-    TArray<FDeferredRelease> StillWaiting;
+    // Compacted in place: waiting entries slide down, the queue keeps its allocation
+    int32 NumWaiting = 0;
 
-    for (FDeferredRelease &Entry : DeferredReleaseQueue)
+    for (int32 i = 0; i < DeferredReleaseQueue.Num(); i++)
     {
+        FDeferredRelease &Entry = DeferredReleaseQueue[i];
         Entry.FrameCountdown--;
 
         if (Entry.FrameCountdown > 0)
         {
-            StillWaiting.Add(Entry);
+            DeferredReleaseQueue[NumWaiting++] = Entry;
             continue;
         }
 
@@ -579,11 +927,242 @@ void FChunkManager::ProcessDeferredReleases()
                 Chunk->RenderProxy.Reset();
 
             DeferredReleaseIds.Remove(Entry.Id);
-            ChunkMap.Remove(Entry.Id);
+            DestroyChunk(Entry.Id);
+        }
+    }
+
+    DeferredReleaseQueue.SetNum(NumWaiting, EAllowShrinking::No);
+}
+
+
+void FChunkManager::UpdateCollision(const FPlanetViewContext &Context)
+{
+    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetUpdateCollision);
+
+    if (!Collision)
+        return;
+
+    TArray<FCollisionRequest> &Requests = CollisionRequests;
+    Requests.Reset();
+
+    const int32 MinCollisionLOD = GetMinCollisionLOD();
+    const float KeepRadius = Config.CollisionRadius * FPlanetStatics::CollisionReleaseRatio;
+
+    auto Consider = [&](const FChunk *Chunk)
+    {
+        if (Chunk->Id.LODLevel < MinCollisionLOD || !Chunk->MeshData || Chunk->MeshData->bCPUDataReleased)
+            return;
+
+        const FSphereBounds Bounds = FMathUtils::GetChunkBounds(Chunk->Id, Config.PlanetRadius, Config.MaxTerrainHeight);
+        float Distance = TNumericLimits<float>::Max();
+        for (const FVector &ActorLocation : Context.PhysicsActorLocations)
+        {
+            Distance = FMath::Min(Distance, FMath::Max(0.f, FVector::Dist(ActorLocation, Bounds.Center) - Bounds.Radius));
+        }
+
+        // Hysteresis: a chunk that already collides is kept a little further out, so walking along the radius doesn't thrash the cooker
+        const bool bHasCollision = Collision->HasCollision(Chunk->Id);
+        if (Distance > (bHasCollision ? KeepRadius : Config.CollisionRadius))
+            return;
+
+        FCollisionRequest &Request = Requests.AddDefaulted_GetRef();
+        Request.Chunk = Chunk;
+        Request.Distance = Distance;
+        // Hidden chunks on their way out keep their body until released, covering the cooking latency of their replacements.
+        // A mesh being regenerated for its seams is rebuilt once the new one arrives.
+        Request.bAllowBuild = !DeferredReleaseIds.Contains(Chunk->Id) && !Chunk->bSeamRefreshPending;
+    };
+
+    if (Context.PhysicsActorLocations.Num() > 0)
+    {
+        // Visible chunks, and MeshReady ones: incoming halves of pending transitions get their collision before they are shown
+        for (const FChunk *Chunk = ChunksByState[(int32)EChunkState::Visible].GetHead(); Chunk; Chunk = FChunkStateList::GetNext(Chunk))
+            Consider(Chunk);
+        for (const FChunk *Chunk = ChunksByState[(int32)EChunkState::MeshReady].GetHead(); Chunk; Chunk = FChunkStateList::GetNext(Chunk))
+            Consider(Chunk);
+    }
+
+    // Chunks missing from the list lose their collision
+    Collision->Update(Requests);
+}
+
+
+void FChunkManager::DestroyChunk(const FChunkId &Id, bool bAllowCache)
+{
+    TUniquePtr<FChunk> *Found = ChunkMap.Find(Id);
+    if (!Found)
+        return;
+
+    FChunk *Chunk = Found->Get();
+
+    // A released mesh only holds its seams: nothing worth caching
+    if (MeshCache && bAllowCache && Chunk->MeshData && !Chunk->MeshData->bCPUDataReleased)
+        MeshCache->Add(Id, MoveTemp(Chunk->MeshData));
+
+    MemoryStats.MeshBytes -= Chunk->ResidentCPUBytes;
+    MemoryStats.GPUBytes -= Chunk->ResidentGPUBytes;
+    MemoryStats.Components -= Chunk->bResidentComponent ? 1 : 0;
+
+    if (Collision)
+        Collision->ReleaseChunk(Id);
+
+    ChunksByState[(int32)Chunk->State].Remove(Chunk);
+    AdjustStateCount(Chunk, -1);
+    NeededOrder.Remove(Chunk);
+
+    ChunkMap.Remove(Id);
+}
+
+
+// ---------------------------------------------------------------------------
+// Resident memory
+// ---------------------------------------------------------------------------
+
+// Vertex and index buffers as both render backends allocate them. 16-bit indices whenever the vertex count allows.
+static int64 EstimateGPUBytes(const FChunkMeshData &MeshData)
+{
+    const int64 BytesPerVertex = 12 + 8 + 4 + (MeshData.Colors.Num() > 0 ? 4 : 0);  // Position, packed tangent basis, half-precision UV, debug color
+    const int64 NumVertices = MeshData.GetNumVertices();
+    const int64 BytesPerIndex = NumVertices <= MAX_uint16 ? 2 : 4;
+    return NumVertices * BytesPerVertex + MeshData.Triangles.Num() * BytesPerIndex;
+}
+
+
+void FChunkManager::UpdateResidentMemory(FChunk *Chunk)
+{
+    int64 CPUBytes = Chunk->MeshData ? FChunkMeshCache::GetMeshDataSize(*Chunk->MeshData) : 0;
+    if (Chunk->DensityField)
+        CPUBytes += sizeof(FRetainedDensity) + Chunk->DensityField->Densities.GetAllocatedSize();
+
+    // GPU buffers are sized from the vertex arrays: once those are released, the estimate made at upload is kept
+    const bool bHasComponent = Chunk->RenderProxy.IsValid();
+    int64 GPUBytes = 0;
+    if (bHasComponent)
+        GPUBytes = (Chunk->MeshData && !Chunk->MeshData->bCPUDataReleased) ? EstimateGPUBytes(*Chunk->MeshData) : Chunk->ResidentGPUBytes;
+
+    MemoryStats.MeshBytes += CPUBytes - Chunk->ResidentCPUBytes;
+    MemoryStats.GPUBytes += GPUBytes - Chunk->ResidentGPUBytes;
+    MemoryStats.Components += (bHasComponent ? 1 : 0) - (Chunk->bResidentComponent ? 1 : 0);
+
+    Chunk->ResidentCPUBytes = CPUBytes;
+    Chunk->ResidentGPUBytes = GPUBytes;
+    Chunk->bResidentComponent = bHasComponent;
+}
+
+
+void FChunkManager::OnMeshUploaded(FChunk *Chunk)
+{
+    UpdateResidentMemory(Chunk);
+
+    // Collision decimates the CPU mesh, and the mesh cache stores it on release: both need the arrays.
+    // Whether a pawn will come close is unknown, so every LOD that may ever get collision keeps them.
+    const bool bCollisionMayNeedIt = Collision && Chunk->Id.LODLevel >= GetMinCollisionLOD();
+    if (!Config.bReleaseMeshDataAfterUpload || MeshCache || bCollisionMayNeedIt)
+        return;
+
+    if (Chunk->MeshData && !Chunk->MeshData->bCPUDataReleased && Chunk->RenderProxy.IsValid())
+    {
+        Chunk->MeshData->ReleaseCPUData();
+        MemoryStats.ReleasedMeshData++;
+        UpdateResidentMemory(Chunk);
+    }
+}
+
+
+bool FChunkManager::IsOverMemoryBudget(float Ratio) const
+{
+    constexpr double BytesPerMB = 1024.0 * 1024.0;
+    return (Config.MeshMemoryBudgetMB > 0 && MemoryStats.GetCPUBytes() > Config.MeshMemoryBudgetMB * BytesPerMB * Ratio) ||
+           (Config.GPUMemoryBudgetMB > 0 && MemoryStats.GPUBytes > Config.GPUMemoryBudgetMB * BytesPerMB * Ratio) ||
+           (Config.MaxResidentComponents > 0 && MemoryStats.Components > Config.MaxResidentComponents * Ratio);
+}
+
+
+void FChunkManager::EnforceMemoryBudget(const FPlanetViewContext &Context)
+{
+    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetEnforceMemoryBudget);
+
+    MemoryStats.CacheBytes = MeshCache ? MeshCache->GetSizeBytes() : 0;
+
+    if (!IsOverMemoryBudget(1.f))
+    {
+        MemoryStats.bOverBudget = false;
+
+        // Hysteresis: prefetching right at the limit would only generate chunks to evict them again
+        if (MemoryStats.bPrefetchSuspended && !IsOverMemoryBudget(FPlanetStatics::MemoryBudgetResumeRatio))
+            MemoryStats.bPrefetchSuspended = false;
+        return;
+    }
+
+    MemoryStats.bPrefetchSuspended = true;
+
+    // The mesh cache only holds chunks nobody asked for: it shrinks first
+    const int64 CPUBudgetBytes = (int64)Config.MeshMemoryBudgetMB * 1024 * 1024;
+    const bool bCPUOver = CPUBudgetBytes > 0 && MemoryStats.GetCPUBytes() > CPUBudgetBytes;
+    if (MeshCache && bCPUOver)
+    {
+        MeshCache->Trim(FMath::Max<int64>(0, CPUBudgetBytes - MemoryStats.MeshBytes));
+        MemoryStats.CacheBytes = MeshCache->GetSizeBytes();
+    }
+
+    // Then the chunks outside LoadSet: hidden ones waiting for their deferred release, and prefetched meshes not demanded yet.
+    // Within the CPU budget, only chunks holding a component free anything of the budgets left.
+    EvictionCandidates.Reset();
+    const bool bCPUStillOver = CPUBudgetBytes > 0 && MemoryStats.GetCPUBytes() > CPUBudgetBytes;
+    auto Consider = [&](FChunk *Chunk)
+    {
+        if (LoadSet.Contains(Chunk->Id) || RenderSet.Contains(Chunk->Id))
+            return;
+        if (!bCPUStillOver && !Chunk->bResidentComponent)
+            return;
+        EvictionCandidates.Add(Chunk);
+    };
+
+    for (const FDeferredRelease &Entry : DeferredReleaseQueue)
+    {
+        FChunk *Chunk = GetChunk(Entry.Id);
+        if (Chunk && Chunk->State == EChunkState::MeshReady)
+            Consider(Chunk);
+    }
+    for (FChunk *Chunk = ChunksByState[(int32)EChunkState::DataReady].GetHead(); Chunk; Chunk = FChunkStateList::GetNext(Chunk))
+        Consider(Chunk);
+
+    // Farthest first, the coarsest of equally far chunks first
+    const FVector ObserverLocation = Context.ObserverLocation;
+    EvictionCandidates.Sort(
+        [&ObserverLocation](const FChunk &A, const FChunk &B)
+        {
+            const double DistA = FVector::DistSquared(A.Transform.Location, ObserverLocation);
+            const double DistB = FVector::DistSquared(B.Transform.Location, ObserverLocation);
+            return DistA != DistB ? DistA > DistB : A.Id.LODLevel < B.Id.LODLevel;
+        });
+
+    for (FChunk *Chunk : EvictionCandidates)
+    {
+        if (!IsOverMemoryBudget(1.f))
+            break;
+
+        const FChunkId Id = Chunk->Id;
+        if (Chunk->State == EChunkState::MeshReady)
+        {
+            Renderer->ReleaseChunk(Chunk);
+            DeferredReleaseIds.Remove(Id);
+            DeferredReleaseQueue.RemoveAllSwap([&Id](const FDeferredRelease &Entry) { return Entry.Id == Id; }, EAllowShrinking::No);
         }
+
+        // Caching it would keep the memory the eviction is meant to free
+        DestroyChunk(Id, false);
+        MemoryStats.EvictedChunks++;
     }
 
-    DeferredReleaseQueue = MoveTemp(StillWaiting);
+    MemoryStats.bOverBudget = IsOverMemoryBudget(1.f);
+}
+
+
+int32 FChunkManager::GetMinCollisionLOD() const
+{
+    // Roots stay loaded (hidden) under their children: they never get collision
+    return FMath::Max(1, Config.MaxLOD - Config.CollisionLODCount + 1);
 }
 
 
@@ -592,24 +1171,19 @@ void FChunkManager::ProcessDeferredReleases()
 // ---------------------------------------------------------------------------
 FChunkId FChunkManager::GetParentId(const FChunkId &Child)
 {
-    // Integer divide coords by 2, step up one LOD level.
-    return FChunkId(Child.FaceIndex, FIntVector(Child.Coords.X / 2, Child.Coords.Y / 2, 0), Child.LODLevel - 1);
+    // Drop the lowest X/Y bit pair of the Morton code, step up one LOD level.
+    return FChunkId(Child.GetKey().GetParent());
 }
 
 
-TArray<FChunkId> FChunkManager::GetChildrenIds(const FChunkId &Parent)
+TStaticArray<FChunkId, 4> FChunkManager::GetChildrenIds(const FChunkId &Parent)
 {
-    const int32 NextLOD = Parent.LODLevel + 1;
-    const int32 X = Parent.Coords.X;
-    const int32 Y = Parent.Coords.Y;
-    const uint8 Face = Parent.FaceIndex;
+    const FChunkKey Key = Parent.GetKey();
 
-    return {
-        FChunkId(Face, FIntVector(X * 2, Y * 2, 0), NextLOD),
-        FChunkId(Face, FIntVector(X * 2 + 1, Y * 2, 0), NextLOD),
-        FChunkId(Face, FIntVector(X * 2, Y * 2 + 1, 0), NextLOD),
-        FChunkId(Face, FIntVector(X * 2 + 1, Y * 2 + 1, 0), NextLOD),
-    };
+    TStaticArray<FChunkId, 4> Children;
+    for (int32 i = 0; i < 4; i++)
+        Children[i] = FChunkId(Key.GetChild(i));
+    return Children;
 }
 
 
@@ -640,13 +1214,13 @@ void FChunkManager::DrawDebugChunkBounds(const UWorld *World) const
     if (!World)
         return;
 
-    for (const auto &Pair : ChunkMap)
+    const FChunkStateList &VisibleChunks = GetChunksInState(EChunkState::Visible);
+    for (const FChunk *Chunk = VisibleChunks.GetHead(); Chunk; Chunk = FChunkStateList::GetNext(Chunk))
     {
-        const FChunk *Chunk = Pair.Value.Get();
         // Only draw bounds for chunks that have a visible mesh component
-        if (Chunk && Chunk->State == EChunkState::Visible && Chunk->RenderProxy.IsValid())
+        if (Chunk->RenderProxy.IsValid())
         {
-            if (UProceduralMeshComponent *Comp = Chunk->RenderProxy.Get())
+            if (UMeshComponent *Comp = Chunk->RenderProxy.Get())
             {
                 const int32 LOD = Chunk->Id.LODLevel;
                 // Use LOD color if available, otherwise fallback to white
@@ -659,7 +1233,7 @@ void FChunkManager::DrawDebugChunkBounds(const UWorld *World) const
 }
 
 
-void FChunkManager::OnGenerationComplete(const FChunkId &Id, uint32 GenId, TUniquePtr<FChunkMeshData> MeshData)
+void FChunkManager::OnGenerationComplete(const FChunkId &Id, uint32 GenId, TUniquePtr<FChunkMeshData> MeshData, FRetainedDensityPtr Density)
 {
     UE_LOG(LogTemp, Warning, TEXT("OnGenerationComplete: LOD:%d Face:%d"), Id.LODLevel, Id.FaceIndex);
 
@@ -670,15 +1244,170 @@ void FChunkManager::OnGenerationComplete(const FChunkId &Id, uint32 GenId, TUniq
     if (Chunk->GenerationId != GenId)
         return;  // Stale task (Chunk was reset/regenerated)
 
+    // Its seams were computed when it was requested: the rendered neighbours may have changed since
+    SeamDirtyIds.Add(Id);
+
     // Only accept the result if the chunk is still in the generation pipeline.
-    // MeshReady or Visible chunks must not be overwritten by a late callback.
+    // MeshReady or Visible chunks must not be overwritten by a late callback, unless it is their seam refresh.
     if (Chunk->State == EChunkState::MeshReady || Chunk->State == EChunkState::Visible)
+    {
+        if (!Chunk->bSeamRefreshPending)
+            return;
+
+        Chunk->bSeamRefreshPending = false;
+        Chunk->MeshData = MoveTemp(MeshData);
+        Chunk->DensityField = MoveTemp(Density);
+        Renderer->UpdateChunkMesh(Chunk);
+        OnMeshUploaded(Chunk);
         return;
+    }
 
     // Store Data
+    Chunk->bSeamRefreshPending = false;
     Chunk->MeshData = MoveTemp(MeshData);
+    Chunk->DensityField = MoveTemp(Density);
     Chunk->Transform = FMathUtils::ComputeChunkTransform(Id, Config.PlanetRadius);
-    Chunk->State = EChunkState::DataReady;
+    SetChunkState(Chunk, EChunkState::DataReady);
+    UpdateResidentMemory(Chunk);
+}
+
+
+FChunkSeams FChunkManager::ComputeSeams(const FChunkId &Id) const
+{
+    FChunkSeams Seams;
+    if (Id.LODLevel == 0)
+        return Seams;
+
+    const int32 FaceSize = 1 << Id.LODLevel;
+    const FIntPoint EdgeOffsets[FChunkSeams::NumEdges] = {FIntPoint(-1, 0), FIntPoint(1, 0), FIntPoint(0, -1), FIntPoint(0, 1)};
+
+    for (int32 Edge = 0; Edge < FChunkSeams::NumEdges; Edge++)
+    {
+        const FIntPoint Neighbor(Id.Coords.X + EdgeOffsets[Edge].X, Id.Coords.Y + EdgeOffsets[Edge].Y);
+        if (Neighbor.X < 0 || Neighbor.Y < 0 || Neighbor.X >= FaceSize || Neighbor.Y >= FaceSize)
+            continue;  // Across a cube edge: the neighbour grids are not aligned, not stitched
+
+        // Rendered leaves partition the face: a rendered ancestor of the same-LOD neighbour is the coarser leaf covering the edge.
+        // If it is also our own ancestor, we are not shown yet: the neighbour is swapped in with us, at our LOD or finer.
+        FChunkKey Key = FChunkId(Id.FaceIndex, FIntVector(Neighbor.X, Neighbor.Y, 0), Id.LODLevel).GetKey();
+        FChunkKey OwnKey = Id.GetKey();
+        for (int32 Step = 1; Step <= Id.LODLevel; Step++)
+        {
+            Key = Key.GetParent();
+            OwnKey = OwnKey.GetParent();
+            if (Key == OwnKey)
+                break;
+            if (!RenderSet.Contains(FChunkId(Key)))
+                continue;
+
+            // Neighbour cells must be whole multiples of ours. Beyond that, the stitch is only partial
+            int32 Stitch = Step;
+            while (Stitch > 0 && Config.GridResolution % (1 << Stitch) != 0)
+                Stitch--;
+            Seams.CoarserLODs[Edge] = (uint8)Stitch;
+            break;
+        }
+    }
+    return Seams;
+}
+
+
+void FChunkManager::MarkNeighbourSeamsDirty(const FChunkId &Id)
+{
+    const int32 FaceSize = 1 << Id.LODLevel;
+    const FIntPoint EdgeOffsets[FChunkSeams::NumEdges] = {FIntPoint(-1, 0), FIntPoint(1, 0), FIntPoint(0, -1), FIntPoint(0, 1)};
+
+    for (int32 Edge = 0; Edge < FChunkSeams::NumEdges; Edge++)
+    {
+        const FIntPoint Neighbor(Id.Coords.X + EdgeOffsets[Edge].X, Id.Coords.Y + EdgeOffsets[Edge].Y);
+        if (Neighbor.X < 0 || Neighbor.Y < 0 || Neighbor.X >= FaceSize || Neighbor.Y >= FaceSize)
+            continue;  // Across a cube edge, never stitched
+
+        // Covered by a coarser rendered leaf: its seams only depend on leaves coarser than itself, not on Id
+        const FChunkKey NeighborKey = FChunkId(Id.FaceIndex, FIntVector(Neighbor.X, Neighbor.Y, 0), Id.LODLevel).GetKey();
+        bool bCoarserNeighbor = false;
+        for (FChunkKey Key = NeighborKey; Key.GetLOD() > 0 && !bCoarserNeighbor;)
+        {
+            Key = Key.GetParent();
+            bCoarserNeighbor = RenderSet.Contains(FChunkId(Key));
+        }
+        if (bCoarserNeighbor)
+            continue;
+
+        // Otherwise descend to the rendered leaves along the shared side: children on our side of the neighbour only.
+        // Edge 0 (-X) keeps the children with X bit 1, edge 1 (+X) X bit 0, edge 2 (-Y) Y bit 1, edge 3 (+Y) Y bit 0.
+        const int32 AxisBit = Edge < 2 ? 1 : 2;
+        const int32 SideBits = (Edge % 2 == 0) ? AxisBit : 0;
+
+        SeamSearchStack.Reset();
+        SeamSearchStack.Add(FChunkId(NeighborKey));
+        while (SeamSearchStack.Num() > 0)
+        {
+            const FChunkId Node = SeamSearchStack.Pop(EAllowShrinking::No);
+            if (RenderSet.Contains(Node))
+            {
+                SeamDirtyIds.Add(Node);
+                continue;
+            }
+            if (Node.LODLevel >= Config.MaxLOD)
+                continue;
+
+            const FChunkKey Key = Node.GetKey();
+            for (int32 Child = 0; Child < 4; Child++)
+            {
+                if ((Child & AxisBit) == SideBits)
+                    SeamSearchStack.Add(FChunkId(Key.GetChild(Child)));
+            }
+        }
+    }
+}
+
+
+void FChunkManager::RefreshSeams()
+{
+    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetRefreshSeams);
+
+    // Leaves shown since the last check: their own seams and the ones of the finer leaves next to them
+    for (const FChunkId &Id : ShownLeaves)
+    {
+        if (!RenderSet.Contains(Id))
+            continue;  // Already replaced
+        SeamDirtyIds.Add(Id);
+        MarkNeighbourSeamsDirty(Id);
+    }
+    ShownLeaves.Reset();
+
+    if (!ChunkGenerator)
+    {
+        SeamDirtyIds.Reset();
+        return;
+    }
+
+    for (const FChunkId &Id : SeamDirtyIds)
+    {
+        FChunk *Chunk = GetChunk(Id);
+        if (!Chunk || !Chunk->MeshData || Chunk->bSeamRefreshPending)
+            continue;  // Not generated yet (it gets the current seams when requested), or already refreshing
+
+        const FChunkSeams Seams = ComputeSeams(Id);
+        if (Seams == Chunk->MeshData->Seams)
+            continue;
+
+        Chunk->GenerationId++;
+        Chunk->bSeamRefreshPending = true;
+        ChunkGenerator->RequestChunk(Id, Chunk->GenerationId, false, GetParentDensity(Id), Seams);
+    }
+    SeamDirtyIds.Reset();
+}
+
+
+FRetainedDensityPtr FChunkManager::GetParentDensity(const FChunkId &Id) const
+{
+    if (Id.LODLevel == 0)
+        return nullptr;
+
+    const TUniquePtr<FChunk> *Parent = ChunkMap.Find(GetParentId(Id));
+    return Parent ? (*Parent)->DensityField : nullptr;
 }
 
 
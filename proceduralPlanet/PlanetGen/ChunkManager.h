@@ -5,9 +5,18 @@
 #include "DensityGenerator.h"
 #include "ChunkRenderer.h"
 #include "ChunkGenerator.h"
+#include "ChunkKeySet.h"
+#include "ChunkMeshCache.h"
+#include "ChunkCollisionManager.h"
 #include "PlanetQuadtree.h"
 
 
+// Counts the frames in which FChunkManager::Update had to grow its containers. Compiled out of shipping builds.
+#ifndef PLANET_TRACK_UPDATE_ALLOCATIONS
+#define PLANET_TRACK_UPDATE_ALLOCATIONS !UE_BUILD_SHIPPING
+#endif
+
+
 // Chunks hidden after a merge, waiting to be released after a delay
 struct FDeferredRelease
 {
@@ -16,6 +25,56 @@ struct FDeferredRelease
 };
 
 
+// Game-thread mesh upload cost, recorded by AdvanceLoading (used by the debug HUD and for budget tuning).
+struct FMeshUploadStats
+{
+        float LastFrameMs = 0.f;      // Time spent uploading during the last frame
+        float PeakFrameMs = 0.f;      // Worst frame since startup
+        float AverageFrameMs = 0.f;   // Exponential moving average over frames that uploaded something
+        int32 UploadedLastFrame = 0;  // Chunks uploaded during the last frame
+        int32 Backlog = 0;            // DataReady chunks carried over to the next frame
+};
+
+
+// Look-ahead accounting: how chunks were doing the first time the quadtree actually needed them.
+struct FPrefetchStats
+{
+        int32 ReadyInTime = 0;  // Prefetched and already generated
+        int32 Late = 0;         // Prefetched but still generating: the split will pop in late
+        int32 Unpredicted = 0;  // Never prefetched, generated on demand
+        int32 InFlight = 0;     // Size of the current prefetch set
+};
+
+
+// Resident memory of all chunks, checked against the budgets of FPlanetConfig (used by the debug HUD and stat Planet).
+struct FResidentMemoryStats
+{
+        int64 MeshBytes = 0;            // CPU mesh data and retained density of every chunk
+        int64 CacheBytes = 0;           // Released mesh cache
+        int64 GPUBytes = 0;             // Estimated vertex and index buffers of the chunks holding a component
+        int32 Components = 0;           // Chunks holding a render component
+        int32 EvictedChunks = 0;        // Since startup: chunks released early to get back within budget
+        int32 ReleasedMeshData = 0;     // Since startup: meshes whose CPU arrays were dropped after upload
+        bool bOverBudget = false;       // Still over a budget after eviction: only required chunks are left
+        bool bPrefetchSuspended = false;
+
+        int64 GetCPUBytes() const { return MeshBytes + CacheBytes; }
+};
+
+
+// Heap growth of the containers touched by FChunkManager::Update. Once the working set stopped growing
+// (observer hovering, or flying over already-visited terrain at a steady LOD), GrowthFrames must stop increasing.
+// Checked by the Planet.ChunkManager.SteadyStateAllocations automation test. The update also runs under the
+// Planet/ManagerUpdate LLM tag, for the allocations Insights sees that none of these containers account for.
+struct FUpdateAllocationStats
+{
+        int32 GrowthFrames = 0;       // Updates that grew at least one container
+        int64 LastGrowthBytes = 0;    // Size of the most recent growth
+        int64 FootprintBytes = 0;     // Current total allocated size of those containers
+        uint64 FrameCount = 0;
+};
+
+
 // Manages the lifecycle of all chunks (Quadtree logic, LOD selection, Async requests).
 // Owned strictly by the APlanet actor.
 class FChunkManager
@@ -33,9 +92,56 @@ class FChunkManager
         // Returns per-LOD count of currently visible chunks. Array must be pre-sized to MaxLOD+1.
         void GetVisibleCountPerLOD(TArray<int32> &OutCounts) const;
 
+        // Number of chunks in the given state, in total or at one LOD. O(1).
+        int32 GetChunkCount(EChunkState State) const { return ChunksByState[(int32)State].Num(); }
+        int32 GetChunkCount(EChunkState State, int32 LODLevel) const;
+
+        // All chunks currently in the given state. Walk with FChunkStateList::GetNext.
+        const FChunkStateList &GetChunksInState(EChunkState State) const { return ChunksByState[(int32)State]; }
+
         // Returns the number of chunks waiting for generation.
         int32 GetPendingCount() const;
 
+        // Generation tasks this planet may have in flight, its share of the world's budget (see UPlanetSubsystem).
+        void SetGenerationBudget(int32 Budget);
+        int32 GetGenerationBudget() const;
+
+        // Generation tasks currently running.
+        int32 GetActiveGenerationCount() const;
+
+        // True if the observer (planet space) is close enough for the quadtree to be refined and chunks generated.
+        bool IsInGenerationRange(const FVector &ObserverLocation) const;
+
+        // No chunk in memory and no generation queued or running: an update would have nothing to do.
+        bool IsIdle() const { return ChunkMap.Num() == 0 && GetPendingCount() == 0; }
+
+        // Returns per-LOD generation queue depth and wait times. Array must be pre-sized to MaxLOD+1.
+        void GetGenerationQueueStats(TArray<FGenerationQueueStats> &OutStats) const;
+
+        // Disk cache hit/miss counters since startup.
+        void GetDiskCacheStats(int32 &OutHits, int32 &OutMisses) const;
+
+        // Cost of cancelled in-flight generation work since startup.
+        FGenerationCancelStats GetGenerationCancelStats() const;
+
+        // Cache of released chunk meshes, null if disabled.
+        const FChunkMeshCache *GetMeshCache() const { return MeshCache.Get(); }
+
+        // Collision pipeline, null if collision is disabled.
+        const FChunkCollisionManager *GetCollisionManager() const { return Collision.Get(); }
+
+        const FMeshUploadStats &GetUploadStats() const { return UploadStats; }
+
+        const FPrefetchStats &GetPrefetchStats() const { return PrefetchStats; }
+
+        const FResidentMemoryStats &GetMemoryStats() const { return MemoryStats; }
+
+        // Only updated when PLANET_TRACK_UPDATE_ALLOCATIONS is set.
+        const FUpdateAllocationStats &GetUpdateAllocationStats() const { return UpdateAllocationStats; }
+
+        // LOD quadtree, for its update and culling statistics.
+        const FPlanetQuadtree *GetQuadtree() const { return Quadtree.Get(); }
+
         // Initialize the chunk manager for the given planet.
         void Initialize(AActor *Owner, UMaterialInterface *Material);
 
@@ -51,28 +157,79 @@ class FChunkManager
 
     private:
         FPlanetConfig Config;
-        const DensityGenerator *Generator;           // Reference to the density generator (owned by APlanet)
-        TUniquePtr<ChunkRenderer> Renderer;          // Handles visual components
-        TUniquePtr<FChunkGenerator> ChunkGenerator;  // Handles async generation
-        TUniquePtr<FPlanetQuadtree> Quadtree;        // Handles LOD and Culling logic
+        const DensityGenerator *Generator;             // Reference to the density generator (owned by APlanet)
+        TUniquePtr<ChunkRenderer> Renderer;            // Handles visual components
+        TUniquePtr<FChunkGenerator> ChunkGenerator;    // Handles async generation
+        TUniquePtr<FPlanetQuadtree> Quadtree;          // Handles LOD and Culling logic
+        TUniquePtr<FChunkMeshCache> MeshCache;         // Meshes of recently released chunks (optional)
+        TUniquePtr<FChunkCollisionManager> Collision;  // Collision near physics actors (optional)
 
         TMap<FChunkId, TUniquePtr<FChunk>> ChunkMap;        // The central registry of all chunks
         TMap<FChunkId, FLODTransition> PendingTransitions;  // keyed on parent ID
         TSet<FChunkId> RenderSet;                           // ground truth of what is rendered
-        TSet<FChunkId> LoadSet;                             // All chunk IDs that must be kept alive this frame
+        FChunkKeySet LoadSet;                               // All chunk IDs that must be kept alive this frame
         TSet<FChunkId> DeferredReleaseIds;                  // O(1) mirror of DeferredReleaseQueue
         TArray<FDeferredRelease> DeferredReleaseQueue;
 
+        TArray<FChunk *> UploadCandidates;  // Scratch for AdvanceLoading, kept to avoid reallocating every frame
+        TArray<FCollisionRequest> CollisionRequests;  // Scratch for UpdateCollision
+        FMeshUploadStats UploadStats;
+
+        bool bReconcileDirty = true;       // DesiredLeaves, RenderSet or PendingTransitions changed since the last reconciliation
+        bool bWasGeneratingChunks = false;
+
+        FChunkKeySet PrefetchSet;           // Leaves wanted along the predicted path, generated but not uploaded
+        TArray<FVector> PrefetchPositions;  // Scratch: extrapolated observer positions
+        FPrefetchStats PrefetchStats;
+
+        // Scratch lists for the update passes. Reset, never freed, so the steady-state update does not allocate.
+        TArray<FChunkId> ScratchIds;
+        TArray<FChunkId> ScratchDescendants;  // Nested in CommitReadyTransitions while ScratchIds is in use
+
+        TArray<FChunkId> ShownLeaves;      // Added to RenderSet since the last seam check: their neighbours may need new seams
+        TSet<FChunkId> SeamDirtyIds;       // Chunks whose seams must be checked against RenderSet
+        TArray<FChunkId> SeamSearchStack;  // Scratch for MarkNeighbourSeamsDirty
+
+        FUpdateAllocationStats UpdateAllocationStats;
+
+        FResidentMemoryStats MemoryStats;
+        TArray<FChunk *> EvictionCandidates;  // Scratch for EnforceMemoryBudget
+
+        float FrameMaxLatencyMs = 0.f;  // Slowest request -> visible chunk shown during this update (stat Planet)
+
+        // State index, maintained by SetChunkState
+        static constexpr int32 NumChunkStates = (int32)EChunkState::Visible + 1;
+        FChunkStateList ChunksByState[NumChunkStates];
+        TArray<int32> StateCountPerLOD;  // [LODLevel * NumChunkStates + State]
+
+        // Chunks ordered by LastNeededFrame, the most recently needed at the tail. PruneOrphans only walks the stale head.
+        TChunkList<&FChunk::NeededLink> NeededOrder;
+        uint32 UpdateFrame = 0;
+
         // Helper to create a new chunk entry
         FChunk *CreateChunk(const FChunkId &Id);
 
         // Helper to get a chunk from the map if it exists, otherwise create it
         FChunk *GetChunk(const FChunkId &Id);
 
+        // The only place FChunk::State is written: keeps ChunksByState and the per-LOD counters in sync.
+        void SetChunkState(FChunk *Chunk, EChunkState NewState);
+        void AdjustStateCount(const FChunk *Chunk, int32 Delta);
+
+        // Stamps the chunk as needed during this update.
+        void MarkNeeded(FChunk *Chunk);
+
         // Derives LoadSet from RenderSet, PendingTransitions, and desired roots.
         void BuildLoadSet(const TSet<FChunkId> &DesiredLeaves);
 
-        // Safety net: any chunk in ChunkMap not in LoadSet and not in flight gets deferred
+        // Evaluates the quadtree at positions extrapolated along the observer velocity.
+        void BuildPrefetchSet(const FPlanetViewContext &Context);
+
+        // Starts generation of prefetch chunks (after the demanded ones were processed).
+        // While prefetching is suspended, keeps the generated ones and cancels those still in flight.
+        void AdvancePrefetch();
+
+        // Safety net: any chunk not needed this frame (not in LoadSet or PrefetchSet) and not in flight gets released
         void PruneOrphans();
 
         // Explicit initialization of the 6 root chunks directly into RenderSet
@@ -81,8 +238,17 @@ class FChunkManager
         // Quadtree reconciliation, diff desired vs committed, build PendingTransitions
         void ReconcileTransitions(const TSet<FChunkId> &DesiredLeaves);
 
-        // Ensure all needed chunks are generating/uploading
-        void AdvanceLoading();
+        // Edges of a chunk bordering a coarser rendered leaf of the same face.
+        FChunkSeams ComputeSeams(const FChunkId &Id) const;
+
+        // Marks the rendered leaves of the same face bordering Id, at its LOD or finer: the ones whose seams can depend on it.
+        void MarkNeighbourSeamsDirty(const FChunkId &Id);
+
+        // Regenerates the dirty meshes whose seams no longer match their neighbours. The old mesh stays in place until the new one arrives.
+        void RefreshSeams();
+
+        // Ensure all needed chunks are generating/uploading. Uploads are nearest-first within the frame budget.
+        void AdvanceLoading(const FPlanetViewContext &Context);
 
         // Atomic show/hide for complete groups
         void CommitReadyTransitions();
@@ -90,16 +256,44 @@ class FChunkManager
         // Atomic release of deferred chunks
         void ProcessDeferredReleases();
 
+        // Picks the rendered chunks of the finest LODs near a physics actor and hands them to the collision pipeline.
+        void UpdateCollision(const FPlanetViewContext &Context);
+
+        // Removes a chunk from the registry, handing its mesh to MeshCache if there is one and bAllowCache is set.
+        void DestroyChunk(const FChunkId &Id, bool bAllowCache = true);
+
+        // Re-counts the chunk's mesh, density and component into MemoryStats. Called after any of them changed.
+        void UpdateResidentMemory(FChunk *Chunk);
+
+        // Accounts a mesh just handed to the chunk's component, then drops its CPU arrays if nothing else reads them.
+        void OnMeshUploaded(FChunk *Chunk);
+
+        // Evicts chunks outside LoadSet, farthest and coarsest first, until every budget is met again.
+        void EnforceMemoryBudget(const FPlanetViewContext &Context);
+
+        // True if a budget is exceeded, each scaled by Ratio.
+        bool IsOverMemoryBudget(float Ratio) const;
+
+        // Finest LODs of the collision pipeline. Chunks from this LOD on keep their CPU mesh.
+        int32 GetMinCollisionLOD() const;
+
         // Pure math helpers
         static FChunkId GetParentId(const FChunkId &Child);
-        static TArray<FChunkId> GetChildrenIds(const FChunkId &Parent);
+        static TStaticArray<FChunkId, 4> GetChildrenIds(const FChunkId &Parent);
         static bool IsRootNode(const FChunkId &Id);
 
+        // Total allocated size of the containers the update loop writes to.
+        int64 GetUpdateFootprint() const;
+
+
         // Helper to check if a chunk is in memory and has mesh data
         bool IsChunkReady(const FChunkId &Id) const;
 
         // Callback executed on Game Thread when async generation finishes
-        void OnGenerationComplete(const FChunkId &Id, uint32 GenId, TUniquePtr<FChunkMeshData> MeshData);
+        void OnGenerationComplete(const FChunkId &Id, uint32 GenId, TUniquePtr<FChunkMeshData> MeshData, FRetainedDensityPtr Density);
+
+        // Retained density of the chunk's parent, to seed its generation with. Null for roots or if none is kept.
+        FRetainedDensityPtr GetParentDensity(const FChunkId &Id) const;
 
         void DebugRootNodes();
 };
\ No newline at end of file
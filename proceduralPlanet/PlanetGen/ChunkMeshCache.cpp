@@ -0,0 +1,86 @@
+#include "ChunkMeshCache.h"
+#include "ChunkMeshComponent.h"
+
+
+FChunkMeshCache::FChunkMeshCache(int64 InMaxSizeBytes) :
+    MaxSizeBytes(InMaxSizeBytes)
+{
+}
+
+
+void FChunkMeshCache::Add(const FChunkId &Id, TUniquePtr<FChunkMeshData> MeshData)
+{
+    if (!MeshData)
+        return;
+
+    const int64 SizeBytes = GetMeshDataSize(*MeshData);
+    if (SizeBytes > MaxSizeBytes)
+        return;  // Would flush the whole cache for a single entry
+
+    // Replace any older copy of the same chunk
+    Remove(Id);
+
+    while (TotalSizeBytes + SizeBytes > MaxSizeBytes && LRU.GetTail())
+    {
+        Remove(LRU.GetTail()->GetValue());
+    }
+
+    LRU.AddHead(Id);
+
+    FCacheEntry &Entry = Entries.Add(Id);
+    Entry.MeshData = MoveTemp(MeshData);
+    Entry.SizeBytes = SizeBytes;
+    Entry.LRUNode = LRU.GetHead();
+    TotalSizeBytes += SizeBytes;
+}
+
+
+TUniquePtr<FChunkMeshData> FChunkMeshCache::Take(const FChunkId &Id)
+{
+    FCacheEntry *Entry = Entries.Find(Id);
+    if (!Entry)
+    {
+        Misses++;
+        return nullptr;
+    }
+
+    Hits++;
+    TUniquePtr<FChunkMeshData> MeshData = MoveTemp(Entry->MeshData);
+    Remove(Id);
+    return MeshData;
+}
+
+
+void FChunkMeshCache::Empty()
+{
+    Entries.Empty();
+    LRU.Empty();
+    TotalSizeBytes = 0;
+}
+
+
+void FChunkMeshCache::Trim(int64 MaxBytes)
+{
+    while (TotalSizeBytes > MaxBytes && LRU.GetTail())
+    {
+        Remove(LRU.GetTail()->GetValue());
+    }
+}
+
+
+int64 FChunkMeshCache::GetMeshDataSize(const FChunkMeshData &MeshData)
+{
+    return sizeof(FChunkMeshData) + MeshData.Positions.GetAllocatedSize() + MeshData.SeamPositions.GetAllocatedSize() + MeshData.Triangles.GetAllocatedSize() +
+           MeshData.Normals.GetAllocatedSize() + MeshData.Colors.GetAllocatedSize() + (MeshData.Packed.IsValid() ? MeshData.Packed->GetAllocatedSize() : 0);
+}
+
+
+void FChunkMeshCache::Remove(const FChunkId &Id)
+{
+    if (FCacheEntry *Entry = Entries.Find(Id))
+    {
+        TotalSizeBytes -= Entry->SizeBytes;
+        LRU.RemoveNode(Entry->LRUNode);
+        Entries.Remove(Id);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/List.h"
+#include "DataTypes.h"
+
+
+// Memory-budgeted LRU of mesh data from recently released chunks.
+// Lets a chunk that comes back (merge/split oscillation, circling a landmark) skip generation entirely.
+// Game thread only.
+class FChunkMeshCache
+{
+    public:
+        explicit FChunkMeshCache(int64 InMaxSizeBytes);
+
+        // Takes ownership of a released chunk's mesh. Evicts the least recently released entries to stay within budget.
+        void Add(const FChunkId &Id, TUniquePtr<FChunkMeshData> MeshData);
+
+        // Moves the cached mesh back out (the entry is removed). Null on a miss.
+        TUniquePtr<FChunkMeshData> Take(const FChunkId &Id);
+
+        void Empty();
+
+        // Evicts the least recently released entries until the cache holds at most MaxBytes.
+        void Trim(int64 MaxBytes);
+
+        int32 Num() const { return Entries.Num(); }
+        int64 GetSizeBytes() const { return TotalSizeBytes; }
+        int32 GetHitCount() const { return Hits; }
+        int32 GetMissCount() const { return Misses; }
+
+        // Heap footprint of a mesh, used for the budget.
+        static int64 GetMeshDataSize(const FChunkMeshData &MeshData);
+
+    private:
+        using FLRUList = TDoubleLinkedList<FChunkId>;
+
+        struct FCacheEntry
+        {
+                TUniquePtr<FChunkMeshData> MeshData;
+                int64 SizeBytes = 0;
+                FLRUList::TDoubleLinkedListNode *LRUNode = nullptr;
+        };
+
+        int64 MaxSizeBytes;
+        int64 TotalSizeBytes = 0;
+
+        TMap<FChunkId, FCacheEntry> Entries;
+        FLRUList LRU;  // Head = most recently added, tail = next to evict
+
+        int32 Hits = 0;
+        int32 Misses = 0;
+
+        void Remove(const FChunkId &Id);
+};
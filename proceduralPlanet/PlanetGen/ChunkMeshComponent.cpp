@@ -0,0 +1,219 @@
+#include "ChunkMeshComponent.h"
+#include "Engine/Engine.h"
+#include "LocalVertexFactory.h"
+#include "Materials/Material.h"
+#include "PrimitiveSceneProxy.h"
+#include "RawIndexBuffer.h"
+#include "SceneManagement.h"
+#include "StaticMeshResources.h"
+
+
+// ---------------------------------------------------------------------------
+// Packed mesh
+// ---------------------------------------------------------------------------
+int64 FChunkPackedMesh::GetAllocatedSize() const
+{
+    return sizeof(FChunkPackedMesh) + Positions.GetAllocatedSize() + Tangents.GetAllocatedSize() + Colors.GetAllocatedSize() + Indices.GetAllocatedSize();
+}
+
+
+TSharedPtr<FChunkPackedMesh, ESPMode::ThreadSafe> FChunkPackedMesh::Build(const FChunkMeshData &MeshData)
+{
+    TSharedPtr<FChunkPackedMesh, ESPMode::ThreadSafe> Packed = MakeShared<FChunkPackedMesh, ESPMode::ThreadSafe>();
+
+    // FLocalVertexFactory reads float positions: the quantized ones are expanded here, on the worker
+    const int32 NumVertices = MeshData.GetNumVertices();
+    Packed->Positions.SetNumUninitialized(NumVertices);
+    Packed->Tangents.SetNumUninitialized(NumVertices * 2);
+    Packed->LocalBounds = MeshData.GetLocalBounds();
+
+    for (int32 i = 0; i < NumVertices; i++)
+    {
+        Packed->Positions[i] = MeshData.GetPosition(i);
+
+        // The material does not use tangents, any vector orthogonal to the normal works
+        const FVector3f Normal = MeshData.GetNormal(i);
+        const FVector3f Helper = FMath::Abs(Normal.Z) < 0.999f ? FVector3f::UpVector : FVector3f::ForwardVector;
+        const FVector3f TangentX = FVector3f::CrossProduct(Helper, Normal).GetSafeNormal();
+
+        Packed->Tangents[i * 2] = FPackedNormal(TangentX);
+        Packed->Tangents[i * 2 + 1] = FPackedNormal(FVector4f(Normal, 1.0f));  // W = binormal sign
+    }
+
+    // Without debug colours the proxy binds the engine's default white colour stream instead of a buffer of its own
+    if (MeshData.Colors.Num() == NumVertices)
+        Packed->Colors = MeshData.Colors;
+
+    Packed->Indices.SetNumUninitialized(MeshData.Triangles.Num());
+    FMemory::Memcpy(Packed->Indices.GetData(), MeshData.Triangles.GetData(), MeshData.Triangles.Num() * sizeof(uint32));
+
+    return Packed;
+}
+
+
+// ---------------------------------------------------------------------------
+// Scene proxy
+// ---------------------------------------------------------------------------
+class FChunkMeshSceneProxy final : public FPrimitiveSceneProxy
+{
+    public:
+        FChunkMeshSceneProxy(UChunkMeshComponent *Component, const FChunkPackedMesh &Mesh) :
+            FPrimitiveSceneProxy(Component),
+            VertexFactory(GetScene().GetFeatureLevel(), "FChunkMeshSceneProxy"),
+            MaterialRelevance(Component->GetMaterialRelevance(GetScene().GetFeatureLevel()))
+        {
+            Material = Component->GetMaterial(0);
+            if (!Material)
+            {
+                Material = UMaterial::GetDefaultMaterial(MD_Surface);
+            }
+
+            NumVertices = Mesh.GetNumVertices();
+            NumPrimitives = Mesh.Indices.Num() / 3;
+
+            // CPU staging copies (plain memcpy of the packed worker data), freed again once uploaded
+            VertexBuffers.PositionVertexBuffer.Init(Mesh.Positions, false);
+
+            VertexBuffers.StaticMeshVertexBuffer.Init(NumVertices, 1, false);
+            check(!VertexBuffers.StaticMeshVertexBuffer.GetUseHighPrecisionTangentBasis());
+            FMemory::Memcpy(VertexBuffers.StaticMeshVertexBuffer.GetTangentData(), Mesh.Tangents.GetData(), Mesh.Tangents.Num() * sizeof(FPackedNormal));
+            FMemory::Memzero(VertexBuffers.StaticMeshVertexBuffer.GetTexCoordData(), VertexBuffers.StaticMeshVertexBuffer.GetTexCoordSize());
+
+            if (Mesh.Colors.Num() > 0)
+                VertexBuffers.ColorVertexBuffer.InitFromColorArray(Mesh.Colors, false);
+
+            IndexBuffer.SetIndices(Mesh.Indices, EIndexBufferStride::AutoDetect);
+
+            BeginInitResource(&VertexBuffers.PositionVertexBuffer);
+            BeginInitResource(&VertexBuffers.StaticMeshVertexBuffer);
+            BeginInitResource(&VertexBuffers.ColorVertexBuffer);
+            BeginInitResource(&IndexBuffer);
+
+            // The vertex factory binds the RHI buffers above, so it is initialized after them on the render thread
+            ENQUEUE_RENDER_COMMAND(InitChunkMeshVertexFactory)(
+                [this](FRHICommandListImmediate &RHICmdList)
+                {
+                    FLocalVertexFactory::FDataType Data;
+                    VertexBuffers.PositionVertexBuffer.BindPositionVertexBuffer(&VertexFactory, Data);
+                    VertexBuffers.StaticMeshVertexBuffer.BindTangentVertexBuffer(&VertexFactory, Data);
+                    VertexBuffers.StaticMeshVertexBuffer.BindPackedTexCoordVertexBuffer(&VertexFactory, Data);
+                    VertexBuffers.StaticMeshVertexBuffer.BindLightMapVertexBuffer(&VertexFactory, Data, 0);
+                    VertexBuffers.ColorVertexBuffer.BindColorVertexBuffer(&VertexFactory, Data);
+                    VertexFactory.SetData(Data);
+                    VertexFactory.InitResource();
+                });
+        }
+
+        virtual ~FChunkMeshSceneProxy()
+        {
+            // Render thread
+            VertexBuffers.PositionVertexBuffer.ReleaseResource();
+            VertexBuffers.StaticMeshVertexBuffer.ReleaseResource();
+            VertexBuffers.ColorVertexBuffer.ReleaseResource();
+            IndexBuffer.ReleaseResource();
+            VertexFactory.ReleaseResource();
+        }
+
+        virtual SIZE_T GetTypeHash() const override
+        {
+            static size_t UniquePointer;
+            return reinterpret_cast<size_t>(&UniquePointer);
+        }
+
+        // Chunk geometry never changes while the proxy exists: one cached static mesh batch
+        virtual void DrawStaticElements(FStaticPrimitiveDrawInterface *PDI) override
+        {
+            FMeshBatch Mesh;
+            Mesh.VertexFactory = &VertexFactory;
+            Mesh.MaterialRenderProxy = Material->GetRenderProxy();
+            Mesh.Type = PT_TriangleList;
+            Mesh.DepthPriorityGroup = SDPG_World;
+            Mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+            Mesh.CastShadow = CastsDynamicShadow();
+            Mesh.LODIndex = 0;
+
+            FMeshBatchElement &Element = Mesh.Elements[0];
+            Element.IndexBuffer = &IndexBuffer;
+            Element.FirstIndex = 0;
+            Element.NumPrimitives = NumPrimitives;
+            Element.MinVertexIndex = 0;
+            Element.MaxVertexIndex = NumVertices - 1;
+
+            PDI->DrawMesh(Mesh, FLT_MAX);
+        }
+
+        virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView *View) const override
+        {
+            FPrimitiveViewRelevance Result;
+            Result.bDrawRelevance = IsShown(View);
+            Result.bShadowRelevance = IsShadowCast(View);
+            Result.bStaticRelevance = true;
+            Result.bRenderInMainPass = ShouldRenderInMainPass();
+            Result.bUsesLightingChannels = GetLightingChannelMask() != GetDefaultLightingChannelMask();
+            Result.bRenderCustomDepth = ShouldRenderCustomDepth();
+            MaterialRelevance.SetPrimitiveViewRelevance(Result);
+            return Result;
+        }
+
+        virtual bool CanBeOccluded() const override { return !MaterialRelevance.bDisableDepthTest; }
+
+        virtual uint32 GetMemoryFootprint() const override { return sizeof(*this) + GetAllocatedSize(); }
+
+    private:
+        UMaterialInterface *Material = nullptr;
+        FStaticMeshVertexBuffers VertexBuffers;
+        FRawStaticIndexBuffer IndexBuffer;
+        FLocalVertexFactory VertexFactory;
+        FMaterialRelevance MaterialRelevance;
+        int32 NumVertices = 0;
+        int32 NumPrimitives = 0;
+};
+
+
+// ---------------------------------------------------------------------------
+// Component
+// ---------------------------------------------------------------------------
+UChunkMeshComponent::UChunkMeshComponent(const FObjectInitializer &ObjectInitializer) :
+    Super(ObjectInitializer)
+{
+    PrimaryComponentTick.bCanEverTick = false;
+    SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
+
+
+void UChunkMeshComponent::SetMesh(TSharedPtr<const FChunkPackedMesh, ESPMode::ThreadSafe> InMesh)
+{
+    Mesh = MoveTemp(InMesh);
+    UpdateBounds();
+    MarkRenderStateDirty();  // Recreates the proxy with the new buffers
+}
+
+
+void UChunkMeshComponent::ClearMesh()
+{
+    Mesh.Reset();
+    UpdateBounds();
+    MarkRenderStateDirty();
+}
+
+
+FPrimitiveSceneProxy *UChunkMeshComponent::CreateSceneProxy()
+{
+    if (!HasMesh())
+    {
+        return nullptr;
+    }
+
+    return new FChunkMeshSceneProxy(this, *Mesh);
+}
+
+
+FBoxSphereBounds UChunkMeshComponent::CalcBounds(const FTransform &LocalToWorld) const
+{
+    if (!Mesh.IsValid() || !Mesh->LocalBounds.IsValid)
+    {
+        return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.f);
+    }
+
+    return FBoxSphereBounds(Mesh->LocalBounds).TransformBy(LocalToWorld);
+}
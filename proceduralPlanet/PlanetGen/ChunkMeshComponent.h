@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/MeshComponent.h"
+#include "PackedNormal.h"
+#include "DataTypes.h"
+#include "ChunkMeshComponent.generated.h"
+
+
+// GPU-ready layout of a chunk mesh. Built once on a generation worker from FChunkMeshData,
+// then only memcpy'd into the render buffers: no per-vertex work is left for the game thread.
+struct FChunkPackedMesh
+{
+        TArray<FVector3f> Positions;
+        TArray<FPackedNormal> Tangents;  // 2 per vertex (TangentX, TangentZ), same layout as the default FStaticMeshVertexBuffer
+        TArray<FColor> Colors;           // Empty without debug colours
+        TArray<uint32> Indices;          // Stored 16-bit on the GPU when the vertex count allows it
+        FBox LocalBounds = FBox(ForceInit);
+
+        int32 GetNumVertices() const { return Positions.Num(); }
+        int64 GetAllocatedSize() const;
+
+        // Packs the welded mesh. Thread-safe.
+        static TSharedPtr<FChunkPackedMesh, ESPMode::ThreadSafe> Build(const FChunkMeshData &MeshData);
+};
+
+
+// Lightweight static mesh component for chunk geometry.
+// Its scene proxy renders FChunkPackedMesh through FLocalVertexFactory with packed normals and cached static draw commands,
+// instead of UProceduralMeshComponent's per-section FProcMeshVertex conversion on the game thread.
+UCLASS(ClassGroup = Rendering)
+class PROCEDURALPLANET_API UChunkMeshComponent : public UMeshComponent
+{
+        GENERATED_BODY()
+
+    public:
+        UChunkMeshComponent(const FObjectInitializer &ObjectInitializer);
+
+        // Replaces the rendered mesh. The packed data is shared, not copied, until the proxy uploads it.
+        void SetMesh(TSharedPtr<const FChunkPackedMesh, ESPMode::ThreadSafe> InMesh);
+
+        void ClearMesh();
+
+        bool HasMesh() const { return Mesh.IsValid() && Mesh->Indices.Num() > 0; }
+
+        //~ Begin UPrimitiveComponent Interface
+        virtual FPrimitiveSceneProxy *CreateSceneProxy() override;
+        virtual int32 GetNumMaterials() const override { return 1; }
+        //~ End UPrimitiveComponent Interface
+
+        //~ Begin USceneComponent Interface
+        virtual FBoxSphereBounds CalcBounds(const FTransform &LocalToWorld) const override;
+        //~ End USceneComponent Interface
+
+    private:
+        TSharedPtr<const FChunkPackedMesh, ESPMode::ThreadSafe> Mesh;
+};
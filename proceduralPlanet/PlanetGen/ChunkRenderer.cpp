@@ -1,10 +1,28 @@
 #include "ChunkRenderer.h"
+#include "PlanetStats.h"
 #include "Engine/Engine.h"  // For GIsRequestingExit
 
 
-ChunkRenderer::ChunkRenderer(AActor *InOwner, UMaterialInterface *InMaterial) :
+// The procedural mesh takes plain float arrays: the compact mesh data is expanded for the call
+static void CreateProcMeshSection(UProceduralMeshComponent *ProcComp, const FChunkMeshData &MeshData)
+{
+    TArray<FVector> Vertices;
+    FChunkMeshData::DecodePositions(MeshData.Positions, MeshData.SeamPositions, MeshData.QuantizationMin, MeshData.QuantizationSize, Vertices);
+
+    TArray<FVector> Normals;
+    Normals.SetNumUninitialized(MeshData.GetNumVertices());
+    for (int32 i = 0; i < Normals.Num(); i++)
+        Normals[i] = FVector(MeshData.GetNormal(i));
+
+    ProcComp->CreateMeshSection(0, Vertices, MeshData.Triangles, Normals, TArray<FVector2D>(), MeshData.Colors, TArray<FProcMeshTangent>(), false);
+}
+
+
+ChunkRenderer::ChunkRenderer(AActor *InOwner, UMaterialInterface *InMaterial, EChunkRenderBackend InBackend, bool bInCastShadows) :
     OwnerActor(InOwner),
-    Material(InMaterial)
+    Material(InMaterial),
+    Backend(InBackend),
+    bCastShadows(bInCastShadows)
 {
 }
 
@@ -21,17 +39,17 @@ ChunkRenderer::~ChunkRenderer()
 }
 
 
-UProceduralMeshComponent *ChunkRenderer::GetFreeComponent()
+UMeshComponent *ChunkRenderer::GetFreeComponent()
 {
     // FIX: Loop until we find a valid live component or empty the pool.
     // Components in the pool might have been GC'd or destroyed by the engine.
     while (FreeComponentPool.Num() > 0)
     {
         // Pop the weak pointer
-        TWeakObjectPtr<UProceduralMeshComponent> WeakComp = FreeComponentPool.Pop();
+        TWeakObjectPtr<UMeshComponent> WeakComp = FreeComponentPool.Pop();
 
         // .Get() returns nullptr if the object is stale/dead. Safe!
-        if (UProceduralMeshComponent *Comp = WeakComp.Get())
+        if (UMeshComponent *Comp = WeakComp.Get())
         {
             Comp->SetRelativeTransform(FTransform::Identity);
             return Comp;
@@ -41,10 +59,21 @@ UProceduralMeshComponent *ChunkRenderer::GetFreeComponent()
     // Create new component if pool is empty
     if (OwnerActor)
     {
-        UProceduralMeshComponent *NewComp = NewObject<UProceduralMeshComponent>(OwnerActor);
+        UMeshComponent *NewComp = nullptr;
+        if (Backend == EChunkRenderBackend::PackedVertexFactory)
+        {
+            NewComp = NewObject<UChunkMeshComponent>(OwnerActor);
+        }
+        else
+        {
+            UProceduralMeshComponent *ProcComp = NewObject<UProceduralMeshComponent>(OwnerActor);
+            ProcComp->bUseAsyncCooking = true;  // Important for performance
+            NewComp = ProcComp;
+        }
+
+        NewComp->SetCastShadow(bCastShadows);  // Both backends' proxies follow the component flag
         NewComp->RegisterComponent();
         NewComp->AttachToComponent(OwnerActor->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
-        NewComp->bUseAsyncCooking = true;         // Important for performance
         NewComp->SetComponentTickEnabled(false);  // Critical: Disable ticking to save performance
         NewComp->SetVisibility(false);            // always start hidden
 
@@ -55,43 +84,40 @@ UProceduralMeshComponent *ChunkRenderer::GetFreeComponent()
 }
 
 
-void ChunkRenderer::PrepareChunk(FChunk *Chunk, bool bEnableCollision = false)
+void ChunkRenderer::PrepareChunk(FChunk *Chunk)
 {
+    PLANET_SCOPE_CYCLE_COUNTER(STAT_PlanetPrepareChunk);
+
     if (!Chunk || !Chunk->MeshData)
     {
         return;
     }
 
-    UProceduralMeshComponent *Comp = GetFreeComponent();
+    UMeshComponent *Comp = GetFreeComponent();
     if (!Comp)
     {
         return;
     }
 
-    // Configure Collision Settings BEFORE creating the mesh
-    // This ensures that when CreateMeshSection triggers collision cooking, it uses the correct flags.
-    if (bEnableCollision)
+    if (UChunkMeshComponent *ChunkComp = Cast<UChunkMeshComponent>(Comp))
     {
-        Comp->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-        Comp->SetCollisionProfileName(TEXT("BlockAll"));
-        Comp->bUseComplexAsSimpleCollision = true;  // Critical for Trimesh collision
-        Comp->bUseAsyncCooking = true;
-        // Comp->UpdateCollision(); // explicit, controlled call
+        // Packed buffers normally come from the worker. Meshes from older caches may still need packing.
+        if (!Chunk->MeshData->Packed.IsValid())
+        {
+            Chunk->MeshData->Packed = FChunkPackedMesh::Build(*Chunk->MeshData);
+        }
+
+        // Upload Mesh Data: hands the shared buffers to the next scene proxy, no per-vertex work here
+        ChunkComp->SetMesh(Chunk->MeshData->Packed);
     }
-    else
+    else if (UProceduralMeshComponent *ProcComp = Cast<UProceduralMeshComponent>(Comp))
     {
-        Comp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-    }
+        // Visual only: collision is cooked separately, from a decimated mesh, for the chunks near physics actors
+        ProcComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
-    // Upload Mesh Data
-    Comp->CreateMeshSection(0,
-                            Chunk->MeshData->Vertices,
-                            Chunk->MeshData->Triangles,
-                            Chunk->MeshData->Normals,
-                            Chunk->MeshData->UV0,
-                            Chunk->MeshData->Colors,
-                            TArray<FProcMeshTangent>(),
-                            false);
+        // Upload Mesh Data
+        CreateProcMeshSection(ProcComp, *Chunk->MeshData);
+    }
 
     // Apply Material
     Comp->SetMaterial(0, Material);
@@ -107,12 +133,35 @@ void ChunkRenderer::PrepareChunk(FChunk *Chunk, bool bEnableCollision = false)
 }
 
 
+void ChunkRenderer::UpdateChunkMesh(FChunk *Chunk)
+{
+    UMeshComponent *Comp = Chunk ? Chunk->RenderProxy.Get() : nullptr;
+    if (!Comp || !Chunk->MeshData)
+    {
+        return;
+    }
+
+    if (UChunkMeshComponent *ChunkComp = Cast<UChunkMeshComponent>(Comp))
+    {
+        if (!Chunk->MeshData->Packed.IsValid())
+        {
+            Chunk->MeshData->Packed = FChunkPackedMesh::Build(*Chunk->MeshData);
+        }
+        ChunkComp->SetMesh(Chunk->MeshData->Packed);
+    }
+    else if (UProceduralMeshComponent *ProcComp = Cast<UProceduralMeshComponent>(Comp))
+    {
+        CreateProcMeshSection(ProcComp, *Chunk->MeshData);
+    }
+}
+
+
 void ChunkRenderer::ShowChunk(FChunk *Chunk)
 {
     if (!Chunk)
         return;
 
-    if (UProceduralMeshComponent *Comp = Chunk->RenderProxy.Get())
+    if (UMeshComponent *Comp = Chunk->RenderProxy.Get())
     {
         Comp->SetVisibility(true);
     }
@@ -124,13 +173,13 @@ void ChunkRenderer::HideChunk(FChunk *Chunk)
     if (!Chunk)
         return;
 
-    if (UProceduralMeshComponent *Comp = Chunk->RenderProxy.Get())
+    if (UMeshComponent *Comp = Chunk->RenderProxy.Get())
     {
         Comp->SetVisibility(false);
     }
 }
 
-void ChunkRenderer::DiscardComponent(UProceduralMeshComponent *Comp)
+void ChunkRenderer::DiscardComponent(UMeshComponent *Comp)
 {
     if (IsValid(Comp) && !GIsRequestingExit)
     {
@@ -150,7 +199,7 @@ void ChunkRenderer::ReleaseChunk(FChunk *Chunk)
     if (!Chunk)
         return;
 
-    if (UProceduralMeshComponent *Comp = Chunk->RenderProxy.Get())
+    if (UMeshComponent *Comp = Chunk->RenderProxy.Get())
     {
         if (IsValid(Comp))
         {
@@ -160,7 +209,10 @@ void ChunkRenderer::ReleaseChunk(FChunk *Chunk)
             // Doing this during exit can crash physics/cooking threads.
             if (!GIsRequestingExit && !Comp->IsPendingKill())
             {
-                Comp->ClearAllMeshSections();
+                if (UChunkMeshComponent *ChunkComp = Cast<UChunkMeshComponent>(Comp))
+                    ChunkComp->ClearMesh();
+                else if (UProceduralMeshComponent *ProcComp = Cast<UProceduralMeshComponent>(Comp))
+                    ProcComp->ClearAllMeshSections();
             }
 
             Comp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
@@ -181,7 +233,7 @@ void ChunkRenderer::ReleaseAllComponents()
         // FIX: Resolve the weak pointer safely.
         // If the component was already destroyed (stale), .Get() returns null and we skip the body.
         // This completely prevents the Segfault at address 0x0.
-        if (UProceduralMeshComponent *Comp = WeakComp.Get())
+        if (UMeshComponent *Comp = WeakComp.Get())
         {
             if (!GIsRequestingExit && !Comp->IsBeingDestroyed())
             {
@@ -2,20 +2,25 @@
 
 #include "CoreMinimal.h"
 #include "ProceduralMeshComponent.h"
+#include "ChunkMeshComponent.h"
 #include "Chunk.h"
 #include "Materials/MaterialInterface.h"
 
 
-// Handles the visual representation of chunks using a pool of ProceduralMeshComponents.
+// Handles the visual representation of chunks using a pool of mesh components.
+// The backend decides the component type: UChunkMeshComponent (packed buffers) or UProceduralMeshComponent (fallback).
 class ChunkRenderer
 {
     public:
-        ChunkRenderer(AActor *InOwner, UMaterialInterface *InMaterial);
+        ChunkRenderer(AActor *InOwner, UMaterialInterface *InMaterial, EChunkRenderBackend InBackend, bool bInCastShadows);
         ~ChunkRenderer();
 
         // Upload mesh data to a component and assigns it to the chunk.
-        // Component starts hidden. State becomes MeshReady (caller's responsibility).
-        void PrepareChunk(FChunk *Chunk, bool bEnableCollision);
+        // Component starts hidden and never collides (see FChunkCollisionManager). State becomes MeshReady (caller's responsibility).
+        void PrepareChunk(FChunk *Chunk);
+
+        // Replaces the mesh of an already prepared chunk in place. Visibility and state are unchanged.
+        void UpdateChunkMesh(FChunk *Chunk);
 
         // Make the chunk's component visible.
         // Chunk must be in MeshReady state. State becomes Visible (caller's responsibility).
@@ -26,7 +31,7 @@ class ChunkRenderer
         void HideChunk(FChunk *Chunk);
 
         // Unregister and destroy the given component.
-        void DiscardComponent(UProceduralMeshComponent* Comp);
+        void DiscardComponent(UMeshComponent *Comp);
 
         // Returns the component to the pool and clears the mesh.
         // Called only when a chunk is being permanently destroyed.
@@ -37,12 +42,16 @@ class ChunkRenderer
 
         AActor *GetOwner() const { return OwnerActor; }
 
+        EChunkRenderBackend GetBackend() const { return Backend; }
+
     private:
         AActor *OwnerActor;
         UMaterialInterface *Material;
+        EChunkRenderBackend Backend;
+        bool bCastShadows;
 
-        // Pool of inactive components ready for reuse
-        TArray<TWeakObjectPtr<UProceduralMeshComponent>> FreeComponentPool;
+        // Pool of inactive components ready for reuse (all of the backend's component type)
+        TArray<TWeakObjectPtr<UMeshComponent>> FreeComponentPool;
 
-        UProceduralMeshComponent *GetFreeComponent();
+        UMeshComponent *GetFreeComponent();
 };
\ No newline at end of file
@@ -1,10 +1,17 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
 #include "ProceduralMeshComponent.h"
 #include "DataTypes.generated.h"
 
 
+// Per-vertex LOD tint written by the mesher. Only development builds pay for the colour stream.
+#ifndef PLANET_WITH_DEBUG_COLORS
+#define PLANET_WITH_DEBUG_COLORS !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+#endif
+
+
 // The state of a chunk in its lifecycle
 UENUM(BlueprintType)
 enum class EChunkState : uint8
@@ -18,6 +25,33 @@ enum class EChunkState : uint8
 };
 
 
+// How MeshGenerator computes vertex normals
+UENUM(BlueprintType)
+enum class EChunkNormalMode : uint8
+{
+    AnalyticGradient,  // One value+derivative noise evaluation per vertex. Exact.
+    DensityGrid        // Central differences over the already-sampled density field. No noise evaluation, slightly blurrier.
+};
+
+
+// Which component type ChunkRenderer uploads chunk meshes to
+UENUM(BlueprintType)
+enum class EChunkRenderBackend : uint8
+{
+    PackedVertexFactory,  // UChunkMeshComponent: packed buffers built on the worker, static draw path
+    ProceduralMesh        // UProceduralMeshComponent: fallback, required for chunk collision
+};
+
+
+// Where FChunkGenerator evaluates chunk density fields. Meshing always stays on the CPU.
+UENUM(BlueprintType)
+enum class EChunkDensityBackend : uint8
+{
+    CPU,        // DensityGenerator on the task workers. The reference output
+    GPUCompute  // Compute shader of the proceduralPlanetCompute module, CPU fallback if it is not loaded or the RHI can't run it
+};
+
+
 enum class ELeafTransitionType : uint8
 {
     Split,
@@ -25,6 +59,78 @@ enum class ELeafTransitionType : uint8
 };
 
 
+// 64-bit packed chunk identifier: face (3 bits) | LOD (5 bits) | Morton-interleaved X/Y (56 bits, X on the even bits).
+// Sorting keys groups chunks by face, then LOD, then along a Z-order curve. Parent and children are pure bit operations.
+struct FChunkKey
+{
+        static constexpr int32 MaxLOD = 28;  // 28 bits per axis
+        static constexpr int32 FaceShift = 61;
+        static constexpr int32 LODShift = 56;
+        static constexpr uint64 MortonMask = (1ull << LODShift) - 1;
+
+        uint64 Value = 0;
+
+        FChunkKey() = default;
+
+        explicit FChunkKey(uint64 InValue) :
+            Value(InValue)
+        {
+        }
+
+        FChunkKey(uint8 Face, int32 X, int32 Y, int32 LOD) :
+            Value(Pack(Face, LOD, SpreadBits((uint32)X) | (SpreadBits((uint32)Y) << 1)))
+        {
+            // Out-of-range fields would spill into the neighbouring bit fields and alias another chunk's key
+            check(Face < 6 && LOD >= 0 && LOD <= MaxLOD);
+            check(X >= 0 && Y >= 0 && X < (1 << LOD) && Y < (1 << LOD));
+        }
+
+        uint8 GetFace() const { return (uint8)(Value >> FaceShift); }
+        int32 GetLOD() const { return (int32)((Value >> LODShift) & 31); }
+        uint64 GetMorton() const { return Value & MortonMask; }
+        int32 GetX() const { return (int32)CompactBits(GetMorton()); }
+        int32 GetY() const { return (int32)CompactBits(GetMorton() >> 1); }
+
+        // LOD must be > 0
+        FChunkKey GetParent() const { return FChunkKey(Pack(GetFace(), GetLOD() - 1, GetMorton() >> 2)); }
+
+        // Index bit 0 = X offset, bit 1 = Y offset
+        FChunkKey GetChild(int32 Index) const { return FChunkKey(Pack(GetFace(), GetLOD() + 1, (GetMorton() << 2) | (uint64)Index)); }
+
+        bool operator==(const FChunkKey &Other) const { return Value == Other.Value; }
+        bool operator!=(const FChunkKey &Other) const { return Value != Other.Value; }
+        bool operator<(const FChunkKey &Other) const { return Value < Other.Value; }
+
+        friend uint32 GetTypeHash(const FChunkKey &Key) { return GetTypeHash(Key.Value); }
+
+        static uint64 Pack(uint8 Face, int32 LOD, uint64 Morton) { return ((uint64)Face << FaceShift) | ((uint64)LOD << LODShift) | Morton; }
+
+        // Moves the low 32 bits of V to the even bit positions
+        static uint64 SpreadBits(uint32 V)
+        {
+            uint64 X = V;
+            X = (X | (X << 16)) & 0x0000FFFF0000FFFFull;
+            X = (X | (X << 8)) & 0x00FF00FF00FF00FFull;
+            X = (X | (X << 4)) & 0x0F0F0F0F0F0F0F0Full;
+            X = (X | (X << 2)) & 0x3333333333333333ull;
+            X = (X | (X << 1)) & 0x5555555555555555ull;
+            return X;
+        }
+
+        // Inverse of SpreadBits: gathers the even bits of V
+        static uint32 CompactBits(uint64 V)
+        {
+            uint64 X = V & 0x5555555555555555ull;
+            X = (X | (X >> 1)) & 0x3333333333333333ull;
+            X = (X | (X >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+            X = (X | (X >> 4)) & 0x00FF00FF00FF00FFull;
+            X = (X | (X >> 8)) & 0x0000FFFF0000FFFFull;
+            X = (X | (X >> 16)) & 0x00000000FFFFFFFFull;
+            return (uint32)X;
+        }
+};
+
+
 // Unique identifier for a Chunk on the CubeSphere
 USTRUCT(BlueprintType)
 struct FChunkId
@@ -48,43 +154,220 @@ struct FChunkId
         {
         }
 
+        explicit FChunkId(const FChunkKey &Key) :
+            FaceIndex(Key.GetFace()),
+            Coords(Key.GetX(), Key.GetY(), 0),
+            LODLevel(Key.GetLOD())
+        {
+        }
+
+        FChunkKey GetKey() const { return FChunkKey(FaceIndex, Coords.X, Coords.Y, LODLevel); }
+
         bool operator==(const FChunkId &Other) const { return FaceIndex == Other.FaceIndex && Coords == Other.Coords && LODLevel == Other.LODLevel; }
 
-        friend uint32 GetTypeHash(const FChunkId &Other)
+        friend uint32 GetTypeHash(const FChunkId &Other) { return GetTypeHash(Other.GetKey()); }
+};
+
+
+struct FChunkPackedMesh;
+
+
+// Chunk edges bordering a coarser leaf of the same face, for LOD seam stitching. Edge order follows the chunk grid.
+struct FChunkSeams
+{
+        enum EEdge
         {
-            return HashCombine(HashCombine(GetTypeHash(Other.FaceIndex), GetTypeHash(Other.Coords)), GetTypeHash(Other.LODLevel));
-        }
+            NegX,
+            PosX,
+            NegY,
+            PosY,
+            NumEdges
+        };
+
+        uint8 CoarserLODs[NumEdges] = {0, 0, 0, 0};  // LOD levels down to the neighbouring leaf. 0 = same or finer neighbour
+
+        bool IsEmpty() const { return (CoarserLODs[0] | CoarserLODs[1] | CoarserLODs[2] | CoarserLODs[3]) == 0; }
+
+        // Chunk cells per neighbour cell along the edge
+        int32 GetSpan(int32 Edge) const { return 1 << CoarserLODs[Edge]; }
+
+        bool operator==(const FChunkSeams &Other) const { return FMemory::Memcmp(CoarserLODs, Other.CoarserLODs, sizeof(CoarserLODs)) == 0; }
+        bool operator!=(const FChunkSeams &Other) const { return !(*this == Other); }
 };
 
 
-// All data required for a single Mesh Section
+// All data required for a single Mesh Section.
+// Indexed and welded: vertices are shared between triangles. Stored compact, 10 bytes per vertex instead of 52:
+// positions quantized to 16 bits per axis over a fixed chunk-local box (1/65535 of the chunk extent),
+// normals octahedral-encoded in 2x16 bits. Decode with GetPosition/GetNormal or DecodePositions.
+// Seam vertices, the ones on the chunk's side faces, are shared with the neighbours: they are stored last and unquantized.
 USTRUCT(BlueprintType)
 struct FChunkMeshData
 {
         GENERATED_BODY()
 
         UPROPERTY()
-        TArray<FVector> Vertices;
+        TArray<uint16> Positions;  // 3 per interior vertex, see SetPositions
+
+        UPROPERTY()
+        TArray<FVector3f> SeamPositions;  // Chunk-local, full precision: vertex GetNumInteriorVertices() + i
 
         UPROPERTY()
         TArray<int32> Triangles;
 
         UPROPERTY()
-        TArray<FVector> Normals;
+        TArray<uint32> Normals;  // 1 per vertex, see EncodeNormal
+
+        UPROPERTY()
+        TArray<FColor> Colors;  // Debug LOD tint, empty unless PLANET_WITH_DEBUG_COLORS
+
+        // Chunk-local box the positions are quantized over: fixed per LOD (FMathUtils::GetChunkQuantizationBox), not fitted to the mesh
+        UPROPERTY()
+        FVector3f QuantizationMin = FVector3f::ZeroVector;
+
+        UPROPERTY()
+        FVector3f QuantizationSize = FVector3f::ZeroVector;
 
+        // Chunk-local bounding box of the decoded vertices, for culling
         UPROPERTY()
-        TArray<FVector2D> UV0;
+        FVector3f BoundsMin = FVector3f::ZeroVector;
 
         UPROPERTY()
-        TArray<FColor> Colors;
+        FVector3f BoundsSize = FVector3f::ZeroVector;
+
+        // GPU layout for EChunkRenderBackend::PackedVertexFactory, built on the worker (null with the PMC backend)
+        TSharedPtr<const FChunkPackedMesh, ESPMode::ThreadSafe> Packed;
+
+        // Neighbour LODs the mesh was stitched against
+        FChunkSeams Seams;
+
+        // The vertex arrays were dropped once the component held its own copy (see ReleaseCPUData)
+        bool bCPUDataReleased = false;
+
+        int32 GetNumVertices() const { return Normals.Num(); }
+
+        // Vertices before this index are quantized, the seam vertices follow
+        int32 GetNumInteriorVertices() const { return Positions.Num() / 3; }
+
+        // Chunk-local position of vertex i
+        FVector3f GetPosition(int32 i) const
+        {
+            const int32 NumInterior = GetNumInteriorVertices();
+            return i < NumInterior ? DecodePosition(&Positions[i * 3], QuantizationMin, QuantizationSize) : SeamPositions[i - NumInterior];
+        }
+
+        // Chunk-local unit normal of vertex i
+        FVector3f GetNormal(int32 i) const { return DecodeNormal(Normals[i]); }
+
+        FBox GetLocalBounds() const { return GetNumVertices() > 0 ? FBox(FVector(BoundsMin), FVector(BoundsMin + BoundsSize)) : FBox(ForceInit); }
+
+        // Quantizes the chunk-local interior vertex positions over QuantizationBox and keeps the seam ones as they are
+        // (vertex LocalPositions.Num() + i). Then fits the culling bounds to the decoded vertices.
+        // Quantizing the seams too would round each neighbour's copy of a shared vertex from its own chunk frame, apart.
+        void SetPositions(const TArray<FVector3f> &LocalPositions, const TArray<FVector3f> &LocalSeamPositions, const FBox3f &QuantizationBox)
+        {
+            QuantizationMin = QuantizationBox.Min;
+            QuantizationSize = QuantizationBox.Max - QuantizationBox.Min;
+
+            const FVector3f Scale(QuantizationSize.X > 0.f ? MAX_uint16 / QuantizationSize.X : 0.f,
+                                  QuantizationSize.Y > 0.f ? MAX_uint16 / QuantizationSize.Y : 0.f,
+                                  QuantizationSize.Z > 0.f ? MAX_uint16 / QuantizationSize.Z : 0.f);
+
+            FBox3f Box(ForceInit);
+            Positions.SetNumUninitialized(LocalPositions.Num() * 3);
+            for (int32 i = 0; i < LocalPositions.Num(); i++)
+            {
+                const FVector3f Q = (LocalPositions[i] - QuantizationMin) * Scale;
+                uint16 *Out = &Positions[i * 3];
+                Out[0] = (uint16)FMath::Clamp(FMath::RoundToInt(Q.X), 0, MAX_uint16);
+                Out[1] = (uint16)FMath::Clamp(FMath::RoundToInt(Q.Y), 0, MAX_uint16);
+                Out[2] = (uint16)FMath::Clamp(FMath::RoundToInt(Q.Z), 0, MAX_uint16);
+                Box += DecodePosition(Out, QuantizationMin, QuantizationSize);
+            }
+
+            SeamPositions = LocalSeamPositions;
+            for (const FVector3f &P : SeamPositions)
+                Box += P;
+
+            BoundsMin = Box.IsValid ? Box.Min : FVector3f::ZeroVector;
+            BoundsSize = Box.IsValid ? Box.Max - Box.Min : FVector3f::ZeroVector;
+        }
+
+        static FVector3f DecodePosition(const uint16 *Q, const FVector3f &Min, const FVector3f &Size)
+        {
+            return Min + FVector3f(Q[0], Q[1], Q[2]) * (Size / (float)MAX_uint16);
+        }
+
+        // Decodes every position, for consumers that need plain vertex arrays (PMC backend, collision). OutPositions is overwritten.
+        static void DecodePositions(const TArray<uint16> &InPositions, const TArray<FVector3f> &InSeamPositions, const FVector3f &Min, const FVector3f &Size,
+                                    TArray<FVector> &OutPositions)
+        {
+            const int32 NumInterior = InPositions.Num() / 3;
+            OutPositions.SetNumUninitialized(NumInterior + InSeamPositions.Num());
+            for (int32 i = 0; i < NumInterior; i++)
+                OutPositions[i] = FVector(DecodePosition(&InPositions[i * 3], Min, Size));
+            for (int32 i = 0; i < InSeamPositions.Num(); i++)
+                OutPositions[NumInterior + i] = FVector(InSeamPositions[i]);
+        }
+
+        // Octahedral mapping of a unit vector, 16 bits per coordinate (X low, Y high). Angular error < 0.01 degree.
+        static uint32 EncodeNormal(const FVector3f &N)
+        {
+            const float L1 = FMath::Abs(N.X) + FMath::Abs(N.Y) + FMath::Abs(N.Z);
+            if (L1 <= 0.f)
+                return EncodeNormal(FVector3f::UpVector);
+
+            float X = N.X / L1;
+            float Y = N.Y / L1;
+            if (N.Z < 0.f)
+            {
+                // Lower hemisphere folded over the diagonals
+                const float FoldedX = (1.f - FMath::Abs(Y)) * (X >= 0.f ? 1.f : -1.f);
+                const float FoldedY = (1.f - FMath::Abs(X)) * (Y >= 0.f ? 1.f : -1.f);
+                X = FoldedX;
+                Y = FoldedY;
+            }
+
+            const uint32 QX = (uint32)FMath::Clamp(FMath::RoundToInt((X * 0.5f + 0.5f) * MAX_uint16), 0, MAX_uint16);
+            const uint32 QY = (uint32)FMath::Clamp(FMath::RoundToInt((Y * 0.5f + 0.5f) * MAX_uint16), 0, MAX_uint16);
+            return QX | (QY << 16);
+        }
+
+        static FVector3f DecodeNormal(uint32 Encoded)
+        {
+            const float X = (Encoded & 0xFFFF) / (float)MAX_uint16 * 2.f - 1.f;
+            const float Y = (Encoded >> 16) / (float)MAX_uint16 * 2.f - 1.f;
+            FVector3f N(X, Y, 1.f - FMath::Abs(X) - FMath::Abs(Y));
+
+            // Unfold the lower hemisphere
+            const float T = FMath::Max(-N.Z, 0.f);
+            N.X += N.X >= 0.f ? -T : T;
+            N.Y += N.Y >= 0.f ? -T : T;
+            return N.GetSafeNormal();
+        }
+
+        // Frees the arrays only the upload needed. Seams and Packed (shared with the component) stay.
+        void ReleaseCPUData()
+        {
+            Positions.Empty();
+            SeamPositions.Empty();
+            Triangles.Empty();
+            Normals.Empty();
+            Colors.Empty();
+            bCPUDataReleased = true;
+        }
 
         void Empty()
         {
-            Vertices.Empty();
+            Positions.Empty();
+            SeamPositions.Empty();
             Triangles.Empty();
             Normals.Empty();
-            UV0.Empty();
             Colors.Empty();
+            QuantizationMin = QuantizationSize = BoundsMin = BoundsSize = FVector3f::ZeroVector;
+            Packed.Reset();
+            Seams = FChunkSeams();
+            bCPUDataReleased = false;
         }
 };
 
@@ -118,6 +401,16 @@ struct FChunkTransform
 };
 
 
+// Conservative bounds of a chunk and everything below it in the quadtree, terrain displacement included.
+struct FSphereBounds
+{
+        FVector Center = FVector::ZeroVector;   // Planet space, on the undisplaced sphere
+        FVector Direction = FVector::UpVector;  // Unit direction of Center
+        float Radius = 0.f;                     // Euclidean radius around Center
+        float AngularRadius = 0.f;              // Radians, seen from the planet center
+};
+
+
 // Context provided to the Manager to evaluate LODs and visibility
 USTRUCT(BlueprintType)
 struct FPlanetViewContext
@@ -135,6 +428,10 @@ struct FPlanetViewContext
 
         UPROPERTY()
         float ViewDistance;
+
+        // Pawns to cook chunk collision around. Only filled when collision is enabled.
+        UPROPERTY()
+        TArray<FVector> PhysicsActorLocations;
 };
 
 
@@ -154,13 +451,39 @@ struct FPlanetStatics
         static constexpr float DefaultEngineSphereRadius = 50.0f;
         static constexpr float TargetAutoChunkSize = 8000.0f;
         static constexpr float FarDistanceSafetyMargin = 1.1f;
+        static constexpr int32 DensitySlabThickness = 8;  // z-slices per density sub-task of the generation pipeline
+        static constexpr float GPUDensityTimeoutSeconds = 2.0f;  // A worker waiting longer on a compute field builds it on the CPU
+
+        // Multi-planet generation budget (UPlanetSubsystem)
+        static constexpr int32 DefaultGenerationBudget = 32;  // Tasks in flight over all planets of a world, "Planet.GenerationBudget"
+        static constexpr float MinGenerationWeight = 0.001f;  // Floor of a planet's view coverage, so a distant planet still progresses
+
+        // Surface queries
+        static constexpr float NoiseGradientBound = 3.0f;     // Max |gradient| of an IPlanetNoise octave at unit frequency (simplex: ~2.9)
+        static constexpr float SurfaceQueryMinStep = 0.05f;   // Voxels. Smallest sphere-tracing step, thinner features can be missed
+        static constexpr int32 SurfaceQueryMaxSteps = 128;
+        static constexpr int32 SurfaceQueryRefineSteps = 10;  // Bisections of the bracketed crossing
+        static constexpr int32 SurfaceQueryBatchSize = 64;    // Directions marched together, in stack arrays
+
+        // Collision
+        static constexpr float CollisionReleaseRatio = 1.25f;  // A cooked chunk keeps its collision up to CollisionRadius * this ratio
+
+        // Memory budget
+        static constexpr float MemoryBudgetResumeRatio = 0.9f;  // Prefetch suspended over budget resumes below budget * this ratio
 
         // Culling & Visibility
         static constexpr float UndergroundThreshold = -100.0f;
-        static constexpr float HorizonCullingDot = -0.5f;
-        static constexpr float FrustumCullingDot = -0.5f;
+        static constexpr float FrustumCullingDot = -0.5f;  // cos of the view-cone half-angle used by quadtree culling (120 deg)
         static constexpr float GridDebugRadiusScale = 1.002f;
 
+        // Quadtree
+        static constexpr int32 QuadtreeFullRefreshInterval = 300;  // Frames between full re-evaluations of the incremental quadtree
+
+        // Predictive prefetch
+        static constexpr int32 PrefetchSampleCount = 3;        // Future positions evaluated, spread evenly over the look-ahead time
+        static constexpr float PrefetchPriorityScale = 0.25f;  // Generation priority multiplier of prefetch requests
+        static constexpr float PrefetchMinSpeed = 100.0f;      // cm/s. Below this the observer is considered static
+
         // Debug
         static constexpr int32 DebugSphereSegments = 32;
         static constexpr float DebugSphereLifetime = 60.0f;
@@ -172,6 +495,18 @@ struct FPlanetStatics
         static constexpr int32 DebugKey_PredictionInfo = 102;
         static constexpr int32 DebugKey_LODBreakdown = 103;
         static constexpr int32 DebugKey_LODThreshold = 104;
+        static constexpr int32 DebugKey_GenQueueStats = 105;
+        static constexpr int32 DebugKey_DiskCacheStats = 106;
+        static constexpr int32 DebugKey_MeshCacheStats = 107;
+        static constexpr int32 DebugKey_UploadStats = 108;
+        static constexpr int32 DebugKey_CullingStats = 109;
+        static constexpr int32 DebugKey_PrefetchStats = 110;
+        static constexpr int32 DebugKey_QuadtreeStats = 111;
+        static constexpr int32 DebugKey_UpdateAllocStats = 112;
+        static constexpr int32 DebugKey_CancelStats = 113;
+        static constexpr int32 DebugKey_CollisionStats = 114;
+        static constexpr int32 DebugKey_MemoryStats = 115;
+        static constexpr int32 DebugKey_BudgetStats = 116;
 };
 
 
@@ -193,6 +528,18 @@ struct FPlanetGenSettings
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet")
         bool bEnableCollision = false;
 
+        // Collision is only cooked for chunks within this distance of a pawn.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet", meta = (EditCondition = "bEnableCollision", ClampMin = "100.0"))
+        float CollisionRadius = 5000.f;
+
+        // Only the N finest LODs get collision. Coarser chunks near a pawn are about to split anyway.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet", meta = (EditCondition = "bEnableCollision", ClampMin = "1", ClampMax = "16"))
+        int32 CollisionLODCount = 3;
+
+        // Vertex cluster size of the collision mesh, in voxels of the chunk's LOD. 1 = full visual mesh.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet", meta = (EditCondition = "bEnableCollision", ClampMin = "1", ClampMax = "8"))
+        int32 CollisionDecimation = 2;
+
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet")
         bool bCastShadows = false;
 
@@ -234,6 +581,9 @@ struct FPlanetGridSettings
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet",
                   meta = (DisplayName = "LOD Merge Hysteresis Ratio", ClampMin = "0.05", ClampMax = "2.0"))
         float LODMergeHysteresisRatio = 1.25f;
+
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet")
+        EChunkNormalMode NormalMode = EChunkNormalMode::AnalyticGradient;
 };
 
 
@@ -249,9 +599,30 @@ struct FPlanetPerformanceSettings
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "1", ClampMax = "100"))
         int32 ChunksToSpawnPerFrame = 8;
 
+        // Packed buffers + custom vertex factory, or UProceduralMeshComponent.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance")
+        EChunkRenderBackend RenderBackend = EChunkRenderBackend::PackedVertexFactory;
+
+        // Game-thread time allowed for mesh uploads per frame. The nearest chunks go first, the rest wait for the next frame.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0.1", ClampMax = "33.0"))
+        float MeshUploadBudgetMs = 4.0f;
+
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "1", ClampMax = "512"))
         int32 MaxConcurrentGenerations = 32;
 
+        // Density fields on the CPU workers, or one compute dispatch per chunk. The GPU field differs from the CPU one
+        // by float rounding, so both backends keep separate disk caches. Only SimpleNoise has a shader version.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance")
+        EChunkDensityBackend DensityBackend = EChunkDensityBackend::CPU;
+
+        // Collision mesh decimation tasks running at once.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "1", ClampMax = "64"))
+        int32 MaxConcurrentCollisionBuilds = 4;
+
+        // Game-thread time per frame for handing decimated meshes to the async physics cooker. Separate from the mesh upload budget.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance", meta = (ClampMin = "0.1", ClampMax = "33.0"))
+        float CollisionCookBudgetMs = 1.0f;
+
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|LOD Look-Ahead", meta = (ClampMin = "0.0", ClampMax = "10.0"))
         float MaxLookAheadTime = 2.5f;
 
@@ -260,6 +631,53 @@ struct FPlanetPerformanceSettings
 
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|LOD Look-Ahead", meta = (ClampMin = "0.01", ClampMax = "20.0"))
         float LookAheadAltitudeRadiusFactor = 4.0f;
+
+        // Max chunks generated ahead of time along the flight path. 0 = prefetch disabled.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|LOD Look-Ahead", meta = (ClampMin = "0", ClampMax = "512"))
+        int32 MaxPrefetchChunks = 32;
+
+        // Skip refining quadtree nodes behind the horizon or far outside the view direction.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance")
+        bool bEnableCulling = true;
+
+        // Only re-evaluate quadtree subtrees whose LOD or culling decision can have changed. Off = full traversal every frame.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance")
+        bool bIncrementalQuadtree = true;
+
+        // Keep the noise-band density samples of generated chunks, so a split copies the ones its children share
+        // instead of re-evaluating them (~25% of a child's noise). Costs roughly 100 KB per retained chunk.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Performance")
+        bool bReuseParentDensity = true;
+
+        // Persist generated chunks under Saved/PlanetCache and reload them instead of regenerating.
+        // Opt-in: while iterating on the generator, stale blobs would hide changes the config hash cannot see.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Disk Cache")
+        bool bEnableDiskCache = false;
+
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Disk Cache", meta = (ClampMin = "16", ClampMax = "65536"))
+        int32 DiskCacheMaxSizeMB = 512;
+
+        // Meshes of released chunks are kept in RAM up to this budget, so chunks coming back skip generation. 0 = disabled.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Memory Cache", meta = (ClampMin = "0", ClampMax = "4096"))
+        int32 MeshCacheBudgetMB = 128;
+
+        // Hard cap on CPU mesh data: chunk meshes, retained density and the mesh cache. Over it, chunks that are not required
+        // (prefetched, or hidden and waiting for release) are evicted farthest and coarsest first, and prefetch pauses. 0 = unlimited.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Memory Budget", meta = (ClampMin = "0", ClampMax = "65536"))
+        int32 MeshMemoryBudgetMB = 0;
+
+        // Same, for the estimated vertex and index buffers of the chunks holding a component. 0 = unlimited.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Memory Budget", meta = (ClampMin = "0", ClampMax = "65536"))
+        int32 GPUMemoryBudgetMB = 0;
+
+        // Same, for the number of chunks holding a render component. 0 = unlimited.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Memory Budget", meta = (ClampMin = "0", ClampMax = "100000"))
+        int32 MaxResidentComponents = 0;
+
+        // Drop a chunk's CPU vertex arrays once its component holds the mesh. Kept anyway for chunks that may need collision,
+        // and while the mesh cache is enabled (it stores the released meshes).
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Memory Budget")
+        bool bReleaseMeshDataAfterUpload = true;
 };
 
 
@@ -300,6 +718,13 @@ struct FPlanetConfig
         bool bEnableCollision = false;
         bool bCastShadows = false;
 
+        // Collision
+        float CollisionRadius = 5000.f;          // Cooked only for chunks this close to a pawn
+        int32 CollisionLODCount = 3;             // Finest LODs receiving collision
+        int32 CollisionDecimation = 2;           // Vertex cluster size in voxels, 1 = no decimation
+        int32 MaxConcurrentCollisionBuilds = 4;
+        float CollisionCookBudgetMs = 1.0f;      // Game-thread milliseconds per frame for collision hand-offs
+
         // Voxel Settings
         float VoxelSize = 100.f;    // true size of a voxel in the UE world
         int32 GridResolution = 32;  // resolution of the voxel grid in voxels
@@ -307,18 +732,41 @@ struct FPlanetConfig
         // Throttling
         int32 MaxConcurrentGenerations = 32;
         int32 ChunkGenerationRate = 8;  // Chunks to start generating per tick
-        int32 MeshUpdatesPerFrame = 4;
+        int32 MeshUpdatesPerFrame = 4;    // Hard cap on uploads per frame, on top of the time budget
+        float MeshUploadBudgetMs = 4.0f;  // Game-thread milliseconds per frame for mesh uploads
+        bool bReuseParentDensity = true;  // Seed split children with the samples they share with their parent
+        EChunkRenderBackend RenderBackend = EChunkRenderBackend::PackedVertexFactory;
+        EChunkDensityBackend DensityBackend = EChunkDensityBackend::CPU;
+
+        // Disk cache
+        bool bEnableDiskCache = false;
+        int32 DiskCacheMaxSizeMB = 512;
+
+        // Released mesh cache
+        int32 MeshCacheBudgetMB = 128;
+
+        // Resident memory budget, 0 = unlimited
+        int32 MeshMemoryBudgetMB = 0;
+        int32 GPUMemoryBudgetMB = 0;
+        int32 MaxResidentComponents = 0;
+        bool bReleaseMeshDataAfterUpload = true;
 
         // LOD Rules
         int32 MaxLOD = 8;
         float FarDistanceThreshold = 100000.0f;
         float LODSplitDistanceMultiplier = 2.0f;
         float LODMergeHysteresisRatio = 1.25f;  // Merge threshold = Split threshold * this ratio
+        bool bIncrementalQuadtree = true;       // Only revisit quadtree nodes whose decision can have changed
 
         // Look ahead params
         float MaxLookAheadTime = 2.5f;
         float MinLookAheadTime = 0.5f;
         float LookAheadAltitudeScale = 50000.0f;
+        int32 MaxPrefetchChunks = 32;
+
+        // Culling
+        bool bEnableCulling = true;
+        float MaxTerrainHeight = 500.f;  // Max radial displacement of the terrain from PlanetRadius (noise amplitude)
 
         int32 ChunkDemotionFrameDelay = 8;  // X frames. A rendered chunk must be absent before hiding
 };
@@ -331,24 +779,56 @@ struct DensityConfig
         float PlanetRadius = 10000.f;
         float VoxelSize = 100.f;
         FNoiseSettings Noise;
+        EChunkNormalMode NormalMode = EChunkNormalMode::AnalyticGradient;
 
         // Future expansion: biomes, caves, etc.
 };
 
 
-// Container for generated field data to avoid re-calculating positions
+// Compact density field of a chunk. Only densities are stored per sample.
+// Positions are rebuilt on demand: the cube-to-sphere direction only depends on the (x, y) column,
+// so it is cached once per column and scaled by the altitude of the z layer.
 struct GenData
 {
-        TArray<float> Densities;
-        TArray<FVector> Positions;
+        TArray<float> Densities;           // SampleCount^3 samples, x fastest
+        TArray<FVector> ColumnDirections;  // SampleCount^2 unit-sphere directions, x fastest
+        int32 SampleCount = 0;
+        float PlanetRadius = 0.f;
+        float VoxelSize = 0.f;
+        float SurfaceLevel = 0.f;  // z index of the undisplaced planet surface
+
+        int32 GetIndex(int32 x, int32 y, int32 z) const { return x + y * SampleCount + z * SampleCount * SampleCount; }
+
+        float GetAltitudeRadius(int32 z) const { return PlanetRadius + (z - SurfaceLevel) * VoxelSize; }
+
+        // Planet-relative position of a sample. Matches DensityGenerator::GetProjectedPosition.
+        FVector GetPosition(int32 x, int32 y, int32 z) const { return ColumnDirections[x + y * SampleCount] * GetAltitudeRadius(z); }
+};
+
+
+// Density samples kept after meshing a chunk, so its children can reuse them when it splits.
+// All LODs share the same z layout, so child (2x + i, 2y + j) sample (cx, cy, z) with even cx and cy is exactly
+// parent sample (i * Resolution / 2 + cx / 2, j * Resolution / 2 + cy / 2, z).
+// Only the slices that sample noise are kept: the others are a per-slice constant (see DensityGenerator::IsUniformSlice).
+struct FRetainedDensity
+{
+        TArray<float> Densities;  // NumSlices slices of SampleCount^2 samples starting at FirstSlice, x fastest
         int32 SampleCount = 0;
+        int32 FirstSlice = 0;
+        int32 NumSlices = 0;
+
+        bool HasSlice(int32 z) const { return z >= FirstSlice && z < FirstSlice + NumSlices; }
+
+        float Get(int32 x, int32 y, int32 z) const { return Densities[x + y * SampleCount + (z - FirstSlice) * SampleCount * SampleCount]; }
 };
 
+using FRetainedDensityPtr = TSharedPtr<const FRetainedDensity, ESPMode::ThreadSafe>;
+
 
 struct FLODTransition
 {
         FChunkId Parent;
-        TArray<FChunkId> Children;  // Always 4 for a quadtree split
+        TStaticArray<FChunkId, 4> Children;  // Inline: registering a transition never allocates
         ELeafTransitionType Type;
         bool bReadyToCommit = false;
 };
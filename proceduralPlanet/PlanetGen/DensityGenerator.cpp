@@ -26,42 +26,176 @@ float DensityGenerator::SampleDensity(const FVector &PlanetRelativePosition) con
 }
 
 
+float DensityGenerator::GetNoiseBound() const
+{
+    if (!NoiseProvider || Config.Noise.Octaves <= 0)
+        return 0.f;
+
+    return FMath::Abs(Config.Noise.Amplitude) / Config.VoxelSize;
+}
+
+
 GenData DensityGenerator::GenerateDensityField(int32 Resolution, const FVector &FaceNormal, const FVector &FaceRight, const FVector &FaceUp,
-                                               const FVector2D &UVMin, const FVector2D &UVMax) const
+                                               const FVector2D &UVMin, const FVector2D &UVMax, const FThreadSafeBool *CancelFlag) const
+{
+    GenData Result = BeginDensityField(Resolution, FaceNormal, FaceRight, FaceUp, UVMin, UVMax);
+    GenerateDensitySlab(Result, 0, Result.SampleCount, CancelFlag);
+    return Result;
+}
+
+
+GenData DensityGenerator::BeginDensityField(int32 Resolution, const FVector &FaceNormal, const FVector &FaceRight, const FVector &FaceUp,
+                                            const FVector2D &UVMin, const FVector2D &UVMax) const
 {
     const int32 SampleCount = Resolution + 1;
     const int32 TotalVoxels = SampleCount * SampleCount * SampleCount;
 
     GenData Result;
-    Result.Densities.Reserve(TotalVoxels);
-    Result.Positions.Reserve(TotalVoxels);
     Result.SampleCount = SampleCount;
+    Result.PlanetRadius = Config.PlanetRadius;
+    Result.VoxelSize = Config.VoxelSize;
+    Result.SurfaceLevel = Resolution / 2.0f;
 
-    // Iterate through all voxel grid points
-    for (int32 z = 0; z < SampleCount; z++)
+    // The cube-to-sphere projection only depends on (x, y): compute it once per column, not once per voxel.
+    Result.ColumnDirections.SetNumUninitialized(SampleCount * SampleCount);
+    for (int32 y = 0; y < SampleCount; y++)
     {
-        for (int32 y = 0; y < SampleCount; y++)
+        for (int32 x = 0; x < SampleCount; x++)
         {
-            for (int32 x = 0; x < SampleCount; x++)
+            Result.ColumnDirections[x + y * SampleCount] = GetColumnDirection(x, y, Resolution, FaceNormal, FaceRight, FaceUp, UVMin, UVMax);
+        }
+    }
+
+    Result.Densities.SetNumUninitialized(TotalVoxels);
+    return Result;
+}
+
+
+bool DensityGenerator::IsUniformSlice(const GenData &Field, int32 z) const
+{
+    // The sphere term is constant over a slice and the noise moves it by at most GetNoiseBound().
+    // The margin keeps every sample a mesh edge or a DensityGrid gradient can read exact: a uniform slice is at least
+    // one slice (two with grid normals) away from any sign change, so only its sign is ever used.
+    const float SkipThreshold = GetNoiseBound() + (Config.NormalMode == EChunkNormalMode::DensityGrid ? 2.f : 1.f);
+    const float SliceSphereDensity = (Config.PlanetRadius - Field.GetAltitudeRadius(z)) / Config.VoxelSize;
+    return FMath::Abs(SliceSphereDensity) > SkipThreshold;
+}
+
+
+FRetainedDensityPtr DensityGenerator::RetainDensity(const GenData &Field) const
+{
+    // The noise band is one contiguous run of slices around the surface
+    int32 FirstSlice = 0;
+    int32 EndSlice = Field.SampleCount;
+    while (FirstSlice < EndSlice && IsUniformSlice(Field, FirstSlice))
+        FirstSlice++;
+    while (EndSlice > FirstSlice && IsUniformSlice(Field, EndSlice - 1))
+        EndSlice--;
+
+    TSharedPtr<FRetainedDensity, ESPMode::ThreadSafe> Retained = MakeShared<FRetainedDensity, ESPMode::ThreadSafe>();
+    const int32 SliceSize = Field.SampleCount * Field.SampleCount;
+    Retained->SampleCount = Field.SampleCount;
+    Retained->FirstSlice = FirstSlice;
+    Retained->NumSlices = EndSlice - FirstSlice;
+    Retained->Densities.SetNumUninitialized(Retained->NumSlices * SliceSize);
+    if (Retained->NumSlices > 0)
+    {
+        FMemory::Memcpy(Retained->Densities.GetData(), &Field.Densities[FirstSlice * SliceSize], Retained->Densities.Num() * sizeof(float));
+    }
+    return Retained;
+}
+
+
+void DensityGenerator::GenerateDensitySlab(GenData &Field, int32 FirstSlice, int32 EndSlice, const FThreadSafeBool *CancelFlag,
+                                           const FRetainedDensity *ParentSamples, const FIntPoint &ParentOffset) const
+{
+    const int32 SampleCount = Field.SampleCount;
+
+    // Row buffers: one x-row of positions is sampled per batch call. On the stack up to the 64 grid.
+    constexpr int32 InlineRowSize = 65;
+    TArray<float, TInlineAllocator<InlineRowSize>> RowX, RowY, RowZ, RowOut;
+    TArray<float> Scratch;
+    RowX.SetNumUninitialized(SampleCount);
+    RowY.SetNumUninitialized(SampleCount);
+    RowZ.SetNumUninitialized(SampleCount);
+
+    // Parent grid is twice as coarse: only even rows and columns coincide with it
+    if (ParentSamples && (ParentSamples->SampleCount != SampleCount || (SampleCount - 1) % 2 != 0))
+    {
+        ParentSamples = nullptr;
+    }
+    if (ParentSamples)
+    {
+        RowOut.SetNumUninitialized(SampleCount / 2);
+    }
+
+    // Iterate through the slab's grid points, one row at a time
+    for (int32 z = FirstSlice; z < EndSlice; z++)
+    {
+        if (CancelFlag && *CancelFlag)
+            return;  // The result is going to be discarded
+
+        const float AltitudeRadius = Field.GetAltitudeRadius(z);
+
+        // Coarse pass: slices far enough from the surface are uniformly solid or air and need no noise at all
+        if (IsUniformSlice(Field, z))
+        {
+            const float SliceSphereDensity = (Config.PlanetRadius - AltitudeRadius) / Config.VoxelSize;
+            float *Slice = &Field.Densities[Field.GetIndex(0, 0, z)];
+            for (int32 i = 0; i < SampleCount * SampleCount; i++)
             {
-                // Calculate warped position on sphere
-                FVector PlanetRelPos = GetProjectedPosition(x, y, z, Resolution, FaceNormal, FaceRight, FaceUp, UVMin, UVMax);
+                Slice[i] = SliceSphereDensity;
+            }
+            continue;
+        }
 
-                // Sample density at this position
-                float Density = SampleDensity(PlanetRelPos);
+        const bool bSeededSlice = ParentSamples && ParentSamples->HasSlice(z);
 
-                Result.Densities.Add(Density);
-                Result.Positions.Add(PlanetRelPos);
+        for (int32 y = 0; y < SampleCount; y++)
+        {
+            const FVector *Directions = &Field.ColumnDirections[y * SampleCount];
+
+            // Row shared with the parent: copy its even samples, evaluate only the odd ones in between
+            if (bSeededSlice && (y & 1) == 0)
+            {
+                int32 NumNew = 0;
+                for (int32 x = 1; x < SampleCount; x += 2)
+                {
+                    const FVector PlanetRelPos = Directions[x] * AltitudeRadius;
+                    RowX[NumNew] = (float)PlanetRelPos.X;
+                    RowY[NumNew] = (float)PlanetRelPos.Y;
+                    RowZ[NumNew] = (float)PlanetRelPos.Z;
+                    NumNew++;
+                }
+
+                SampleDensityBatch(RowX.GetData(), RowY.GetData(), RowZ.GetData(), NumNew, RowOut.GetData(), Scratch);
+
+                float *Out = &Field.Densities[Field.GetIndex(0, y, z)];
+                const int32 ParentY = ParentOffset.Y + y / 2;
+                for (int32 x = 0; x < SampleCount; x++)
+                {
+                    Out[x] = (x & 1) ? RowOut[x / 2] : ParentSamples->Get(ParentOffset.X + x / 2, ParentY, z);
+                }
+                continue;
             }
+
+            for (int32 x = 0; x < SampleCount; x++)
+            {
+                // Warped position on the sphere
+                const FVector PlanetRelPos = Directions[x] * AltitudeRadius;
+                RowX[x] = (float)PlanetRelPos.X;
+                RowY[x] = (float)PlanetRelPos.Y;
+                RowZ[x] = (float)PlanetRelPos.Z;
+            }
+
+            SampleDensityBatch(RowX.GetData(), RowY.GetData(), RowZ.GetData(), SampleCount, &Field.Densities[Field.GetIndex(0, y, z)], Scratch);
         }
     }
-
-    return Result;
 }
 
 
-FVector DensityGenerator::GetProjectedPosition(int32 x, int32 y, int32 z, int32 Resolution, const FVector &FaceNormal, const FVector &FaceRight,
-                                               const FVector &FaceUp, const FVector2D &UVMin, const FVector2D &UVMax) const
+FVector DensityGenerator::GetColumnDirection(int32 x, int32 y, int32 Resolution, const FVector &FaceNormal, const FVector &FaceRight, const FVector &FaceUp,
+                                             const FVector2D &UVMin, const FVector2D &UVMax)
 {
     // Step 1: Get the position on the Cube surface (-1 to 1 range)
     // We pass z=0 here because z in the voxel grid represents depth/altitude,
@@ -69,7 +203,14 @@ FVector DensityGenerator::GetProjectedPosition(int32 x, int32 y, int32 z, int32
     FVector CubePos = FMathUtils::computeCubeSurfacePosition(FIntVector(x, y, 0), Resolution, FaceNormal, FaceRight, FaceUp, UVMin, UVMax);
 
     // Step 2: Project that cube point onto a unit sphere (Radius = 1.0)
-    FVector UnitSpherePos = FMathUtils::projectCubeToSphere(CubePos);
+    return FMathUtils::projectCubeToSphere(CubePos);
+}
+
+
+FVector DensityGenerator::GetProjectedPosition(int32 x, int32 y, int32 z, int32 Resolution, const FVector &FaceNormal, const FVector &FaceRight,
+                                               const FVector &FaceUp, const FVector2D &UVMin, const FVector2D &UVMax) const
+{
+    FVector UnitSpherePos = GetColumnDirection(x, y, Resolution, FaceNormal, FaceRight, FaceUp, UVMin, UVMax);
 
     // 5. Calculate altitude (Z is radial height from surface). Z = Resolution/2 represents the planet surface
     float SurfaceLevel = Resolution / 2.0f;
@@ -91,19 +232,13 @@ float DensityGenerator::GetDensityAtPos(const FVector &PlanetLocalPos) const
 
 FVector DensityGenerator::GetNormalAtPos(const FVector &PlanetLocalPos) const
 {
-    // Use a small offset to find the slope
-    // A smaller epsilon gives a more accurate local gradient. 1.0f can be too large in areas with high-frequency noise.
-    const float eps = 0.1f;
-
-    // Gradient is the change in density in each axis
-    float nx = GetDensityAtPos(PlanetLocalPos + FVector(eps, 0, 0)) - GetDensityAtPos(PlanetLocalPos - FVector(eps, 0, 0));
-    float ny = GetDensityAtPos(PlanetLocalPos + FVector(0, eps, 0)) - GetDensityAtPos(PlanetLocalPos - FVector(0, eps, 0));
-    float nz = GetDensityAtPos(PlanetLocalPos + FVector(0, 0, eps)) - GetDensityAtPos(PlanetLocalPos - FVector(0, 0, eps));
-
-    FVector Gradient = FVector(nx, ny, nz);
+    // Analytic gradient: one value+derivative FBM evaluation instead of six full density samples.
+    FVector Gradient;
+    SampleDensityWithGradient(PlanetLocalPos, Gradient);
 
     // Safety check: if the gradient is zero (dead center), fall back to the radial vector.
-    if (Gradient.SizeSquared() < KINDA_SMALL_NUMBER)
+    // The gradient is in density units per world unit (~1 / VoxelSize), so the threshold must be tiny.
+    if (Gradient.SizeSquared() < SMALL_NUMBER)
     {
         return PlanetLocalPos.GetSafeNormal();
     }
@@ -113,6 +248,23 @@ FVector DensityGenerator::GetNormalAtPos(const FVector &PlanetLocalPos) const
 }
 
 
+float DensityGenerator::SampleDensityWithGradient(const FVector &PlanetRelativePosition, FVector &OutGradient) const
+{
+    // Sphere term: (Radius - |p|) / VoxelSize  ->  gradient = -p / (|p| * VoxelSize)
+    const float DistanceToCenter = PlanetRelativePosition.Size();
+    const float SphereDensity = (Config.PlanetRadius - DistanceToCenter) / Config.VoxelSize;
+    OutGradient = (DistanceToCenter > KINDA_SMALL_NUMBER) ? -PlanetRelativePosition / (DistanceToCenter * Config.VoxelSize) : FVector::ZeroVector;
+
+    // Noise term, scaled exactly like SampleNoise()
+    FVector FbmGradient;
+    const float FbmValue = SampleFBMWithGradient(PlanetRelativePosition, FbmGradient);
+    const float NoiseScale = Config.Noise.Amplitude / Config.VoxelSize;
+    OutGradient += FbmGradient * NoiseScale;
+
+    return SphereDensity + FbmValue * NoiseScale;
+}
+
+
 float DensityGenerator::SampleSphereDensity(const FVector &PlanetRelativePosition) const
 {
     // Distance from planet center
@@ -163,6 +315,113 @@ float DensityGenerator::SampleFBM(const FVector &Position) const
 }
 
 
+void DensityGenerator::SampleDensityBatch(const float *X, const float *Y, const float *Z, int32 Count, float *OutDensities, TArray<float> &Scratch) const
+{
+    Scratch.SetNumUninitialized(Count * 5, EAllowShrinking::No);
+    SampleDensityBatch(X, Y, Z, Count, OutDensities, Scratch.GetData());
+}
+
+
+void DensityGenerator::SampleDensityBatch(const float *X, const float *Y, const float *Z, int32 Count, float *OutDensities, float *Scratch) const
+{
+    // 1. Base sphere density, same as SampleSphereDensity()
+    for (int32 i = 0; i < Count; i++)
+    {
+        const float DistanceToCenter = FMath::Sqrt(X[i] * X[i] + Y[i] * Y[i] + Z[i] * Z[i]);
+        OutDensities[i] = (Config.PlanetRadius - DistanceToCenter) / Config.VoxelSize;
+    }
+
+    if (!NoiseProvider || Config.Noise.Octaves <= 0)
+    {
+        return;
+    }
+
+    // Scratch layout: scaled X | scaled Y | scaled Z | octave signal | FBM total
+    float *SX = Scratch;
+    float *SY = SX + Count;
+    float *SZ = SY + Count;
+    float *Signal = SZ + Count;
+    float *Total = Signal + Count;
+    FMemory::Memzero(Total, Count * sizeof(float));
+
+    // 2. FBM, one batch call per octave instead of one virtual call per sample per octave
+    float Frequency = Config.Noise.Frequency;
+    float Amplitude = 1.0f;
+    float MaxValue = 0.0f;
+
+    for (int32 Octave = 0; Octave < Config.Noise.Octaves; Octave++)
+    {
+        for (int32 i = 0; i < Count; i++)
+        {
+            SX[i] = X[i] * Frequency;
+            SY[i] = Y[i] * Frequency;
+            SZ[i] = Z[i] * Frequency;
+        }
+
+        NoiseProvider->getNoiseBatch(SX, SY, SZ, Count, Config.Seed + Octave, Signal);
+
+        for (int32 i = 0; i < Count; i++)
+        {
+            Total[i] += Signal[i] * Amplitude;
+        }
+
+        MaxValue += Amplitude;
+        Amplitude *= Config.Noise.Persistence;
+        Frequency *= Config.Noise.Lacunarity;
+    }
+
+    if (MaxValue <= 0)
+    {
+        return;
+    }
+
+    // 3. Same scaling as SampleNoise(): normalized FBM -> world displacement -> density units
+    const float NoiseScale = Config.Noise.Amplitude / (Config.VoxelSize * MaxValue);
+    for (int32 i = 0; i < Count; i++)
+    {
+        OutDensities[i] += Total[i] * NoiseScale;
+    }
+}
+
+
+float DensityGenerator::SampleFBMWithGradient(const FVector &Position, FVector &OutGradient) const
+{
+    OutGradient = FVector::ZeroVector;
+    if (!NoiseProvider)
+    {
+        return 0.0f;
+    }
+
+    float Total = 0.0f;
+    float Frequency = Config.Noise.Frequency;
+    float Amplitude = 1.0f;
+    float MaxValue = 0.0f;
+
+    for (int32 i = 0; i < Config.Noise.Octaves; i++)
+    {
+        // Chain rule: d/dp noise(p * f) = f * noise'(p * f)
+        FVector OctaveGradient;
+        float Signal = NoiseProvider->getNoiseWithGradient(Position * Frequency, Config.Seed + i, OctaveGradient);
+
+        Total += Signal * Amplitude;
+        OutGradient += OctaveGradient * (Amplitude * Frequency);
+
+        MaxValue += Amplitude;
+        Amplitude *= Config.Noise.Persistence;
+        Frequency *= Config.Noise.Lacunarity;
+    }
+
+    if (MaxValue > 0)
+    {
+        OutGradient /= MaxValue;
+        return Total / MaxValue;
+    }
+
+    OutGradient = FVector::ZeroVector;
+    return 0.0f;
+}
+
+
 float DensityGenerator::SampleNoise(const FVector &Position) const
 {
     // 1. Get the raw noise value from our FBM function. This will be in the range [-1, 1].
@@ -173,3 +432,234 @@ float DensityGenerator::SampleNoise(const FVector &Position) const
     //    displacement, which is what Marching Cubes expects to see.
     return FbmValue * Config.Noise.Amplitude / Config.VoxelSize;
 }
+
+
+// ---------------------------------------------------------------------------
+// Surface queries
+// ---------------------------------------------------------------------------
+float DensityGenerator::GetLipschitzBound() const
+{
+    // World density f = (R - |p|) + Amplitude * FBM(p): the sphere term has slope 1,
+    // each octave adds at most OctaveAmplitude * Frequency * NoiseGradientBound, normalized like SampleFBM()
+    if (!NoiseProvider || Config.Noise.Octaves <= 0)
+        return 1.0f;
+
+    float Frequency = Config.Noise.Frequency;
+    float Amplitude = 1.0f;
+    float MaxValue = 0.0f;
+    float SlopeSum = 0.0f;
+    for (int32 i = 0; i < Config.Noise.Octaves; i++)
+    {
+        SlopeSum += Amplitude * Frequency;
+        MaxValue += Amplitude;
+        Amplitude *= Config.Noise.Persistence;
+        Frequency *= Config.Noise.Lacunarity;
+    }
+
+    return 1.0f + FMath::Abs(Config.Noise.Amplitude) * FPlanetStatics::NoiseGradientBound * SlopeSum / MaxValue;
+}
+
+
+void DensityGenerator::FindSurfaceRadii(const FVector *Directions, const float *StartRadii, int32 Count, float *OutRadii) const
+{
+    // Bulk queries never allocate: blocks of directions are marched with fixed-size stack arrays
+    for (int32 First = 0; First < Count; First += FPlanetStatics::SurfaceQueryBatchSize)
+    {
+        const int32 BlockCount = FMath::Min(Count - First, FPlanetStatics::SurfaceQueryBatchSize);
+        FindSurfaceRadiiBatch(Directions + First, StartRadii ? StartRadii + First : nullptr, BlockCount, OutRadii + First);
+    }
+}
+
+
+void DensityGenerator::FindSurfaceRadiiBatch(const FVector *Directions, const float *StartRadii, int32 Count, float *OutRadii) const
+{
+    constexpr int32 BatchSize = FPlanetStatics::SurfaceQueryBatchSize;
+    check(Count <= BatchSize);
+
+    const float NoiseWorld = GetNoiseBound() * Config.VoxelSize;
+    if (NoiseWorld <= 0.f)
+    {
+        for (int32 i = 0; i < Count; i++)
+            OutRadii[i] = Config.PlanetRadius;
+        return;
+    }
+
+    // The surface lies between these shells, padded so the outer one is always air and the inner one always solid
+    const float MinStep = FPlanetStatics::SurfaceQueryMinStep * Config.VoxelSize;
+    const float OuterRadius = Config.PlanetRadius + NoiseWorld + MinStep;
+    const float InnerRadius = Config.PlanetRadius - NoiseWorld - MinStep;
+    const float Lipschitz = GetLipschitzBound();
+
+    // Per query: the last sample of the march, then the [air, solid] bracket around the crossing
+    float Radius[BatchSize], Density[BatchSize], AirRadius[BatchSize], AirDensity[BatchSize], SolidRadius[BatchSize], SolidDensity[BatchSize];
+    float ProbeRadius[BatchSize], PosX[BatchSize], PosY[BatchSize], PosZ[BatchSize], ProbeDensity[BatchSize], Scratch[BatchSize * 5];
+    int32 Active[BatchSize], Probes[BatchSize];
+    int32 NumActive = 0, NumProbes = 0;
+
+    // World-space density at ProbeRadius of every query listed in Probes, one batch
+    auto SampleProbes = [&]()
+    {
+        for (int32 p = 0; p < NumProbes; p++)
+        {
+            const FVector Pos = Directions[Probes[p]] * ProbeRadius[Probes[p]];
+            PosX[p] = (float)Pos.X;
+            PosY[p] = (float)Pos.Y;
+            PosZ[p] = (float)Pos.Z;
+        }
+        SampleDensityBatch(PosX, PosY, PosZ, NumProbes, ProbeDensity, Scratch);
+        for (int32 p = 0; p < NumProbes; p++)
+            ProbeDensity[p] *= Config.VoxelSize;
+    };
+
+    for (int32 i = 0; i < Count; i++)
+    {
+        ProbeRadius[i] = StartRadii ? FMath::Clamp(StartRadii[i], InnerRadius, OuterRadius) : OuterRadius;
+        Probes[NumProbes++] = i;
+    }
+    SampleProbes();
+    for (int32 i = 0; i < Count; i++)
+    {
+        Radius[i] = ProbeRadius[i];
+        Density[i] = ProbeDensity[i];
+        Active[NumActive++] = i;
+    }
+
+    // 1. Sphere tracing: from air the march goes down, from solid ground up, until the sign flips.
+    //    The step never jumps over the surface, the clamp to the shells guarantees the flip.
+    for (int32 Step = 0; Step < FPlanetStatics::SurfaceQueryMaxSteps && NumActive > 0; Step++)
+    {
+        NumProbes = 0;
+        for (int32 a = 0; a < NumActive; a++)
+        {
+            const int32 i = Active[a];
+            const float Distance = FMath::Max(FMath::Abs(Density[i]) / Lipschitz, MinStep);
+            ProbeRadius[i] = FMath::Clamp(Radius[i] + (Density[i] > 0.f ? Distance : -Distance), InnerRadius, OuterRadius);
+            Probes[NumProbes++] = i;
+        }
+        SampleProbes();
+
+        NumActive = 0;
+        for (int32 p = 0; p < NumProbes; p++)
+        {
+            const int32 i = Probes[p];
+            const bool bWasSolid = Density[i] > 0.f;
+            if ((ProbeDensity[p] > 0.f) != bWasSolid)
+            {
+                (bWasSolid ? SolidRadius : AirRadius)[i] = Radius[i];
+                (bWasSolid ? SolidDensity : AirDensity)[i] = Density[i];
+                (bWasSolid ? AirRadius : SolidRadius)[i] = ProbeRadius[i];
+                (bWasSolid ? AirDensity : SolidDensity)[i] = ProbeDensity[p];
+                continue;
+            }
+
+            Radius[i] = ProbeRadius[i];
+            Density[i] = ProbeDensity[p];
+            Active[NumActive++] = i;
+        }
+    }
+
+    // Out of steps (only with a bound smaller than the real slope): keep the last sample
+    for (int32 a = 0; a < NumActive; a++)
+    {
+        const int32 i = Active[a];
+        AirRadius[i] = SolidRadius[i] = Radius[i];
+        AirDensity[i] = -1.f;
+        SolidDensity[i] = 1.f;
+    }
+
+    // 2. Bisection of the brackets, all queries together again, then a linear estimate inside the last one
+    NumProbes = 0;
+    for (int32 i = 0; i < Count; i++)
+        Probes[NumProbes++] = i;
+
+    for (int32 Step = 0; Step < FPlanetStatics::SurfaceQueryRefineSteps; Step++)
+    {
+        for (int32 i = 0; i < Count; i++)
+            ProbeRadius[i] = 0.5f * (AirRadius[i] + SolidRadius[i]);
+        SampleProbes();
+
+        for (int32 i = 0; i < Count; i++)
+        {
+            if (ProbeDensity[i] > 0.f)
+            {
+                SolidRadius[i] = ProbeRadius[i];
+                SolidDensity[i] = ProbeDensity[i];
+            }
+            else
+            {
+                AirRadius[i] = ProbeRadius[i];
+                AirDensity[i] = ProbeDensity[i];
+            }
+        }
+    }
+
+    for (int32 i = 0; i < Count; i++)
+    {
+        const float Alpha = FMathUtils::computeInterpAlpha(AirDensity[i], SolidDensity[i]);
+        OutRadii[i] = FMath::Lerp(AirRadius[i], SolidRadius[i], Alpha);
+    }
+}
+
+
+bool DensityGenerator::RaycastSurface(const FVector &Origin, const FVector &Direction, float MaxDistance, float &OutDistance) const
+{
+    const float NoiseWorld = GetNoiseBound() * Config.VoxelSize;
+    const float MinStep = FPlanetStatics::SurfaceQueryMinStep * Config.VoxelSize;
+    const float OuterRadius = Config.PlanetRadius + NoiseWorld + MinStep;
+    const float Lipschitz = GetLipschitzBound();
+
+    // Only the part of the ray inside the terrain shell can hit anything
+    const float B = FVector::DotProduct(Origin, Direction);
+    const float C = Origin.SizeSquared() - OuterRadius * OuterRadius;
+    const float Discriminant = B * B - C;
+    if (Discriminant < 0.f)
+        return false;
+
+    const float SqrtDisc = FMath::Sqrt(Discriminant);
+    float T = FMath::Max(-B - SqrtDisc, 0.f);
+    const float TEnd = FMath::Min(-B + SqrtDisc, MaxDistance);
+    if (T > TEnd)
+        return false;
+
+    float Density = SampleDensity(Origin + Direction * T) * Config.VoxelSize;
+    if (Density > 0.f)
+    {
+        OutDistance = T;
+        return true;
+    }
+
+    for (int32 Step = 0; Step < FPlanetStatics::SurfaceQueryMaxSteps && T < TEnd; Step++)
+    {
+        const float NextT = FMath::Min(T + FMath::Max(-Density / Lipschitz, MinStep), TEnd);
+        const float NextDensity = SampleDensity(Origin + Direction * NextT) * Config.VoxelSize;
+
+        if (NextDensity > 0.f)
+        {
+            // Bracketed: bisect, then interpolate inside the last interval
+            float AirT = T, AirDensity = Density, SolidT = NextT, SolidDensity = NextDensity;
+            for (int32 Refine = 0; Refine < FPlanetStatics::SurfaceQueryRefineSteps; Refine++)
+            {
+                const float MidT = 0.5f * (AirT + SolidT);
+                const float MidDensity = SampleDensity(Origin + Direction * MidT) * Config.VoxelSize;
+                if (MidDensity > 0.f)
+                {
+                    SolidT = MidT;
+                    SolidDensity = MidDensity;
+                }
+                else
+                {
+                    AirT = MidT;
+                    AirDensity = MidDensity;
+                }
+            }
+
+            OutDistance = FMath::Lerp(AirT, SolidT, FMathUtils::computeInterpAlpha(AirDensity, SolidDensity));
+            return true;
+        }
+
+        T = NextT;
+        Density = NextDensity;
+    }
+
+    return false;
+}
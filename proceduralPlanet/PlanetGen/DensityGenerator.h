@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
 #include "MathUtils.h"
 #include "IPlanetNoise.h"
 #include "DataTypes.h"
@@ -23,21 +24,63 @@ class PROCEDURALPLANET_API DensityGenerator
         // Sample density at a world position (relative to planet center)
         float SampleDensity(const FVector &PlanetRelativePosition) const;
 
-        // Generate entire density field for a chunk (optimized batch operation)
+        // Generate entire density field for a chunk (optimized batch operation).
+        // CancelFlag, if set, is polled between z-slices: once raised the remaining slices are left unfilled.
         GenData GenerateDensityField(int32 Resolution, const FVector &FaceNormal, const FVector &FaceRight, const FVector &FaceUp, const FVector2D &UVMin,
-                                     const FVector2D &UVMax) const;
+                                     const FVector2D &UVMax, const FThreadSafeBool *CancelFlag = nullptr) const;
+
+        // Allocates a chunk field and fills its column directions. The densities are left uninitialized for GenerateDensitySlab().
+        GenData BeginDensityField(int32 Resolution, const FVector &FaceNormal, const FVector &FaceRight, const FVector &FaceUp, const FVector2D &UVMin,
+                                  const FVector2D &UVMax) const;
+
+        // Fills the samples of the z-slices [FirstSlice, EndSlice). Slabs write disjoint ranges, so they may run in parallel on one field.
+        // With ParentSamples, the samples the chunk shares with its parent are copied from it instead of evaluated.
+        // ParentOffset is the parent sample matching this chunk's (0, 0), i.e. the child quadrant times Resolution / 2.
+        void GenerateDensitySlab(GenData &Field, int32 FirstSlice, int32 EndSlice, const FThreadSafeBool *CancelFlag = nullptr,
+                                 const FRetainedDensity *ParentSamples = nullptr, const FIntPoint &ParentOffset = FIntPoint::ZeroValue) const;
+
+        // True if slice z of the field is uniformly solid or air and far enough from any sign change that it never samples noise.
+        bool IsUniformSlice(const GenData &Field, int32 z) const;
+
+        // Copies the noise-sampled slices of a finished field, for the children of a future split.
+        FRetainedDensityPtr RetainDensity(const GenData &Field) const;
 
         // Accessors for validation/debugging
         const DensityConfig &GetConfig() const { return Config; }
+        const IPlanetNoise *GetNoiseProvider() const { return NoiseProvider; }
+
+        // Largest density offset the noise can add, in density units. The normalized FBM stays within [-1, 1].
+        float GetNoiseBound() const;
 
         // Calculate warped position on sphere surface (cube-to-sphere projection)
         FVector GetProjectedPosition(int32 x, int32 y, int32 z, int32 Resolution, const FVector &FaceNormal, const FVector &FaceRight, const FVector &FaceUp,
                                      const FVector2D &UVMin, const FVector2D &UVMax) const;
 
+        // Unit-sphere direction of a grid column. Shared by every sample along the z/altitude axis.
+        static FVector GetColumnDirection(int32 x, int32 y, int32 Resolution, const FVector &FaceNormal, const FVector &FaceRight, const FVector &FaceUp,
+                                          const FVector2D &UVMin, const FVector2D &UVMax);
+
         float GetDensityAtPos(const FVector &LocalPos) const;
 
         FVector GetNormalAtPos(const FVector &LocalPos) const;
 
+        // Density and its analytic gradient in planet space (density units per world unit). Costs one FBM evaluation.
+        float SampleDensityWithGradient(const FVector &PlanetRelativePosition, FVector &OutGradient) const;
+
+        // --- Surface queries (analytic, no chunk needed) ---
+
+        // Upper bound of the density slope in world units (density * VoxelSize per world unit).
+        // |density| * VoxelSize / bound is a distance the surface is guaranteed not to be within: the sphere-tracing step.
+        float GetLipschitzBound() const;
+
+        // Radius of the surface along each unit direction, planet space. The search starts at StartRadii (null = above the highest
+        // terrain) and goes down from air or up from solid ground, so it returns the first surface below a point in the open.
+        // All directions are marched together: every step evaluates the noise of the whole batch at once.
+        void FindSurfaceRadii(const FVector *Directions, const float *StartRadii, int32 Count, float *OutRadii) const;
+
+        // Sphere-traces a ray (planet space, unit Direction) to the first solid sample. A ray starting underground hits at distance 0.
+        bool RaycastSurface(const FVector &Origin, const FVector &Direction, float MaxDistance, float &OutDistance) const;
+
     private:
         DensityConfig Config;
         const IPlanetNoise *NoiseProvider;
@@ -48,6 +91,18 @@ class PROCEDURALPLANET_API DensityGenerator
         // Fractal Brownian Motion sampling
         float SampleFBM(const FVector &Position) const;
 
+        // FBM value and its gradient with respect to Position
+        float SampleFBMWithGradient(const FVector &Position, FVector &OutGradient) const;
+
+        // Batched SampleDensity() over coordinate streams. Scratch is resized as needed and can be reused across calls.
+        void SampleDensityBatch(const float *X, const float *Y, const float *Z, int32 Count, float *OutDensities, TArray<float> &Scratch) const;
+
+        // Same, with a caller-provided scratch of at least Count * 5 floats
+        void SampleDensityBatch(const float *X, const float *Y, const float *Z, int32 Count, float *OutDensities, float *Scratch) const;
+
+        // FindSurfaceRadii over at most FPlanetStatics::SurfaceQueryBatchSize directions, in stack arrays
+        void FindSurfaceRadiiBatch(const FVector *Directions, const float *StartRadii, int32 Count, float *OutRadii) const;
+
         // Noise sampling (to be implemented with your noise system)
         float SampleNoise(const FVector &Position) const;
 
@@ -10,9 +10,48 @@ class IPlanetNoise
     public:
         virtual ~IPlanetNoise() = default;
 
+        /// @brief  Name of the noise algorithm. Part of the disk cache key, with getVersion().
+        virtual const TCHAR *getName() const = 0;
+
+        /// @brief  Bump whenever the algorithm's output changes, so blobs generated by the older version are ignored.
+        virtual uint32 getVersion() const = 0;
+
         /// @brief           Sample a noise value at a specific 3D position.
         /// @param _position The 3D coordinate to sample.
         /// @param _seed     A unique seed for this specific sample (or chunk).
         /// @return          float - Typically in range [-1, 1], but depends on algorithm.
         virtual float getNoise(const FVector &_position, int32 _seed) const = 0;
+
+        /// @brief             Sample a noise value together with its gradient with respect to _position.
+        ///                    The default implementation uses central differences over getNoise() (6 extra samples);
+        ///                    implementations should override it with an analytic derivative.
+        /// @param _position   The 3D coordinate to sample.
+        /// @param _seed       A unique seed for this specific sample (or chunk).
+        /// @param _outGradient Receives d(noise)/d(position).
+        /// @return            float - Same value as getNoise().
+        virtual float getNoiseWithGradient(const FVector &_position, int32 _seed, FVector &_outGradient) const
+        {
+            const float Eps = 1e-3f;
+            _outGradient.X = getNoise(_position + FVector(Eps, 0, 0), _seed) - getNoise(_position - FVector(Eps, 0, 0), _seed);
+            _outGradient.Y = getNoise(_position + FVector(0, Eps, 0), _seed) - getNoise(_position - FVector(0, Eps, 0), _seed);
+            _outGradient.Z = getNoise(_position + FVector(0, 0, Eps), _seed) - getNoise(_position - FVector(0, 0, Eps), _seed);
+            _outGradient /= (2.0f * Eps);
+            return getNoise(_position, _seed);
+        }
+
+        /// @brief           Sample noise for a batch of positions given as separate X/Y/Z streams.
+        ///                  The default implementation loops over getNoise(); implementations should vectorize it.
+        /// @param _x        X coordinates, _count entries.
+        /// @param _y        Y coordinates, _count entries.
+        /// @param _z        Z coordinates, _count entries.
+        /// @param _count    Number of samples in the batch.
+        /// @param _seed     Seed shared by every sample of the batch.
+        /// @param _out      Receives _count noise values.
+        virtual void getNoiseBatch(const float *_x, const float *_y, const float *_z, int32 _count, int32 _seed, float *_out) const
+        {
+            for (int32 i = 0; i < _count; ++i)
+            {
+                _out[i] = getNoise(FVector(_x[i], _y[i], _z[i]), _seed);
+            }
+        }
 };
\ No newline at end of file
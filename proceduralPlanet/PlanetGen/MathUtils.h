@@ -117,6 +117,47 @@ class PROCEDURALPLANET_API FMathUtils
             return projectCubeToSphere(CubePos) * PlanetRadius;
         }
 
+        // Bounds of a chunk's surface patch, grown by the max terrain displacement.
+        // Corner directions are exact; the 10% margin covers the patch bulging between them.
+        static FSphereBounds GetChunkBounds(const FChunkId& Id, float PlanetRadius, float MaxTerrainHeight)
+        {
+            FVector2D UVMin, UVMax;
+            GetChunkUVBounds(Id, UVMin, UVMax);
+            const FVector2D CubeMin = UVMin * 2.0f - 1.0f;
+            const FVector2D CubeMax = UVMax * 2.0f - 1.0f;
+
+            const FVector Normal = getFaceNormal(Id.FaceIndex);
+            const FVector Right = getFaceRight(Id.FaceIndex);
+            const FVector Up = getFaceUp(Id.FaceIndex);
+
+            FSphereBounds Bounds;
+            Bounds.Center = GetChunkCenter(Id, PlanetRadius);
+            Bounds.Direction = Bounds.Center.GetSafeNormal();
+
+            float MinCornerDot = 1.0f;
+            const FVector2D Corners[4] = {CubeMin, FVector2D(CubeMax.X, CubeMin.Y), CubeMax, FVector2D(CubeMin.X, CubeMax.Y)};
+            for (const FVector2D &Corner : Corners)
+            {
+                const FVector CornerDir = projectCubeToSphere(Normal + Right * Corner.X + Up * Corner.Y);
+                MinCornerDot = FMath::Min(MinCornerDot, (float)FVector::DotProduct(CornerDir, Bounds.Direction));
+            }
+
+            Bounds.AngularRadius = FMath::Acos(FMath::Clamp(MinCornerDot, -1.0f, 1.0f)) * 1.1f;
+            Bounds.Radius = 2.0f * PlanetRadius * FMath::Sin(FMath::Min(Bounds.AngularRadius, PI) * 0.5f) + MaxTerrainHeight;
+            return Bounds;
+        }
+
+        // Chunk-local box holding the mesh of any chunk of the LOD, for vertices within SurfaceHalfHeight of the planet radius.
+        // It only depends on the LOD, so neighbours quantize their shared seam vertices with the same step.
+        // A chunk spans 90 / 2^LOD degrees of its face nominally: that angle bounds its half-diagonal, the spherified cube warp included.
+        static FBox3f GetChunkQuantizationBox(int32 LODLevel, float PlanetRadius, float SurfaceHalfHeight)
+        {
+            const float MaxAngle = FMath::Min(HALF_PI / (float)(1 << LODLevel), HALF_PI);
+            const float Lateral = (PlanetRadius + SurfaceHalfHeight) * FMath::Sin(MaxAngle);
+            const float Vertical = SurfaceHalfHeight + PlanetRadius * (1.0f - FMath::Cos(MaxAngle));
+            return FBox3f(FVector3f(-Lateral, -Lateral, -Vertical), FVector3f(Lateral, Lateral, Vertical));
+        }
+
         // Calculates the full transform (Location, Rotation, Scale) for a chunk.
         static FChunkTransform ComputeChunkTransform(const FChunkId& Id, float PlanetRadius)
         {
@@ -172,15 +213,22 @@ class PROCEDURALPLANET_API FMathUtils
         }
 
 
-        static FVector computeVertexInterp(const FVector &P1, const FVector &P2, float D1, float D2)
+        // Position of the zero crossing along an edge, as a [0, 1] fraction from the D1 end.
+        static float computeInterpAlpha(float D1, float D2)
         {
             const float Epsilon = 1e-6f;
             float Denom = D1 - D2;
             if (FMath::Abs(Denom) < Epsilon)
             {
-                return (P1 + P2) * 0.5f;
+                return 0.5f;
             }
-            float T = D1 / Denom;
+            return D1 / Denom;
+        }
+
+
+        static FVector computeVertexInterp(const FVector &P1, const FVector &P2, float D1, float D2)
+        {
+            float T = computeInterpAlpha(D1, D2);
             return P1 + T * (P2 - P1);
         }
 };
\ No newline at end of file
@@ -1,28 +1,213 @@
 #include "MeshGenerator.h"
 #include "MarchingCubesTables.h"
+#include "Misc/ScopeExit.h"
+
+
+namespace
+{
+    // Cube corner offsets (x, y, z), in the marching cubes tables' corner order
+    constexpr int32 CornerOffsets[8][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}};
+
+    constexpr int32 EdgeIndex[12][2] = {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+
+    // Every grid point owns its +X, +Y and +Z edge. For each cube edge: owner offset (x, y, z) and axis.
+    constexpr int32 EdgeOwner[12][4] = {{0, 0, 0, 0}, {1, 0, 0, 1}, {0, 1, 0, 0}, {0, 0, 0, 1}, {0, 0, 1, 0}, {1, 0, 1, 1},
+                                        {0, 1, 1, 0}, {0, 0, 1, 1}, {0, 0, 0, 2}, {1, 0, 0, 2}, {1, 1, 0, 2}, {0, 1, 0, 2}};
+
+    // Seam vertices are numbered apart while meshing, with this bit set, and moved after the interior ones at the end
+    constexpr int32 SeamVertexTag = 1 << 30;
+
+    // Marching buffers reused by every chunk a thread meshes, so steady-state meshing does not allocate.
+    // A mesh started on a thread whose buffers are taken (a task run inline while waiting) uses buffers of its own.
+    struct FMeshScratch
+    {
+            TArray<int32> EdgeCache;
+            TArray<FVector3f> Positions;
+            TArray<FVector3f> SeamPositions;
+            TArray<uint32> SeamNormals;
+            bool bInUse = false;
+    };
+
+    thread_local FMeshScratch ThreadMeshScratch;
+}
+
+
+FChunkMeshData MeshGenerator::GenerateMesh(const GenData &GenData, int32 Resolution, const FTransform &ChunkTransform, const FTransform &PlanetTransform,
+                                           int32 LODLevel, const DensityGenerator &DensityGen, const FThreadSafeBool *CancelFlag)
+{
+    return GenerateMesh(GenData, Resolution, ChunkTransform, PlanetTransform, LODLevel, DensityGen, [](int32) {}, CancelFlag);
+}
 
 
 FChunkMeshData MeshGenerator::GenerateMesh(const GenData &GenData, int32 Resolution, const FTransform &ChunkTransform, const FTransform &PlanetTransform,
-                                           int32 LODLevel, const DensityGenerator &DensityGen)
+                                           int32 LODLevel, const DensityGenerator &DensityGen, TFunctionRef<void(int32 Slice)> WaitForSlice,
+                                           const FThreadSafeBool *CancelFlag, const FChunkSeams &Seams)
+{
+    // Compile-time grids for the common resolutions. The generic kernel takes the rest, and fields not sampled at Resolution.
+    if (GenData.SampleCount == Resolution + 1)
+    {
+        switch (Resolution)
+        {
+            case 16:
+                return GenerateMeshKernel<16>(GenData, Resolution, ChunkTransform, PlanetTransform, LODLevel, DensityGen, WaitForSlice, CancelFlag, Seams);
+            case 32:
+                return GenerateMeshKernel<32>(GenData, Resolution, ChunkTransform, PlanetTransform, LODLevel, DensityGen, WaitForSlice, CancelFlag, Seams);
+            case 64:
+                return GenerateMeshKernel<64>(GenData, Resolution, ChunkTransform, PlanetTransform, LODLevel, DensityGen, WaitForSlice, CancelFlag, Seams);
+            default:
+                break;
+        }
+    }
+    return GenerateMeshKernel<0>(GenData, Resolution, ChunkTransform, PlanetTransform, LODLevel, DensityGen, WaitForSlice, CancelFlag, Seams);
+}
+
+
+template<int32 StaticResolution>
+FChunkMeshData MeshGenerator::GenerateMeshKernel(const GenData &GenData, int32 InResolution, const FTransform &ChunkTransform,
+                                                 const FTransform &PlanetTransform, int32 LODLevel, const DensityGenerator &DensityGen,
+                                                 TFunctionRef<void(int32 Slice)> WaitForSlice, const FThreadSafeBool *CancelFlag, const FChunkSeams &Seams)
 {
     FChunkMeshData MeshData;
+    MeshData.Seams = Seams;
 
-    // Use the SampleCount from the generated data.
-    const int32 SampleCount = GenData.SampleCount;
+    // Constants in the specialized kernels, so every index and stride below folds at compile time.
+    // The generic kernel uses the SampleCount from the generated data.
+    const int32 Resolution = StaticResolution > 0 ? StaticResolution : InResolution;
+    const int32 SampleCount = StaticResolution > 0 ? StaticResolution + 1 : GenData.SampleCount;
+    const int32 SliceSize = SampleCount * SampleCount;
     if (SampleCount <= 1)
     {
         return MeshData;
     }
 
+    const bool bGridNormals = DensityGen.GetConfig().NormalMode == EChunkNormalMode::DensityGrid;
+
+#if PLANET_WITH_DEBUG_COLORS
     FColor DebugColor = (LODLevel >= 0 && LODLevel < LODColorsDebug.Num()) ? LODColorsDebug[LODLevel] : FColor::White;
+#endif
+
+    FMeshScratch OwnScratch;
+    FMeshScratch &Scratch = ThreadMeshScratch.bInUse ? OwnScratch : ThreadMeshScratch;
+    Scratch.bInUse = true;
+    ON_SCOPE_EXIT
+    {
+        Scratch.bInUse = false;
+    };
+
+    // Float positions until the mesh is done, then quantized in one go. Vertices on the chunk's side faces are shared
+    // with the neighbours and kept apart: they stay unquantized (see FChunkMeshData::SetPositions).
+    TArray<FVector3f> &LocalPositions = Scratch.Positions;
+    TArray<FVector3f> &SeamPositions = Scratch.SeamPositions;
+    TArray<uint32> &SeamNormals = Scratch.SeamNormals;
+    LocalPositions.Reset();
+    SeamPositions.Reset();
+    SeamNormals.Reset();
+
+    // Offsets from a cube's corner 0 to each of its corners: in the samples, and in the column directions
+    int32 CornerSample[8], CornerColumn[8];
+    for (int32 i = 0; i < 8; i++)
+    {
+        CornerColumn[i] = CornerOffsets[i][0] + CornerOffsets[i][1] * SampleCount;
+        CornerSample[i] = CornerColumn[i] + CornerOffsets[i][2] * SliceSize;
+    }
+
+    // Offset from a cube's column to the cache slot of each of its edges, within the owner's layer
+    int32 EdgeSlot[12];
+    for (int32 e = 0; e < 12; e++)
+    {
+        EdgeSlot[e] = (EdgeOwner[e][0] + EdgeOwner[e][1] * SampleCount) * 3 + EdgeOwner[e][3];
+    }
+
+    // Edge-to-vertex-index cache over two z-layers of grid points, so each crossing edge is
+    // interpolated and shaded once and shared by all cubes touching it. INDEX_NONE = not emitted yet.
+    const int32 LayerSize = SliceSize * 3;
+    TArray<int32> &EdgeCache = Scratch.EdgeCache;
+    EdgeCache.SetNumUninitialized(LayerSize * 2, EAllowShrinking::No);
+    FMemory::Memset(EdgeCache.GetData(), 0xFF, LayerSize * sizeof(int32));  // Layer 0, layer 1 is cleared by the first slice
+
+    // Cube layer z reads slices z and z + 1, the grid gradient one more on each side
+    const int32 SliceLookAhead = bGridNormals ? 2 : 1;
+
+    const bool bHasSeams = !Seams.IsEmpty();
+
+    // Closes the gaps left along a stitched edge by layer z: in each neighbour cell, the chunk's boundary polyline may bend
+    // through crossings on the interior z-edges where the neighbour's runs straight. The polygon between the two lies in the
+    // boundary plane and is fanned from its first vertex, with both windings since it is seen edge-on from either side.
+    auto StitchEdge = [&](int32 Edge, int32 z)
+    {
+        const int32 Span = Seams.GetSpan(Edge);
+        const bool bAlongY = Edge == FChunkSeams::NegX || Edge == FChunkSeams::PosX;
+        const int32 Fixed = (Edge == FChunkSeams::NegX || Edge == FChunkSeams::NegY) ? 0 : Resolution;
+
+        // Cached vertex on the edge of boundary grid point c of a slice, INDEX_NONE if none
+        auto Vertex = [&](int32 c, int32 Slice, int32 Axis)
+        {
+            const int32 GridIndex = bAlongY ? Fixed + c * SampleCount : c + Fixed * SampleCount;
+            return EdgeCache[(Slice & 1) * LayerSize + GridIndex * 3 + Axis];
+        };
+        const int32 AlongAxis = bAlongY ? 1 : 0;
+
+        for (int32 c0 = 0; c0 < Resolution; c0 += Span)
+        {
+            // Crossings on the neighbour cell's perimeter, with twice their edge coordinate so half edges stay integral
+            int32 Perimeter[2], PerimeterCoord[2];
+            int32 NumPerimeter = 0;
+            auto AddPerimeter = [&](int32 V, int32 Coord2)
+            {
+                if (V == INDEX_NONE)
+                    return;
+                if (NumPerimeter < 2)
+                {
+                    Perimeter[NumPerimeter] = V;
+                    PerimeterCoord[NumPerimeter] = Coord2;
+                }
+                NumPerimeter++;
+            };
 
-    const FVector CornerOffsets[8] = {
-        FVector(0, 0, 0), FVector(1, 0, 0), FVector(1, 1, 0), FVector(0, 1, 0), FVector(0, 0, 1), FVector(1, 0, 1), FVector(1, 1, 1), FVector(0, 1, 1)};
+            AddPerimeter(Vertex(c0, z, 2), c0 * 2);
+            AddPerimeter(Vertex(c0 + Span, z, 2), (c0 + Span) * 2);
+            for (int32 c = c0; c < c0 + Span; c++)
+            {
+                AddPerimeter(Vertex(c, z, AlongAxis), c * 2 + 1);
+                AddPerimeter(Vertex(c, z + 1, AlongAxis), c * 2 + 1);
+            }
+
+            if (NumPerimeter != 2)
+                continue;  // Nothing crosses, or an ambiguous saddle: left as is
 
-    const int EdgeIndex[12][2] = {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+            // Polygon: low perimeter crossing, interior z-edge crossings in edge order, high perimeter crossing
+            const int32 Low = PerimeterCoord[0] <= PerimeterCoord[1] ? 0 : 1;
+            const int32 Apex = Perimeter[Low];
+            int32 Prev = INDEX_NONE;
+            for (int32 c = c0 + 1; c <= c0 + Span; c++)
+            {
+                const int32 Next = c < c0 + Span ? Vertex(c, z, 2) : Perimeter[1 - Low];
+                if (Next == INDEX_NONE)
+                    continue;
+
+                if (Prev != INDEX_NONE)
+                {
+                    MeshData.Triangles.Append({Apex, Prev, Next, Apex, Next, Prev});
+                }
+                Prev = Next;
+            }
+        }
+    };
 
     for (int32 z = 0; z < Resolution; z++)
     {
+        if (CancelFlag && *CancelFlag)
+            return FChunkMeshData();  // The result is going to be discarded, drop the partial mesh
+
+        WaitForSlice(FMath::Min(z + SliceLookAhead, SampleCount - 1));
+
+        // Layer (z & 1) holds edges owned by slice z (already shared with the previous cube row's top),
+        // layer ((z + 1) & 1) still holds slice z - 1 and is recycled for slice z + 1.
+        FMemory::Memset(&EdgeCache[((z + 1) & 1) * LayerSize], 0xFF, LayerSize * sizeof(int32));
+
+        // Shell radii of the cube layer's bottom and top slices
+        const float LayerRadius[2] = {GenData.GetAltitudeRadius(z), GenData.GetAltitudeRadius(z + 1)};
+
         for (int32 y = 0; y < Resolution; y++)
         {
             for (int32 x = 0; x < Resolution; x++)
@@ -31,14 +216,23 @@ FChunkMeshData MeshGenerator::GenerateMesh(const GenData &GenData, int32 Resolut
                 FVector P[8];
                 int32 CubeIndex = 0;
 
+                const int32 Column = x + y * SampleCount;
+                const int32 Sample = Column + z * SliceSize;
+
                 for (int32 i = 0; i < 8; i++)
                 {
-                    int32 ix = x + (int32)CornerOffsets[i].X;
-                    int32 iy = y + (int32)CornerOffsets[i].Y;
-                    int32 iz = z + (int32)CornerOffsets[i].Z;
+                    const int32 ix = x + CornerOffsets[i][0];
+                    const int32 iy = y + CornerOffsets[i][1];
 
-                    D[i] = GenData.Densities[ix + iy * SampleCount + iz * SampleCount * SampleCount];
-                    P[i] = GenData.Positions[ix + iy * SampleCount + iz * SampleCount * SampleCount];
+                    if (bHasSeams && (ix == 0 || iy == 0 || ix == Resolution || iy == Resolution))
+                    {
+                        GetSeamSample(GenData, Seams, ix, iy, z + CornerOffsets[i][2], D[i], P[i]);
+                    }
+                    else
+                    {
+                        D[i] = GenData.Densities[Sample + CornerSample[i]];
+                        P[i] = GenData.ColumnDirections[Column + CornerColumn[i]] * LayerRadius[CornerOffsets[i][2]];  // GenData.GetPosition
+                    }
 
                     if (D[i] > 0.0f)
                         CubeIndex |= (1 << i);
@@ -48,45 +242,173 @@ FChunkMeshData MeshGenerator::GenerateMesh(const GenData &GenData, int32 Resolut
                     continue;
 
                 int32 edges = MarchingCubesTables::EdgeTable[CubeIndex];
-                FVector EdgeVertex[12];
+                int32 EdgeVertexIndex[12];
 
                 for (int32 e = 0; e < 12; e++)
                 {
                     if (edges & (1 << e))
                     {
-                        EdgeVertex[e] = FMathUtils::computeVertexInterp(P[EdgeIndex[e][0]], P[EdgeIndex[e][1]], D[EdgeIndex[e][0]], D[EdgeIndex[e][1]]);
-                    }
-                }
+                        const int32 OwnerZ = z + EdgeOwner[e][2];
+                        int32 &CachedIndex = EdgeCache[(OwnerZ & 1) * LayerSize + Column * 3 + EdgeSlot[e]];
+                        if (CachedIndex != INDEX_NONE)
+                        {
+                            EdgeVertexIndex[e] = CachedIndex;
+                            continue;
+                        }
 
-                for (int32 i = 0; MarchingCubesTables::TriTable[CubeIndex][i] != -1; i += 3)
-                {
-                    FVector PlanetSpaceVertices[] = {EdgeVertex[MarchingCubesTables::TriTable[CubeIndex][i]],
-                                                     EdgeVertex[MarchingCubesTables::TriTable[CubeIndex][i + 1]],
-                                                     EdgeVertex[MarchingCubesTables::TriTable[CubeIndex][i + 2]]};
+                        const int32 C0 = EdgeIndex[e][0];
+                        const int32 C1 = EdgeIndex[e][1];
+                        const float T = FMathUtils::computeInterpAlpha(D[C0], D[C1]);
+                        const FVector PlanetSpaceVertex = P[C0] + T * (P[C1] - P[C0]);
+
+                        // Planet-space normal of the edge vertex
+                        FVector PlanetNormal;
+                        if (bGridNormals)
+                        {
+                            // Interpolate the field gradient of both corners with the same weight as the position
+                            const FVector G0 = GetGridGradient(GenData, x + CornerOffsets[C0][0], y + CornerOffsets[C0][1], z + CornerOffsets[C0][2]);
+                            const FVector G1 = GetGridGradient(GenData, x + CornerOffsets[C1][0], y + CornerOffsets[C1][1], z + CornerOffsets[C1][2]);
+                            const FVector Gradient = G0 + T * (G1 - G0);
+                            PlanetNormal = Gradient.SizeSquared() < SMALL_NUMBER ? PlanetSpaceVertex.GetSafeNormal() : -Gradient.GetSafeNormal();
+                        }
+                        else
+                        {
+                            PlanetNormal = DensityGen.GetNormalAtPos(PlanetSpaceVertex);
+                        }
 
-                    for (const FVector &PlanetSpaceVertex : PlanetSpaceVertices)
-                    {
                         // --- 1. Calculate Vertex Position ---
                         // Transform from Planet-Relative space to Chunk Local space
                         FVector WorldPos = PlanetTransform.TransformPosition(PlanetSpaceVertex);
                         FVector ChunkLocalPos = ChunkTransform.InverseTransformPosition(WorldPos);
 
-                        int32 Index = MeshData.Vertices.Add(ChunkLocalPos);
-                        MeshData.Triangles.Add(Index);
-
                         // --- 2. Calculate Vertex Normal ---
-                        FVector PlanetNormal = DensityGen.GetNormalAtPos(PlanetSpaceVertex);
                         FVector WorldNormal = PlanetTransform.TransformVector(PlanetNormal);
                         FVector ChunkLocalNormal = ChunkTransform.InverseTransformVector(WorldNormal);
+                        const uint32 EncodedNormal = FChunkMeshData::EncodeNormal(FVector3f(ChunkLocalNormal.GetSafeNormal()));
 
-                        MeshData.Normals.Add(ChunkLocalNormal.GetSafeNormal());
+                        // On a side face when both corners lie in the same boundary plane: x or y = 0 or Resolution
+                        const int32 X0 = x + CornerOffsets[C0][0], X1 = x + CornerOffsets[C1][0];
+                        const int32 Y0 = y + CornerOffsets[C0][1], Y1 = y + CornerOffsets[C1][1];
+                        const bool bSeamVertex = (X0 == X1 && (X0 == 0 || X0 == Resolution)) || (Y0 == Y1 && (Y0 == 0 || Y0 == Resolution));
+                        if (bSeamVertex)
+                        {
+                            CachedIndex = SeamPositions.Add(FVector3f(ChunkLocalPos)) | SeamVertexTag;
+                            SeamNormals.Add(EncodedNormal);
+                        }
+                        else
+                        {
+                            CachedIndex = LocalPositions.Add(FVector3f(ChunkLocalPos));
+                            MeshData.Normals.Add(EncodedNormal);
+                        }
+                        EdgeVertexIndex[e] = CachedIndex;
 
+#if PLANET_WITH_DEBUG_COLORS
                         // --- 3. Add Debug Color ---
                         MeshData.Colors.Add(DebugColor);
+#endif
                     }
                 }
+
+                // Indexed triangles over the shared edge vertices (same winding as the tables)
+                for (int32 i = 0; MarchingCubesTables::TriTable[CubeIndex][i] != -1; i += 3)
+                {
+                    MeshData.Triangles.Add(EdgeVertexIndex[MarchingCubesTables::TriTable[CubeIndex][i]]);
+                    MeshData.Triangles.Add(EdgeVertexIndex[MarchingCubesTables::TriTable[CubeIndex][i + 1]]);
+                    MeshData.Triangles.Add(EdgeVertexIndex[MarchingCubesTables::TriTable[CubeIndex][i + 2]]);
+                }
             }
         }
+
+        // Every edge vertex of the boundary planes between slices z and z + 1 is in the cache now
+        if (bHasSeams)
+        {
+            for (int32 Edge = 0; Edge < FChunkSeams::NumEdges; Edge++)
+            {
+                if (Seams.CoarserLODs[Edge] > 0)
+                    StitchEdge(Edge, z);
+            }
+        }
+    }
+
+    // Every vertex sits on a grid edge whose samples straddle the surface: within one voxel of the noise band, inside the field
+    const float SurfaceHalfHeight = FMath::Min(GenData.SurfaceLevel, DensityGen.GetNoiseBound() + 1.f) * GenData.VoxelSize;
+    // Seam vertices go after the interior ones
+    const int32 NumInterior = LocalPositions.Num();
+    for (int32 &Index : MeshData.Triangles)
+    {
+        if (Index & SeamVertexTag)
+            Index = NumInterior + (Index & ~SeamVertexTag);
     }
+    MeshData.Normals.Append(SeamNormals);
+
+    MeshData.SetPositions(LocalPositions, SeamPositions, FMathUtils::GetChunkQuantizationBox(LODLevel, GenData.PlanetRadius, SurfaceHalfHeight));
     return MeshData;
-}
\ No newline at end of file
+}
+
+
+FVector MeshGenerator::GetGridGradient(const GenData &Field, int32 x, int32 y, int32 z)
+{
+    const int32 Last = Field.SampleCount - 1;
+
+    // Neighbour samples along each grid axis (clamped to the field on the borders)
+    const int32 X0 = FMath::Max(x - 1, 0), X1 = FMath::Min(x + 1, Last);
+    const int32 Y0 = FMath::Max(y - 1, 0), Y1 = FMath::Min(y + 1, Last);
+    const int32 Z0 = FMath::Max(z - 1, 0), Z1 = FMath::Min(z + 1, Last);
+
+    // The spherified grid is close to orthogonal (radial axis exactly, face axes approximately),
+    // so each axis contributes dDensity / |dP|^2 * dP.
+    FVector Gradient = FVector::ZeroVector;
+    auto AddAxis = [&Field, &Gradient](int32 ax, int32 ay, int32 az, int32 bx, int32 by, int32 bz)
+    {
+        const FVector Delta = Field.GetPosition(bx, by, bz) - Field.GetPosition(ax, ay, az);
+        const float LengthSq = Delta.SizeSquared();
+        if (LengthSq > SMALL_NUMBER)
+        {
+            const float DeltaDensity = Field.Densities[Field.GetIndex(bx, by, bz)] - Field.Densities[Field.GetIndex(ax, ay, az)];
+            Gradient += Delta * (DeltaDensity / LengthSq);
+        }
+    };
+
+    AddAxis(X0, y, z, X1, y, z);
+    AddAxis(x, Y0, z, x, Y1, z);
+    AddAxis(x, y, Z0, x, y, Z1);
+
+    return Gradient;
+}
+
+void MeshGenerator::GetSeamSample(const GenData &Field, const FChunkSeams &Seams, int32 x, int32 y, int32 z, float &OutDensity, FVector &OutPosition)
+{
+    const int32 Last = Field.SampleCount - 1;
+
+    // Chunk corners are neighbour grid points on both edges, so a sample is interpolated along one edge at most
+    if (x == 0 || x == Last)
+    {
+        const int32 Span = Seams.GetSpan(x == 0 ? FChunkSeams::NegX : FChunkSeams::PosX);
+        const int32 Offset = y % Span;
+        if (Offset != 0)
+        {
+            const int32 Y0 = y - Offset;
+            const float T = (float)Offset / Span;
+            OutDensity = FMath::Lerp(Field.Densities[Field.GetIndex(x, Y0, z)], Field.Densities[Field.GetIndex(x, Y0 + Span, z)], T);
+            OutPosition = FMath::Lerp(Field.GetPosition(x, Y0, z), Field.GetPosition(x, Y0 + Span, z), T);
+            return;
+        }
+    }
+
+    if (y == 0 || y == Last)
+    {
+        const int32 Span = Seams.GetSpan(y == 0 ? FChunkSeams::NegY : FChunkSeams::PosY);
+        const int32 Offset = x % Span;
+        if (Offset != 0)
+        {
+            const int32 X0 = x - Offset;
+            const float T = (float)Offset / Span;
+            OutDensity = FMath::Lerp(Field.Densities[Field.GetIndex(X0, y, z)], Field.Densities[Field.GetIndex(X0 + Span, y, z)], T);
+            OutPosition = FMath::Lerp(Field.GetPosition(X0, y, z), Field.GetPosition(X0 + Span, y, z), T);
+            return;
+        }
+    }
+
+    OutDensity = Field.Densities[Field.GetIndex(x, y, z)];
+    OutPosition = Field.GetPosition(x, y, z);
+}
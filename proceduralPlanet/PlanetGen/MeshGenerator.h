@@ -11,7 +11,31 @@ class MeshGenerator
 {
     public:
         // Generates mesh data from density data using Marching Cubes.
-        // Thread-safe.
+        // Thread-safe. CancelFlag, if set, is polled between z-slices: once raised an empty mesh is returned.
         static FChunkMeshData GenerateMesh(const GenData &GenData, int32 Resolution, const FTransform &ChunkTransform, const FTransform &PlanetTransform,
-                                           int32 LODLevel, const DensityGenerator &DensityGen);
+                                           int32 LODLevel, const DensityGenerator &DensityGen, const FThreadSafeBool *CancelFlag = nullptr);
+
+        // Same, over a field that is still being filled: WaitForSlice(s) is called with a non-decreasing s before any slice <= s is read,
+        // so marching can trail the density slabs instead of waiting for the whole field.
+        // Edges in Seams border a coarser neighbour: their crossings are made to match the neighbour's and the remaining gaps,
+        // all in the boundary plane, are filled with triangles over the existing edge vertices.
+        static FChunkMeshData GenerateMesh(const GenData &GenData, int32 Resolution, const FTransform &ChunkTransform, const FTransform &PlanetTransform,
+                                           int32 LODLevel, const DensityGenerator &DensityGen, TFunctionRef<void(int32 Slice)> WaitForSlice,
+                                           const FThreadSafeBool *CancelFlag = nullptr, const FChunkSeams &Seams = FChunkSeams());
+
+    private:
+        // The marching cubes pass behind GenerateMesh. StaticResolution > 0 fixes the grid at compile time: constant strides and
+        // corner offsets, instantiated for 16, 32 and 64. StaticResolution 0 is the generic kernel for any other resolution.
+        template<int32 StaticResolution>
+        static FChunkMeshData GenerateMeshKernel(const GenData &GenData, int32 InResolution, const FTransform &ChunkTransform,
+                                                 const FTransform &PlanetTransform, int32 LODLevel, const DensityGenerator &DensityGen,
+                                                 TFunctionRef<void(int32 Slice)> WaitForSlice, const FThreadSafeBool *CancelFlag, const FChunkSeams &Seams);
+
+        // Density gradient at a grid sample from central differences over the field (one-sided on the borders).
+        // Planet space, density units per world unit. Used by EChunkNormalMode::DensityGrid.
+        static FVector GetGridGradient(const GenData &Field, int32 x, int32 y, int32 z);
+
+        // Sample as the mesher sees it. On a stitched edge, samples between the coarser neighbour's grid points are replaced
+        // by the linear interpolation of those points, density and chord position, exactly what the neighbour's cell edge sees.
+        static void GetSeamSample(const GenData &Field, const FChunkSeams &Seams, int32 x, int32 y, int32 z, float &OutDensity, FVector &OutPosition);
 };
\ No newline at end of file
@@ -4,8 +4,11 @@
 #include "Engine/StaticMeshActor.h"
 #include "Engine/Engine.h"
 #include "DrawDebugHelpers.h"
+#include "EngineUtils.h"
 #include "Kismet/GameplayStatics.h"
 #include "ProceduralMeshComponent.h"
+#include "PlanetSubsystem.h"
+#include "Misc/ScopeRWLock.h"
 
 
 // Sets default values
@@ -60,9 +63,22 @@ void APlanet::Tick(float DeltaTime)
     LocalContext.ObserverForward = PlanetTransform.InverseTransformVector(WorldContext.ObserverForward);
     LocalContext.ObserverVelocity = PlanetTransform.InverseTransformVector(WorldContext.ObserverVelocity);
     LocalContext.ViewDistance = WorldContext.ViewDistance;
+    for (const FVector &ActorLocation : WorldContext.PhysicsActorLocations)
+    {
+        LocalContext.PhysicsActorLocations.Add(PlanetTransform.InverseTransformPosition(ActorLocation));
+    }
+
+    // The world's generation budget is split between its planets. A planet with nothing to do behind its far model is not updated.
+    const FPlanetBudgetShare *Share = nullptr;
+    if (UPlanetSubsystem *Subsystem = GetPlanetSubsystem())
+        Share = Subsystem->GetShare(this, WorldContext.ObserverLocation);
+
+    if (Share && ChunkManager.IsValid())
+        ChunkManager->SetGenerationBudget(Share->Budget);
 
     // Update Manager with LOCAL context
-    UpdateChunkManager(LocalContext);
+    if (!Share || !Share->bSkipUpdate)
+        UpdateChunkManager(LocalContext);
 
     // Update Far Model & Debug with WORLD context
     UpdateFarModelVisibility(WorldContext);
@@ -93,9 +109,16 @@ void APlanet::GeneratePlanet()
 
 void APlanet::ClearPlanet()
 {
+    if (UPlanetSubsystem *Subsystem = GetPlanetSubsystem())
+        Subsystem->UnregisterPlanet(this);
+
     // Reset Managers (Destroys ChunkManager, Renderer, and Chunks)
     ChunkManager.Reset();
-    Generator.Reset();
+    {
+        // Queries still running hold their own reference: the generator is freed when the last one returns
+        FWriteScopeLock Lock(GeneratorLock);
+        Generator.Reset();
+    }
     NoiseProvider.Reset();
 
     // Destroy Far Model if we created it
@@ -113,6 +136,25 @@ void APlanet::ClearPlanet()
 }
 
 
+bool APlanet::NeedsChunkUpdate(const FVector &ObserverLocation) const
+{
+    if (!ChunkManager.IsValid())
+        return false;
+
+    if (!IsFarModelVisible())
+        return true;
+
+    return !ChunkManager->IsIdle() || ChunkManager->IsInGenerationRange(GetActorTransform().InverseTransformPosition(ObserverLocation));
+}
+
+
+UPlanetSubsystem *APlanet::GetPlanetSubsystem() const
+{
+    UWorld *World = GetWorld();
+    return World ? World->GetSubsystem<UPlanetSubsystem>() : nullptr;
+}
+
+
 FVector APlanet::GetGravityDirection(const FVector &WorldLocation) const
 {
     // Gravity pulls towards the actor location (Planet Center)
@@ -120,6 +162,87 @@ FVector APlanet::GetGravityDirection(const FVector &WorldLocation) const
 }
 
 
+TSharedPtr<const DensityGenerator, ESPMode::ThreadSafe> APlanet::GetQueryGenerator() const
+{
+    FReadScopeLock Lock(GeneratorLock);
+    return Generator;
+}
+
+
+bool APlanet::GetSurfaceLocation(const FVector &WorldLocation, FVector &OutSurfaceLocation) const
+{
+    const TSharedPtr<const DensityGenerator, ESPMode::ThreadSafe> QueryGenerator = GetQueryGenerator();
+    if (!QueryGenerator.IsValid())
+        return false;
+
+    const FTransform PlanetTransform = GetActorTransform();
+    const FVector Local = PlanetTransform.InverseTransformPosition(WorldLocation);
+    const FVector Direction = Local.GetSafeNormal(SMALL_NUMBER, FVector::UpVector);
+    const float StartRadius = Local.Size();
+
+    float SurfaceRadius;
+    QueryGenerator->FindSurfaceRadii(&Direction, &StartRadius, 1, &SurfaceRadius);
+    OutSurfaceLocation = PlanetTransform.TransformPosition(Direction * SurfaceRadius);
+    return true;
+}
+
+
+bool APlanet::GetSurfaceLocations(const TArray<FVector> &WorldLocations, TArray<FVector> &OutSurfaceLocations) const
+{
+    const TSharedPtr<const DensityGenerator, ESPMode::ThreadSafe> QueryGenerator = GetQueryGenerator();
+    if (!QueryGenerator.IsValid())
+        return false;
+
+    const FTransform PlanetTransform = GetActorTransform();
+    const int32 Count = WorldLocations.Num();
+    TArray<FVector> Directions;
+    TArray<float> Radii;
+    Directions.SetNumUninitialized(Count);
+    Radii.SetNumUninitialized(Count);
+    for (int32 i = 0; i < Count; i++)
+    {
+        const FVector Local = PlanetTransform.InverseTransformPosition(WorldLocations[i]);
+        Directions[i] = Local.GetSafeNormal(SMALL_NUMBER, FVector::UpVector);
+        Radii[i] = Local.Size();
+    }
+
+    // Start radii in, surface radii out
+    QueryGenerator->FindSurfaceRadii(Directions.GetData(), Radii.GetData(), Count, Radii.GetData());
+
+    OutSurfaceLocations.SetNumUninitialized(Count);
+    for (int32 i = 0; i < Count; i++)
+    {
+        OutSurfaceLocations[i] = PlanetTransform.TransformPosition(Directions[i] * Radii[i]);
+    }
+    return true;
+}
+
+
+bool APlanet::TraceSurface(const FVector &Start, const FVector &End, FVector &OutHitLocation, FVector &OutHitNormal) const
+{
+    const TSharedPtr<const DensityGenerator, ESPMode::ThreadSafe> QueryGenerator = GetQueryGenerator();
+    if (!QueryGenerator.IsValid())
+        return false;
+
+    const FTransform PlanetTransform = GetActorTransform();
+    const FVector LocalStart = PlanetTransform.InverseTransformPosition(Start);
+    const FVector LocalDelta = PlanetTransform.InverseTransformPosition(End) - LocalStart;
+    const float Length = LocalDelta.Size();
+    if (Length < KINDA_SMALL_NUMBER)
+        return false;
+
+    const FVector Direction = LocalDelta / Length;
+    float HitDistance;
+    if (!QueryGenerator->RaycastSurface(LocalStart, Direction, Length, HitDistance))
+        return false;
+
+    const FVector LocalHit = LocalStart + Direction * HitDistance;
+    OutHitLocation = PlanetTransform.TransformPosition(LocalHit);
+    OutHitNormal = PlanetTransform.TransformVectorNoScale(QueryGenerator->GetNormalAtPos(LocalHit));
+    return true;
+}
+
+
 void APlanet::initPlanet()
 {
     // Handle Visuals (Far Model)
@@ -146,21 +269,41 @@ void APlanet::initPlanet()
     RuntimeConfig.ChunksPerFace = FinalChunksPerFace;  // The calculated value!
     RuntimeConfig.Seed = GenSettings.Seed;
     RuntimeConfig.bEnableCollision = GenSettings.bEnableCollision;
+    RuntimeConfig.CollisionRadius = GenSettings.CollisionRadius;
+    RuntimeConfig.CollisionLODCount = GenSettings.CollisionLODCount;
+    RuntimeConfig.CollisionDecimation = GenSettings.CollisionDecimation;
+    RuntimeConfig.MaxConcurrentCollisionBuilds = PerformanceSettings.MaxConcurrentCollisionBuilds;
+    RuntimeConfig.CollisionCookBudgetMs = PerformanceSettings.CollisionCookBudgetMs;
     RuntimeConfig.bCastShadows = GenSettings.bCastShadows;
     RuntimeConfig.VoxelSize = FinalVoxelSize;
     RuntimeConfig.GridResolution = FinalResolution;
     RuntimeConfig.MaxConcurrentGenerations = PerformanceSettings.MaxConcurrentGenerations;
     RuntimeConfig.ChunkGenerationRate = PerformanceSettings.ChunksToSpawnPerFrame;
     RuntimeConfig.MeshUpdatesPerFrame = PerformanceSettings.MeshUpdatesPerFrame;
+    RuntimeConfig.MeshUploadBudgetMs = PerformanceSettings.MeshUploadBudgetMs;
+    RuntimeConfig.RenderBackend = PerformanceSettings.RenderBackend;
+    RuntimeConfig.DensityBackend = PerformanceSettings.DensityBackend;
+    RuntimeConfig.bEnableDiskCache = PerformanceSettings.bEnableDiskCache;
+    RuntimeConfig.DiskCacheMaxSizeMB = PerformanceSettings.DiskCacheMaxSizeMB;
+    RuntimeConfig.MeshCacheBudgetMB = PerformanceSettings.MeshCacheBudgetMB;
+    RuntimeConfig.MeshMemoryBudgetMB = PerformanceSettings.MeshMemoryBudgetMB;
+    RuntimeConfig.GPUMemoryBudgetMB = PerformanceSettings.GPUMemoryBudgetMB;
+    RuntimeConfig.MaxResidentComponents = PerformanceSettings.MaxResidentComponents;
+    RuntimeConfig.bReleaseMeshDataAfterUpload = PerformanceSettings.bReleaseMeshDataAfterUpload;
     RuntimeConfig.FarDistanceThreshold = GenSettings.PlanetRadius * GenSettings.RenderDistanceMultiplier;
     RuntimeConfig.LODSplitDistanceMultiplier = GridSettings.LODSplitMultiplier;
     RuntimeConfig.LODMergeHysteresisRatio = GridSettings.LODMergeHysteresisRatio;
     RuntimeConfig.MaxLookAheadTime = PerformanceSettings.MaxLookAheadTime;
     RuntimeConfig.MinLookAheadTime = PerformanceSettings.MinLookAheadTime;
     RuntimeConfig.LookAheadAltitudeScale = PerformanceSettings.LookAheadAltitudeRadiusFactor * GenSettings.PlanetRadius;
+    RuntimeConfig.MaxPrefetchChunks = PerformanceSettings.MaxPrefetchChunks;
+    RuntimeConfig.bEnableCulling = PerformanceSettings.bEnableCulling;
+    RuntimeConfig.bIncrementalQuadtree = PerformanceSettings.bIncrementalQuadtree;
+    RuntimeConfig.bReuseParentDensity = PerformanceSettings.bReuseParentDensity;
+    RuntimeConfig.MaxTerrainHeight = NoiseSettings.Amplitude;
 
     // Create Noise Provider
-    NoiseProvider = MakeUnique<SimpleNoise>();
+    NoiseProvider = MakeShared<SimpleNoise, ESPMode::ThreadSafe>();
 
     // Create density config and init the generator
     DensityConfig densityConfig;
@@ -168,11 +311,21 @@ void APlanet::initPlanet()
     densityConfig.Seed = GenSettings.Seed;
     densityConfig.VoxelSize = FinalVoxelSize;
     densityConfig.Noise = NoiseSettings;
-    Generator = MakeUnique<DensityGenerator>(densityConfig, NoiseProvider.Get());
+    densityConfig.NormalMode = GridSettings.NormalMode;
+    TSharedPtr<const DensityGenerator, ESPMode::ThreadSafe> NewGenerator(new DensityGenerator(densityConfig, NoiseProvider.Get()),
+                                                                         [Noise = NoiseProvider](const DensityGenerator *Gen) { delete Gen; });
+    {
+        FWriteScopeLock Lock(GeneratorLock);
+        Generator = NewGenerator;
+    }
 
     // Finally, init the ChunkManager
     ChunkManager = MakeUnique<FChunkManager>(RuntimeConfig, Generator.Get());
     ChunkManager->Initialize(this, GenSettings.DebugMaterial);  // Pass context for rendering
+
+    // Generation tasks in flight come out of the world's shared budget
+    if (UPlanetSubsystem *Subsystem = GetPlanetSubsystem())
+        Subsystem->RegisterPlanet(this);
 }
 
 
@@ -272,6 +425,16 @@ FPlanetViewContext APlanet::BuildViewContext() const
             if (IsValid(PlayerPawn))
                 Context.ObserverVelocity = PlayerPawn->GetVelocity();
         }
+
+        // Every pawn (player or AI) needs the ground under it, not only the observer
+        if (RuntimeConfig.bEnableCollision)
+        {
+            for (TActorIterator<APawn> It(World); It; ++It)
+            {
+                if (IsValid(*It))
+                    Context.PhysicsActorLocations.Add(It->GetActorLocation());
+            }
+        }
     }
 
 
@@ -396,5 +559,174 @@ void APlanet::DrawDebugInfo(const FPlanetViewContext &Context) const
             FColor::Yellow,
             FString::Printf(
                 TEXT("[LOD Threshold] Split < %.0fm | Merge > %.0fm | Dist: %.0fm"), NextSplitDist / 100.f, NextMergeDist / 100.f, ClosestChunkDist / 100.f));
+
+        // --- onscreen debug line 5: Generation queue depth and wait time per LOD ---
+        TArray<FGenerationQueueStats> QueueStats;
+        QueueStats.SetNum(RuntimeConfig.MaxLOD + 1);
+        ChunkManager->GetGenerationQueueStats(QueueStats);
+
+        FString QueueStr = TEXT("[GenQueue] ");
+        for (int32 i = 0; i <= RuntimeConfig.MaxLOD; ++i)
+        {
+            if (QueueStats[i].QueuedCount > 0)
+            {
+                QueueStr += FString::Printf(
+                    TEXT("L%d:%d (avg %.2fs, max %.2fs)  "), i, QueueStats[i].QueuedCount, QueueStats[i].AvgWaitSeconds, QueueStats[i].MaxWaitSeconds);
+            }
+        }
+        GEngine->AddOnScreenDebugMessage(FPlanetStatics::DebugKey_GenQueueStats, 0.f, FColor::Orange, QueueStr);
+
+        const FGenerationCancelStats CancelStats = ChunkManager->GetGenerationCancelStats();
+        GEngine->AddOnScreenDebugMessage(FPlanetStatics::DebugKey_CancelStats,
+                                         0.f,
+                                         FColor::Orange,
+                                         FString::Printf(TEXT("[Cancelled] Tasks: %d (early exit: %d) | Wasted worker time: %.2fs"),
+                                                         CancelStats.CancelledCount,
+                                                         CancelStats.EarlyExitCount,
+                                                         CancelStats.WastedSeconds));
+
+        // --- onscreen debug line 6: Disk cache ---
+        if (RuntimeConfig.bEnableDiskCache)
+        {
+            int32 CacheHits, CacheMisses;
+            ChunkManager->GetDiskCacheStats(CacheHits, CacheMisses);
+            const int32 CacheLookups = CacheHits + CacheMisses;
+            GEngine->AddOnScreenDebugMessage(FPlanetStatics::DebugKey_DiskCacheStats,
+                                             0.f,
+                                             FColor::Orange,
+                                             FString::Printf(TEXT("[DiskCache] Hits: %d | Misses: %d | Hit rate: %.0f%%"),
+                                                             CacheHits,
+                                                             CacheMisses,
+                                                             CacheLookups > 0 ? 100.f * CacheHits / CacheLookups : 0.f));
+        }
+
+        // --- onscreen debug line 7: Mesh upload budget ---
+        const FMeshUploadStats &UploadStats = ChunkManager->GetUploadStats();
+        GEngine->AddOnScreenDebugMessage(FPlanetStatics::DebugKey_UploadStats,
+                                         0.f,
+                                         FColor::Orange,
+                                         FString::Printf(TEXT("[Upload] %.2f / %.2f ms (avg %.2f, peak %.2f) | Uploaded: %d | Backlog: %d"),
+                                                         UploadStats.LastFrameMs,
+                                                         RuntimeConfig.MeshUploadBudgetMs,
+                                                         UploadStats.AverageFrameMs,
+                                                         UploadStats.PeakFrameMs,
+                                                         UploadStats.UploadedLastFrame,
+                                                         UploadStats.Backlog));
+
+        // --- onscreen debug line 8: Quadtree update and culling ---
+        if (const FPlanetQuadtree *Quadtree = ChunkManager->GetQuadtree())
+        {
+            GEngine->AddOnScreenDebugMessage(FPlanetStatics::DebugKey_QuadtreeStats,
+                                             0.f,
+                                             FColor::Orange,
+                                             FString::Printf(TEXT("[Quadtree] Visited: %d / %d nodes | Leaves +%d -%d"),
+                                                             Quadtree->GetVisitedNodeCount(),
+                                                             Quadtree->GetNodeCount(),
+                                                             Quadtree->GetAddedLeaves().Num(),
+                                                             Quadtree->GetRemovedLeaves().Num()));
+
+            if (RuntimeConfig.bEnableCulling)
+            {
+                const int32 HorizonCulled = Quadtree->GetHorizonCulledCount();
+                const int32 FrustumCulled = Quadtree->GetFrustumCulledCount();
+                GEngine->AddOnScreenDebugMessage(FPlanetStatics::DebugKey_CullingStats,
+                                                 0.f,
+                                                 FColor::Orange,
+                                                 FString::Printf(TEXT("[Culling] Culled nodes: %d (Horizon: %d | View: %d)"),
+                                                                 HorizonCulled + FrustumCulled,
+                                                                 HorizonCulled,
+                                                                 FrustumCulled));
+            }
+        }
+
+#if PLANET_TRACK_UPDATE_ALLOCATIONS
+        // --- onscreen debug line 8b: Update loop container growth (should stop once the working set is stable) ---
+        const FUpdateAllocationStats &AllocStats = ChunkManager->GetUpdateAllocationStats();
+        GEngine->AddOnScreenDebugMessage(FPlanetStatics::DebugKey_UpdateAllocStats,
+                                         0.f,
+                                         FColor::Orange,
+                                         FString::Printf(TEXT("[UpdateAlloc] Grew on %d / %llu frames (last +%.1f KB) | Footprint: %.1f KB"),
+                                                         AllocStats.GrowthFrames,
+                                                         AllocStats.FrameCount,
+                                                         AllocStats.LastGrowthBytes / 1024.f,
+                                                         AllocStats.FootprintBytes / 1024.f));
+#endif
+
+        // --- onscreen debug line 9: Predictive prefetch ---
+        if (RuntimeConfig.MaxPrefetchChunks > 0)
+        {
+            const FPrefetchStats &Prefetch = ChunkManager->GetPrefetchStats();
+            const int32 Demanded = Prefetch.ReadyInTime + Prefetch.Late + Prefetch.Unpredicted;
+            GEngine->AddOnScreenDebugMessage(FPlanetStatics::DebugKey_PrefetchStats,
+                                             0.f,
+                                             FColor::Orange,
+                                             FString::Printf(TEXT("[Prefetch] Ahead: %d | Ready in time: %d | Late: %d | Unpredicted: %d | Hit rate: %.0f%%"),
+                                                             Prefetch.InFlight,
+                                                             Prefetch.ReadyInTime,
+                                                             Prefetch.Late,
+                                                             Prefetch.Unpredicted,
+                                                             Demanded > 0 ? 100.f * Prefetch.ReadyInTime / Demanded : 0.f));
+        }
+
+        // --- onscreen debug line 10: Released mesh cache ---
+        if (const FChunkMeshCache *MeshCache = ChunkManager->GetMeshCache())
+        {
+            const int32 CacheLookups = MeshCache->GetHitCount() + MeshCache->GetMissCount();
+            GEngine->AddOnScreenDebugMessage(FPlanetStatics::DebugKey_MeshCacheStats,
+                                             0.f,
+                                             FColor::Orange,
+                                             FString::Printf(TEXT("[MeshCache] %d chunks, %.1f MB | Hits: %d | Misses: %d | Hit rate: %.0f%%"),
+                                                             MeshCache->Num(),
+                                                             MeshCache->GetSizeBytes() / (1024.f * 1024.f),
+                                                             MeshCache->GetHitCount(),
+                                                             MeshCache->GetMissCount(),
+                                                             CacheLookups > 0 ? 100.f * MeshCache->GetHitCount() / CacheLookups : 0.f));
+        }
+
+        // --- onscreen debug line 11: Collision cooking ---
+        if (const FChunkCollisionManager *Collision = ChunkManager->GetCollisionManager())
+        {
+            const FCollisionStats &CollisionStats = Collision->GetStats();
+            GEngine->AddOnScreenDebugMessage(FPlanetStatics::DebugKey_CollisionStats,
+                                             0.f,
+                                             FColor::Orange,
+                                             FString::Printf(TEXT("[Collision] Chunks: %d | Building: %d | Cooked: %d (%.2f / %.2f ms) | Kept: %.0f%% tris"),
+                                                             CollisionStats.CollidingChunks,
+                                                             CollisionStats.BuildsInFlight,
+                                                             CollisionStats.CookedLastFrame,
+                                                             CollisionStats.LastFrameMs,
+                                                             RuntimeConfig.CollisionCookBudgetMs,
+                                                             CollisionStats.SourceTriangles > 0
+                                                                 ? 100.f * CollisionStats.CollisionTriangles / CollisionStats.SourceTriangles
+                                                                 : 100.f));
+        }
+
+        // --- onscreen debug line 12: Resident memory against its budget ---
+        const FResidentMemoryStats &Memory = ChunkManager->GetMemoryStats();
+        GEngine->AddOnScreenDebugMessage(FPlanetStatics::DebugKey_MemoryStats,
+                                         0.f,
+                                         Memory.bOverBudget ? FColor::Red : FColor::Orange,
+                                         FString::Printf(TEXT("[Memory] CPU: %.1f / %d MB | GPU: %.1f / %d MB | Components: %d / %d | Evicted: %d%s"),
+                                                         Memory.GetCPUBytes() / (1024.f * 1024.f),
+                                                         RuntimeConfig.MeshMemoryBudgetMB,
+                                                         Memory.GPUBytes / (1024.f * 1024.f),
+                                                         RuntimeConfig.GPUMemoryBudgetMB,
+                                                         Memory.Components,
+                                                         RuntimeConfig.MaxResidentComponents,
+                                                         Memory.EvictedChunks,
+                                                         Memory.bPrefetchSuspended ? TEXT(" | Prefetch paused") : TEXT("")));
+
+        // --- onscreen debug line 13: Share of the world's generation budget ---
+        if (const UPlanetSubsystem *Subsystem = GetPlanetSubsystem())
+        {
+            GEngine->AddOnScreenDebugMessage(FPlanetStatics::DebugKey_BudgetStats,
+                                             0.f,
+                                             FColor::Orange,
+                                             FString::Printf(TEXT("[Budget] Tasks: %d / %d (world: %d, %d planets)"),
+                                                             ChunkManager->GetActiveGenerationCount(),
+                                                             ChunkManager->GetGenerationBudget(),
+                                                             UPlanetSubsystem::GetTotalBudget(),
+                                                             Subsystem->GetShares().Num()));
+        }
     }
 }
\ No newline at end of file
@@ -20,8 +20,12 @@ class PROCEDURALPLANET_API APlanet : public AActor
         USceneComponent *Root;
 
         TUniquePtr<FChunkManager> ChunkManager;
-        TUniquePtr<SimpleNoise> NoiseProvider;
-        TUniquePtr<DensityGenerator> Generator;
+        TSharedPtr<SimpleNoise, ESPMode::ThreadSafe> NoiseProvider;
+
+        // Shared with the surface queries, which can run on any thread: each one takes its own reference first
+        // (GetQueryGenerator), so ClearPlanet never frees the generator under a query. Its deleter keeps the noise alive.
+        TSharedPtr<const DensityGenerator, ESPMode::ThreadSafe> Generator;
+        mutable FRWLock GeneratorLock;  // Guards the Generator pointer itself, not the generator
 
         // Stores the finalized configuration after initPlanet() runs.
         FPlanetConfig RuntimeConfig;
@@ -44,9 +48,13 @@ class PROCEDURALPLANET_API APlanet : public AActor
         // Tick Helpers
         FPlanetViewContext BuildViewContext() const;
         void UpdateChunkManager(const FPlanetViewContext &Context);
+        class UPlanetSubsystem *GetPlanetSubsystem() const;
         void UpdateFarModelVisibility(const FPlanetViewContext &Context);
         void DrawDebugInfo(const FPlanetViewContext &Context) const;
 
+        // Reference to the current generator for a surface query, null if the planet is not generated. Any thread.
+        TSharedPtr<const DensityGenerator, ESPMode::ThreadSafe> GetQueryGenerator() const;
+
     public:
         APlanet();
         virtual void BeginPlay() override;
@@ -61,10 +69,36 @@ class PROCEDURALPLANET_API APlanet : public AActor
         UFUNCTION(CallInEditor, Category = "Planet|Generation")
         void ClearPlanet();
 
+        // --- Multi-planet scheduling (UPlanetSubsystem) ---
+
+        bool IsFarModelVisible() const { return GenSettings.FarPlanetModel && !GenSettings.FarPlanetModel->IsHidden(); }
+
+        // False while the far model is shown, the observer (world space) is out of generation range and the chunk manager
+        // has released everything: its update would have nothing to do.
+        bool NeedsChunkUpdate(const FVector &ObserverLocation) const;
+
         // Returns the normalized direction of gravity (pointing towards planet center) at a specific location.
         UFUNCTION(BlueprintCallable, Category = "Planet|Physics")
         FVector GetGravityDirection(const FVector &WorldLocation) const;
 
+        // --- Surface queries ---
+        // Answered from the density field itself: they work anywhere on the planet, whether chunks or collision exist there or not.
+        // Thread-safe, also against a concurrent ClearPlanet or GeneratePlanet (the query answers from the generator it started with),
+        // as long as the planet is not moved concurrently.
+
+        // First terrain surface below WorldLocation, on the line to the planet center (above it if WorldLocation is underground).
+        // False if the planet is not generated.
+        UFUNCTION(BlueprintCallable, Category = "Planet|Queries")
+        bool GetSurfaceLocation(const FVector &WorldLocation, FVector &OutSurfaceLocation) const;
+
+        // Batched GetSurfaceLocation, for many agents at once: all locations share every noise evaluation batch.
+        UFUNCTION(BlueprintCallable, Category = "Planet|Queries")
+        bool GetSurfaceLocations(const TArray<FVector> &WorldLocations, TArray<FVector> &OutSurfaceLocations) const;
+
+        // First terrain hit on the segment, sphere-traced through the density field. The normal is the analytic density gradient.
+        UFUNCTION(BlueprintCallable, Category = "Planet|Queries")
+        bool TraceSurface(const FVector &Start, const FVector &End, FVector &OutHitLocation, FVector &OutHitNormal) const;
+
         // Generation Control
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Generation")
         bool bGenerateOnBeginPlay = true;
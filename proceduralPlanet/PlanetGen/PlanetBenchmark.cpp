@@ -0,0 +1,292 @@
+#include "PlanetBenchmark.h"
+
+#if PLANET_WITH_BENCHMARK
+
+#include "ChunkMeshComponent.h"
+#include "DensityGenerator.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "MathUtils.h"
+#include "MeshGenerator.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "SimpleNoise.h"
+
+
+namespace
+{
+// Fixed planet: changing any of these invalidates the golden hashes
+constexpr int32 BenchmarkSeed = 1337;
+constexpr float BenchmarkRadius = 10000.f;
+constexpr int32 BenchmarkMaxLOD = 6;
+const int32 BenchmarkResolutions[] = {16, 32, 64};
+
+
+template<typename T> uint32 HashArray(const TArray<T> &Array, uint32 Crc) { return FCrc::MemCrc32(Array.GetData(), Array.Num() * sizeof(T), Crc); }
+}  // namespace
+
+
+FPlanetBenchmark::FPlanetBenchmark(int32 InIterations) :
+    Iterations(FMath::Max(1, InIterations))
+{
+}
+
+
+TArray<FPlanetBenchmarkCase> FPlanetBenchmark::GetCases()
+{
+    TArray<FPlanetBenchmarkCase> Cases;
+    for (int32 Resolution : BenchmarkResolutions)
+    {
+        for (int32 LOD = 0; LOD <= BenchmarkMaxLOD; LOD++)
+        {
+            // Corner chunks sit where the cube-to-sphere warp is strongest, center chunks where it is weakest
+            const int32 Center = (1 << LOD) / 2;
+            Cases.Add({FChunkId(0, FIntVector(0, 0, 0), LOD), Resolution});
+            if (Center != 0)
+                Cases.Add({FChunkId(0, FIntVector(Center, Center, 0), LOD), Resolution});
+        }
+    }
+    return Cases;
+}
+
+
+FString FPlanetBenchmark::GetGoldenPath()
+{
+    return FPaths::Combine(FPaths::GameSourceDir(), TEXT("proceduralPlanet/PlanetGen/Tests/BenchmarkGolden.txt"));
+}
+
+
+FString FPlanetBenchmark::GetCaseKey(const FPlanetBenchmarkCase &Case)
+{
+    return FString::Printf(TEXT("F%d_L%d_%d_%d_R%d"), Case.Id.FaceIndex, Case.Id.LODLevel, Case.Id.Coords.X, Case.Id.Coords.Y, Case.Resolution);
+}
+
+
+void FPlanetBenchmark::Run()
+{
+    Results.Reset();
+
+    SimpleNoise Noise;
+
+    for (const FPlanetBenchmarkCase &Case : GetCases())
+    {
+        // Same voxel size as APlanet::CalculateAutoGrid with one root chunk per face
+        DensityConfig DensityCfg;
+        DensityCfg.Seed = BenchmarkSeed;
+        DensityCfg.PlanetRadius = BenchmarkRadius;
+        DensityCfg.VoxelSize = (BenchmarkRadius * HALF_PI) / Case.Resolution;
+        DensityCfg.NormalMode = EChunkNormalMode::AnalyticGradient;
+        const DensityGenerator DensityGen(DensityCfg, &Noise);
+
+        // Chunk setup exactly as FChunkGenerator::StartAsyncTask
+        const FChunkId &Id = Case.Id;
+        const FChunkTransform ChunkTransform = FMathUtils::ComputeChunkTransform(Id, BenchmarkRadius);
+        const FTransform Transform(ChunkTransform.Rotation, ChunkTransform.Location);
+
+        FVector2D UVMin, UVMax;
+        FMathUtils::GetChunkUVBounds(Id, UVMin, UVMax);
+        const FVector2D CubeMin = UVMin * 2.0f - 1.0f;
+        const FVector2D CubeMax = UVMax * 2.0f - 1.0f;
+        const FVector FaceNormal = FMathUtils::getFaceNormal(Id.FaceIndex);
+        const FVector FaceRight = FMathUtils::getFaceRight(Id.FaceIndex);
+        const FVector FaceUp = FMathUtils::getFaceUp(Id.FaceIndex);
+
+        FPlanetBenchmarkResult &Result = Results.AddDefaulted_GetRef();
+        Result.Case = Case;
+        Result.DensityMs = Result.MeshMs = Result.NormalsMs = Result.PackMs = DBL_MAX;
+
+        for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+        {
+            double StartTime = FPlatformTime::Seconds();
+            GenData Field = DensityGen.BeginDensityField(Case.Resolution, FaceNormal, FaceRight, FaceUp, CubeMin, CubeMax);
+            DensityGen.GenerateDensitySlab(Field, 0, Field.SampleCount);
+            Result.DensityMs = FMath::Min(Result.DensityMs, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+            StartTime = FPlatformTime::Seconds();
+            FChunkMeshData MeshData = MeshGenerator::GenerateMesh(Field, Case.Resolution, Transform, FTransform::Identity, Id.LODLevel, DensityGen);
+            Result.MeshMs = FMath::Min(Result.MeshMs, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+            // The mesher's vertices are chunk-local, its normal evaluations happen in planet space
+            StartTime = FPlatformTime::Seconds();
+            FVector NormalSum = FVector::ZeroVector;
+            for (int32 i = 0; i < MeshData.GetNumVertices(); i++)
+            {
+                NormalSum += DensityGen.GetNormalAtPos(Transform.TransformPosition(FVector(MeshData.GetPosition(i))));
+            }
+            Result.NormalsMs = FMath::Min(Result.NormalsMs, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+            StartTime = FPlatformTime::Seconds();
+            TSharedPtr<FChunkPackedMesh, ESPMode::ThreadSafe> Packed = FChunkPackedMesh::Build(MeshData);
+            Result.PackMs = FMath::Min(Result.PackMs, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+            uint32 Hash = HashArray(Field.Densities, 0);
+            Hash = FCrc::MemCrc32(&MeshData.QuantizationMin, sizeof(FVector3f), Hash);
+            Hash = FCrc::MemCrc32(&MeshData.QuantizationSize, sizeof(FVector3f), Hash);
+            Hash = HashArray(MeshData.Positions, Hash);
+            Hash = HashArray(MeshData.SeamPositions, Hash);
+            Hash = HashArray(MeshData.Triangles, Hash);
+            Hash = HashArray(MeshData.Normals, Hash);
+
+            if (Iteration == 0)
+            {
+                Result.Hash = Hash;
+                Result.Triangles = MeshData.Triangles.Num() / 3;
+                Result.WorkingSetBytes = Field.Densities.GetAllocatedSize() + Field.ColumnDirections.GetAllocatedSize() +
+                                         MeshData.Positions.GetAllocatedSize() + MeshData.SeamPositions.GetAllocatedSize() +
+                                         MeshData.Triangles.GetAllocatedSize() + MeshData.Normals.GetAllocatedSize() + MeshData.Colors.GetAllocatedSize() +
+                                         Packed->GetAllocatedSize();
+            }
+            else if (Hash != Result.Hash)
+            {
+                Result.bDeterministic = false;
+            }
+
+            // Keeps the normal loop from being optimized away
+            if (NormalSum.ContainsNaN())
+            {
+                Result.bDeterministic = false;
+            }
+        }
+    }
+
+    PeakUsedPhysical = FPlatformMemory::GetStats().PeakUsedPhysical;
+}
+
+
+FString FPlanetBenchmark::WriteReport(const FString &Directory) const
+{
+    IFileManager::Get().MakeDirectory(*Directory, true);
+
+    const FString BaseName = FPaths::Combine(Directory, FString::Printf(TEXT("Benchmark_%s"), *FDateTime::Now().ToString()));
+
+    FString Csv = TEXT("face,lod,x,y,resolution,density_ms,mesh_ms,normals_ms,pack_ms,total_ms,triangles,triangles_per_sec,working_set_bytes,hash,deterministic\n");
+
+    FString Json = TEXT("{\n");
+    Json += FString::Printf(TEXT("  \"seed\": %d,\n  \"radius\": %.1f,\n  \"iterations\": %d,\n"), BenchmarkSeed, BenchmarkRadius, Iterations);
+    Json += FString::Printf(TEXT("  \"peak_used_physical_bytes\": %llu,\n  \"cases\": [\n"), (unsigned long long)PeakUsedPhysical);
+
+    for (int32 i = 0; i < Results.Num(); i++)
+    {
+        const FPlanetBenchmarkResult &R = Results[i];
+        const FChunkId &Id = R.Case.Id;
+
+        Csv += FString::Printf(TEXT("%d,%d,%d,%d,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%d,%.0f,%lld,%08x,%d\n"), Id.FaceIndex, Id.LODLevel, Id.Coords.X, Id.Coords.Y,
+                               R.Case.Resolution, R.DensityMs, R.MeshMs, R.NormalsMs, R.PackMs, R.GetTotalMs(), R.Triangles, R.GetTrianglesPerSecond(),
+                               (long long)R.WorkingSetBytes, R.Hash, R.bDeterministic ? 1 : 0);
+
+        Json += FString::Printf(TEXT("    {\"face\": %d, \"lod\": %d, \"x\": %d, \"y\": %d, \"resolution\": %d, \"density_ms\": %.4f, \"mesh_ms\": %.4f, ")
+                                    TEXT("\"normals_ms\": %.4f, \"pack_ms\": %.4f, \"total_ms\": %.4f, \"triangles\": %d, \"triangles_per_sec\": %.0f, ")
+                                        TEXT("\"working_set_bytes\": %lld, \"hash\": \"%08x\", \"deterministic\": %s}%s\n"),
+                                Id.FaceIndex, Id.LODLevel, Id.Coords.X, Id.Coords.Y, R.Case.Resolution, R.DensityMs, R.MeshMs, R.NormalsMs, R.PackMs,
+                                R.GetTotalMs(), R.Triangles, R.GetTrianglesPerSecond(), (long long)R.WorkingSetBytes, R.Hash,
+                                R.bDeterministic ? TEXT("true") : TEXT("false"), i + 1 < Results.Num() ? TEXT(",") : TEXT(""));
+    }
+    Json += TEXT("  ]\n}\n");
+
+    const FString CsvPath = BaseName + TEXT(".csv");
+    if (!FFileHelper::SaveStringToFile(Csv, *CsvPath) || !FFileHelper::SaveStringToFile(Json, *(BaseName + TEXT(".json"))))
+        return FString();
+
+    return CsvPath;
+}
+
+
+bool FPlanetBenchmark::CheckGolden(const FString &GoldenPath, bool bUpdate, FString &OutMessage) const
+{
+    if (bUpdate)
+    {
+        FString Golden = TEXT("# Planet.Benchmark golden hashes: <case> <crc of the density field and mesh>.\n")
+                         TEXT("# Recorded with \"Planet.Benchmark 1 UpdateGolden\". Only valid for the platform and compiler that wrote them.\n");
+        for (const FPlanetBenchmarkResult &R : Results)
+        {
+            Golden += FString::Printf(TEXT("%s %08x\n"), *GetCaseKey(R.Case), R.Hash);
+        }
+
+        const bool bSaved = FFileHelper::SaveStringToFile(Golden, *GoldenPath);
+        OutMessage = bSaved ? FString::Printf(TEXT("golden hashes written to %s"), *GoldenPath) : FString::Printf(TEXT("could not write %s"), *GoldenPath);
+        return bSaved;
+    }
+
+    // A missing file is a failure: recording the current hashes here would make the check pass whatever the output
+    TArray<FString> Lines;
+    if (!IFileManager::Get().FileExists(*GoldenPath) || !FFileHelper::LoadFileToStringArray(Lines, *GoldenPath))
+    {
+        OutMessage = FString::Printf(TEXT("could not read %s"), *GoldenPath);
+        return false;
+    }
+
+    TMap<FString, uint32> GoldenHashes;
+    for (const FString &Line : Lines)
+    {
+        FString Key, Hash;
+        if (!Line.StartsWith(TEXT("#")) && Line.Split(TEXT(" "), &Key, &Hash))
+            GoldenHashes.Add(Key, FParse::HexNumber(*Hash));
+    }
+
+    int32 Mismatches = 0;
+    for (const FPlanetBenchmarkResult &R : Results)
+    {
+        const FString Key = GetCaseKey(R.Case);
+        const uint32 *Expected = GoldenHashes.Find(Key);
+        if (!Expected || *Expected != R.Hash || !R.bDeterministic)
+        {
+            OutMessage += FString::Printf(TEXT("%s%s: %s"), Mismatches ? TEXT(", ") : TEXT(""), *Key,
+                                          !Expected ? TEXT("missing") : (R.bDeterministic ? TEXT("hash changed") : TEXT("unstable")));
+            Mismatches++;
+        }
+    }
+
+    if (Mismatches == 0)
+        OutMessage = FString::Printf(TEXT("all %d cases match the golden hashes"), Results.Num());
+
+    return Mismatches == 0;
+}
+
+
+// ---------------------------------------------------------------------------
+// Console command
+// ---------------------------------------------------------------------------
+static void RunPlanetBenchmark(const TArray<FString> &Args)
+{
+    const int32 Iterations = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 3;
+    const bool bUpdateGolden = Args.ContainsByPredicate([](const FString &Arg) { return Arg.Equals(TEXT("UpdateGolden"), ESearchCase::IgnoreCase); });
+
+    FPlanetBenchmark Benchmark(Iterations);
+    Benchmark.Run();
+
+    const FString Directory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("PlanetBenchmark"));
+    const FString ReportPath = Benchmark.WriteReport(Directory);
+
+    double TotalMs = 0.0;
+    int64 TotalTriangles = 0;
+    for (const FPlanetBenchmarkResult &R : Benchmark.GetResults())
+    {
+        TotalMs += R.GetTotalMs();
+        TotalTriangles += R.Triangles;
+    }
+
+    FString GoldenMessage;
+    const bool bGoldenOk = Benchmark.CheckGolden(FPlanetBenchmark::GetGoldenPath(), bUpdateGolden, GoldenMessage);
+
+    UE_LOG(LogTemp, Display, TEXT("Planet.Benchmark: %d cases, %.1f ms, %.0f tris/s, peak %.1f MB. Report: %s"), Benchmark.GetResults().Num(), TotalMs,
+           TotalMs > 0.0 ? TotalTriangles / (TotalMs / 1000.0) : 0.0, Benchmark.GetPeakUsedPhysical() / (1024.0 * 1024.0),
+           ReportPath.IsEmpty() ? TEXT("<write failed>") : *ReportPath);
+
+    if (bGoldenOk)
+    {
+        UE_LOG(LogTemp, Display, TEXT("Planet.Benchmark: determinism OK, %s"), *GoldenMessage);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Error, TEXT("Planet.Benchmark: determinism FAILED, %s"), *GoldenMessage);
+    }
+}
+
+
+static FAutoConsoleCommand GPlanetBenchmarkCommand(TEXT("Planet.Benchmark"),
+                                                   TEXT("Headless chunk generation benchmark. Args: [Iterations=3] [UpdateGolden]. ")
+                                                       TEXT("Reports to Saved/PlanetBenchmark/"),
+                                                   FConsoleCommandWithArgsDelegate::CreateStatic(&RunPlanetBenchmark));
+
+#endif  // PLANET_WITH_BENCHMARK
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DataTypes.h"
+
+
+// Headless generation benchmark over a fixed set of chunks, fixed seed and noise, on the calling thread.
+// Console: "Planet.Benchmark [Iterations] [UpdateGolden]". Headless: -nullrhi -ExecCmds="Planet.Benchmark, Quit".
+// Writes Saved/PlanetBenchmark/Benchmark_<time>.csv and .json, and checks the generated data against the golden hashes
+// committed next to the tests (GetGoldenPath). The opt-in "Planet.Benchmark.Golden" stress test runs the same check.
+// Every stage runs single-threaded and back to back: the numbers cost the generation work itself, not the async pipeline
+// (slab parallelism, queueing, the game-thread upload). Not compiled into shipping builds.
+#define PLANET_WITH_BENCHMARK (!UE_BUILD_SHIPPING)
+
+#if PLANET_WITH_BENCHMARK
+
+struct FPlanetBenchmarkCase
+{
+        FChunkId Id;
+        int32 Resolution = 32;
+};
+
+
+// One case, times are the fastest of the iterations.
+struct FPlanetBenchmarkResult
+{
+        FPlanetBenchmarkCase Case;
+        double DensityMs = 0.0;      // BeginDensityField + GenerateDensitySlab over the whole field on one thread (the worker splits it into parallel slabs)
+        double MeshMs = 0.0;         // GenerateMesh, normals included
+        double NormalsMs = 0.0;      // The mesher's normal evaluations alone, re-run over the generated vertices
+        double PackMs = 0.0;         // FChunkPackedMesh::Build (worker-side packing only; the game-thread upload is not timed)
+        int32 Triangles = 0;
+        int64 WorkingSetBytes = 0;   // Density field + mesh + packed buffers
+        uint32 Hash = 0;             // CRC of the density field and the mesh
+        bool bDeterministic = true;  // Same hash on every iteration
+
+        double GetTotalMs() const { return DensityMs + MeshMs + PackMs; }
+        double GetTrianglesPerSecond() const { return GetTotalMs() > 0.0 ? Triangles / (GetTotalMs() / 1000.0) : 0.0; }
+};
+
+
+class FPlanetBenchmark
+{
+    public:
+        explicit FPlanetBenchmark(int32 InIterations);
+
+        // Generates every case Iterations times. Blocks the calling thread.
+        void Run();
+
+        const TArray<FPlanetBenchmarkResult> &GetResults() const { return Results; }
+
+        // Process peak physical memory at the end of the run.
+        uint64 GetPeakUsedPhysical() const { return PeakUsedPhysical; }
+
+        // Writes the CSV and JSON reports into Directory. Returns the path of the CSV, empty on failure.
+        FString WriteReport(const FString &Directory) const;
+
+        // Compares every case hash with the golden file, or rewrites the file with the current hashes if bUpdate.
+        // False if the file is missing, a hash differs or a case is missing. Hashes are only comparable on the same platform and compiler.
+        bool CheckGolden(const FString &GoldenPath, bool bUpdate, FString &OutMessage) const;
+
+        // Golden hashes of the reference platform, in the source tree: "Planet.Benchmark 1 UpdateGolden" rewrites them.
+        static FString GetGoldenPath();
+
+        // The fixed case set: LOD 0 to 6, resolutions 16, 32 and 64, corner and center chunks of face 0.
+        static TArray<FPlanetBenchmarkCase> GetCases();
+
+    private:
+        int32 Iterations;
+        TArray<FPlanetBenchmarkResult> Results;
+        uint64 PeakUsedPhysical = 0;
+
+        static FString GetCaseKey(const FPlanetBenchmarkCase &Case);
+};
+
+#endif  // PLANET_WITH_BENCHMARK
@@ -3,6 +3,19 @@
 #include "DrawDebugHelpers.h"
 
 
+namespace
+{
+    // Angle between two normalized view directions. Zero when there is no view direction at all.
+    float GetTurnAngle(const FVector &Forward, const FVector &PreviousForward)
+    {
+        if (Forward.IsZero() || PreviousForward.IsZero())
+            return 0.f;
+
+        return FMath::Acos(FMath::Clamp(FVector::DotProduct(Forward, PreviousForward), -1.0f, 1.0f));
+    }
+}
+
+
 FPlanetQuadtree::FPlanetQuadtree(const FPlanetConfig &InConfig) :
     Config(InConfig)
 {
@@ -10,7 +23,7 @@ FPlanetQuadtree::FPlanetQuadtree(const FPlanetConfig &InConfig) :
     for (uint8 i = 0; i < 6; ++i)
     {
         FChunkId RootId(i, FIntVector(0, 0, 0), 0);
-        RootNodes.Add(MakeUnique<FQuadtreeNode>(RootId, nullptr));
+        InitNode(RootNodes[i], RootId, nullptr);
     }
 
     UE_LOG(LogTemp, Warning, TEXT("FPlanetQuadtree initialized."));
@@ -20,94 +33,364 @@ FPlanetQuadtree::FPlanetQuadtree(const FPlanetConfig &InConfig) :
 FPlanetQuadtree::~FPlanetQuadtree() {}
 
 
+int32 FQuadtreeNodePool::AllocateBlock()
+{
+    int32 FirstIndex;
+    if (FreeBlocks.Num() > 0)
+    {
+        FirstIndex = FreeBlocks.Pop(EAllowShrinking::No);
+    }
+    else
+    {
+        if (CreatedBlockCount == Pages.Num() * BlocksPerPage)
+            Pages.Add(MakeUnique<FQuadtreeNode[]>(NodesPerPage));
+
+        FirstIndex = (CreatedBlockCount++) * 4;
+    }
+
+    // Recycled blocks still hold the state of their previous owners
+    for (int32 i = 0; i < 4; i++)
+        (*this)[FirstIndex + i] = FQuadtreeNode();
+
+    return FirstIndex;
+}
+
+
+void FQuadtreeNodePool::FreeBlock(int32 FirstIndex)
+{
+    check(FirstIndex % 4 == 0);
+    FreeBlocks.Add(FirstIndex);
+}
+
+
+void FPlanetQuadtree::InitNode(FQuadtreeNode &Node, const FChunkId &Id, FQuadtreeNode *Parent)
+{
+    Node.Id = Id;
+    Node.Parent = Parent;
+    Node.Center = FMathUtils::GetChunkCenter(Id, Config.PlanetRadius);
+    Node.Bounds = FMathUtils::GetChunkBounds(Id, Config.PlanetRadius, Config.MaxTerrainHeight);
+    Node.SplitDistance = GetSplitDistance(Id.LODLevel);
+    Node.MergeDistance = Node.SplitDistance * Config.LODMergeHysteresisRatio;
+    NodeCount++;
+}
+
+
 void FPlanetQuadtree::Update(const FPlanetViewContext &Context)
 {
-    DesiredLeaves.Empty();
+    AddedLeaves.Reset();
+    RemovedLeaves.Reset();
+    VisitedNodeCount = 0;
 
-    for (const auto &Root : RootNodes)
+    // Gaining or losing the camera flips every view cone test at once: no margin covers that.
+    const FVector Forward = Context.ObserverForward.GetSafeNormal();
+    const bool bHasForward = !Forward.IsZero();
+
+    // Periodic full pass as a safety net. The margins are conservative, this only guards against float drift.
+    bool bFullRefresh = !Config.bIncrementalQuadtree || bHasForward != bHadForward;
+    if (++FramesSinceFullRefresh >= FPlanetStatics::QuadtreeFullRefreshInterval)
+        bFullRefresh = true;
+    if (bFullRefresh)
+        FramesSinceFullRefresh = 0;
+    bHadForward = bHasForward;
+
+    for (FQuadtreeNode &Root : RootNodes)
     {
-        UpdateNode(Root.Get(), Context.ObserverLocation);
+        UpdateNode(&Root, Context, Forward, bFullRefresh);
     }
 }
 
 
-void FPlanetQuadtree::UpdateNode(FQuadtreeNode *Node, const FVector &ObserverLocal)
+void FPlanetQuadtree::UpdateNode(FQuadtreeNode *Node, const FPlanetViewContext &Context, const FVector &Forward, bool bFullRefresh)
 {
-    // --- culling will come back later ---
-    // FVector Center = FMathUtils::GetChunkCenter(Node->Id, Config.PlanetRadius);
-    // FVector ToChunk = Center - Context.ObserverLocation;
+    const FVector &ObserverLocal = Context.ObserverLocation;
+
+    // --- Incremental skip ---
+    // Nothing in this subtree can split, merge or change visibility before the observer leaves its margins.
+    if (!bFullRefresh && Node->MoveMargin >= 0.f && FVector::Dist(ObserverLocal, Node->EvalPosition) < Node->MoveMargin &&
+        GetTurnAngle(Forward, Node->EvalForward) < Node->TurnMargin)
+        return;
 
-    // FVector ChunkNormal = Center.GetSafeNormal();
-    // FVector ToObserverDir = -ToChunk.GetSafeNormal();
+    VisitedNodeCount++;
+    float MoveMargin = BIG_NUMBER;
+    float TurnMargin = BIG_NUMBER;
+
+    // --- Culling ---
+    // Hidden subtrees keep the LODs they have resident, so turning back never regenerates them or shows a hole.
+    // They are never refined further, but still merge as the observer moves away.
+    uint8 CullState = NotCulled;
+    if (Config.bEnableCulling)
+    {
+        if (IsHiddenByHorizon(Node->Bounds, ObserverLocal, &MoveMargin))
+        {
+            CullState = HorizonCulled;
+        }
+        else
+        {
+            float ConeMoveMargin, ConeTurnMargin;
+            if (IsOutsideViewCone(Node->Bounds, ObserverLocal, Forward, ConeMoveMargin, ConeTurnMargin))
+                CullState = FrustumCulled;
+
+            MoveMargin = FMath::Min(MoveMargin, ConeMoveMargin);
+            TurnMargin = ConeTurnMargin;
+        }
+    }
+    SetCullState(Node, CullState);
+    const bool bCanSplit = CullState == NotCulled;
 
     // --- LOD Logic ---
-    if (ShouldSplit(Node, ObserverLocal))
+    const float Dist = FVector::Dist(Node->Center, ObserverLocal);
+
+    if (ShouldSplit(Node, Dist))
     {
-        // Expand children if not already split
-        if (Node->IsLeaf())
+        // Expand children if not already split. A culled leaf stays a leaf until it is seen again
+        if (bCanSplit && Node->IsLeaf())
         {
             const int32 NextLOD = Node->Id.LODLevel + 1;
             const int32 X = Node->Id.Coords.X;
             const int32 Y = Node->Id.Coords.Y;
             const uint8 Face = Node->Id.FaceIndex;
 
-            Node->Children.Add(MakeUnique<FQuadtreeNode>(FChunkId(Face, FIntVector(X * 2, Y * 2, 0), NextLOD), Node));
-            Node->Children.Add(MakeUnique<FQuadtreeNode>(FChunkId(Face, FIntVector(X * 2 + 1, Y * 2, 0), NextLOD), Node));
-            Node->Children.Add(MakeUnique<FQuadtreeNode>(FChunkId(Face, FIntVector(X * 2, Y * 2 + 1, 0), NextLOD), Node));
-            Node->Children.Add(MakeUnique<FQuadtreeNode>(FChunkId(Face, FIntVector(X * 2 + 1, Y * 2 + 1, 0), NextLOD), Node));
+            Node->FirstChild = NodePool.AllocateBlock();
+            for (int32 i = 0; i < 4; i++)
+                InitNode(NodePool[Node->FirstChild + i], FChunkId(Face, FIntVector(X * 2 + (i & 1), Y * 2 + (i >> 1), 0), NextLOD), Node);
         }
-
-        // Recurse regardless — children may themselves split or merge
-        for (auto &Child : Node->Children)
-            UpdateNode(Child.Get(), ObserverLocal);
     }
-    else if (ShouldMerge(Node, ObserverLocal))
+    else if (ShouldMerge(Node, Dist))
     {
         // Collapse children — this node becomes a leaf again
-        Node->Children.Empty(); // dont care if those children have loaded chunks — that's the manager's problem.
-        DesiredLeaves.Add(Node->Id);
+        ReleaseChildren(Node);  // dont care if those children have loaded chunks — that's the manager's problem.
     }
-    else
+    // else: hysteresis band — hold current structure
+
+    SetDesiredLeaf(Node, Node->IsLeaf());
+
+    // Distance left before this node's own decision flips: a leaf splits below SplitDistance,
+    // a split node collapses once past both thresholds. A culled leaf cannot split: only its culling margins apply.
+    if (Node->Id.LODLevel < Config.MaxLOD && (bCanSplit || !Node->IsLeaf()))
     {
-        // Hysteresis band — hold current structure
-        if (Node->IsLeaf())
-        {
-            DesiredLeaves.Add(Node->Id);
-        }
-        else
+        const float ThresholdMargin =
+            Node->IsLeaf() ? Dist - Node->SplitDistance : FMath::Max(Node->SplitDistance, Node->MergeDistance) - Dist;
+        MoveMargin = FMath::Min(MoveMargin, ThresholdMargin);
+    }
+
+    // Recurse — children may themselves split or merge
+    if (!Node->IsLeaf())
+    {
+        for (int32 i = 0; i < 4; i++)
         {
-            for (auto &Child : Node->Children)
-                UpdateNode(Child.Get(), ObserverLocal);
+            FQuadtreeNode *Child = &NodePool[Node->FirstChild + i];
+            UpdateNode(Child, Context, Forward, bFullRefresh);
+
+            // Skipped children keep their older margins, minus what the observer already used up since
+            MoveMargin = FMath::Min(MoveMargin, Child->MoveMargin - FVector::Dist(ObserverLocal, Child->EvalPosition));
+            TurnMargin = FMath::Min(TurnMargin, Child->TurnMargin - GetTurnAngle(Forward, Child->EvalForward));
         }
     }
+
+    Node->EvalPosition = ObserverLocal;
+    Node->EvalForward = Forward;
+    Node->MoveMargin = MoveMargin;
+    Node->TurnMargin = TurnMargin;
 }
 
 
-bool FPlanetQuadtree::ShouldSplit(const FQuadtreeNode *Node, const FVector &ObserverLocal) const
+void FPlanetQuadtree::ReleaseChildren(FQuadtreeNode *Node)
 {
-    if (Node->Id.LODLevel >= Config.MaxLOD)
+    if (Node->IsLeaf())
+        return;
+
+    for (int32 i = 0; i < 4; i++)
+    {
+        FQuadtreeNode *Child = &NodePool[Node->FirstChild + i];
+        ReleaseChildren(Child);
+        SetDesiredLeaf(Child, false);
+        SetCullState(Child, NotCulled);
+        NodeCount--;
+    }
+
+    NodePool.FreeBlock(Node->FirstChild);
+    Node->FirstChild = INDEX_NONE;
+}
+
+
+void FPlanetQuadtree::SetDesiredLeaf(FQuadtreeNode *Node, bool bIsLeaf)
+{
+    if (Node->bIsDesiredLeaf == bIsLeaf)
+        return;
+
+    Node->bIsDesiredLeaf = bIsLeaf;
+    if (bIsLeaf)
+    {
+        DesiredLeaves.Add(Node->Id);
+        AddedLeaves.Add(Node->Id);
+    }
+    else
+    {
+        DesiredLeaves.Remove(Node->Id);
+        RemovedLeaves.Add(Node->Id);
+    }
+}
+
+
+void FPlanetQuadtree::SetCullState(FQuadtreeNode *Node, uint8 NewState)
+{
+    if (Node->CullState == NewState)
+        return;
+
+    if (Node->CullState == HorizonCulled)
+        HorizonCulledCount--;
+    else if (Node->CullState == FrustumCulled)
+        FrustumCulledCount--;
+
+    if (NewState == HorizonCulled)
+        HorizonCulledCount++;
+    else if (NewState == FrustumCulled)
+        FrustumCulledCount++;
+
+    Node->CullState = NewState;
+}
+
+
+bool FPlanetQuadtree::IsHiddenByHorizon(const FSphereBounds &Bounds, const FVector &ObserverLocal, float *OutMoveMargin) const
+{
+    // The ball of radius R - H is always solid, so it occludes everything behind its horizon.
+    // A point up to R + H is visible iff its angle to the observer is below
+    // acos(Rmin / ObserverDist) + acos(Rmin / Rmax); the node's angular radius widens the test.
+    const float MinRadius = FMath::Max(Config.PlanetRadius - Config.MaxTerrainHeight, 1.0f);
+    const float MaxRadius = Config.PlanetRadius + Config.MaxTerrainHeight;
+    const float ObserverDist = ObserverLocal.Size();
+    if (ObserverDist <= MinRadius)
+    {
+        // Under the occluder: no horizon to hide behind
+        if (OutMoveMargin)
+            *OutMoveMargin = MinRadius - ObserverDist;
         return false;
+    }
 
-    FVector Center = FMathUtils::GetChunkCenter(Node->Id, Config.PlanetRadius);
-    float Dist = FVector::Dist(Center, ObserverLocal);
-    float NodeSize = (Config.PlanetRadius * PI * 0.5f) / (float)(1 << Node->Id.LODLevel);
+    const float HorizonAngle = FMath::Acos(MinRadius / ObserverDist) + FMath::Acos(MinRadius / MaxRadius);
+    const float NodeAngle = FMath::Acos(FMath::Clamp(FVector::DotProduct(ObserverLocal / ObserverDist, Bounds.Direction), -1.0f, 1.0f));
+    const float Slack = NodeAngle - Bounds.AngularRadius - HorizonAngle;
 
-    return Dist < (NodeSize * Config.LODSplitDistanceMultiplier);
+    if (OutMoveMargin)
+    {
+        // Bound the rate of change of Slack over a move of at most half the altitude above Rmin:
+        // the observer direction turns by at most (PI/2) * Move / Dist, and the horizon widens fastest at the lowest point.
+        const float MaxMove = 0.5f * (ObserverDist - MinRadius);
+        const float NearDist = ObserverDist - MaxMove;
+        const float Rate = HALF_PI / NearDist + MinRadius / (NearDist * FMath::Sqrt(NearDist * NearDist - MinRadius * MinRadius));
+        *OutMoveMargin = FMath::Min(MaxMove, FMath::Abs(Slack) / Rate);
+    }
+
+    return Slack > 0.f;
 }
 
 
-bool FPlanetQuadtree::ShouldMerge(const FQuadtreeNode *Node, const FVector &ObserverLocal) const
+bool FPlanetQuadtree::IsOutsideViewCone(const FSphereBounds &Bounds, const FVector &ObserverLocal, const FVector &Forward, float &OutMoveMargin,
+                                        float &OutTurnMargin) const
+{
+    OutMoveMargin = BIG_NUMBER;
+    OutTurnMargin = BIG_NUMBER;
+
+    // No camera (editor viewport): never cull on direction
+    if (Forward.IsZero())
+        return false;
+
+    const FVector ToNode = Bounds.Center - ObserverLocal;
+    const float Dist = ToNode.Size();
+    if (Dist <= Bounds.Radius)
+    {
+        OutMoveMargin = Bounds.Radius - Dist;  // Observer inside the bounds
+        return false;
+    }
+
+    // Cone of half-angle acos(FrustumCullingDot). Kept much wider than the real FOV, so the camera can turn
+    // faster than chunks generate without revealing coarse tiles.
+    const float ConeHalfAngle = FMath::Acos(FPlanetStatics::FrustumCullingDot);
+    const float NodeAngle = FMath::Acos(FMath::Clamp(FVector::DotProduct(Forward, ToNode / Dist), -1.0f, 1.0f));
+    const float NodeAngularRadius = FMath::Asin(FMath::Min(Bounds.Radius / Dist, 1.0f));
+    const float Slack = NodeAngle - NodeAngularRadius - ConeHalfAngle;
+
+    // Half the slack is left for turning, half for moving. Over a move of at most half the gap to the bounds,
+    // the direction to the node turns by at most (PI/2) * Move / Dist and its angular radius grows fastest at the closest point.
+    OutTurnMargin = 0.5f * FMath::Abs(Slack);
+    const float MaxMove = 0.5f * (Dist - Bounds.Radius);
+    const float NearDist = Dist - MaxMove;
+    const float Rate = HALF_PI / NearDist + Bounds.Radius / (NearDist * FMath::Sqrt(NearDist * NearDist - Bounds.Radius * Bounds.Radius));
+    OutMoveMargin = FMath::Min(MaxMove, OutTurnMargin / Rate);
+
+    return Slack > 0.f;
+}
+
+
+float FPlanetQuadtree::GetSplitDistance(int32 LODLevel) const
+{
+    const float NodeSize = (Config.PlanetRadius * PI * 0.5f) / (float)(1 << LODLevel);
+    return NodeSize * Config.LODSplitDistanceMultiplier;
+}
+
+
+bool FPlanetQuadtree::ShouldSplit(const FQuadtreeNode *Node, float Dist) const
 {
     if (Node->Id.LODLevel >= Config.MaxLOD)
-        return true;
+        return false;
 
-    FVector Center = FMathUtils::GetChunkCenter(Node->Id, Config.PlanetRadius);
-    float Dist = FVector::Dist(Center, ObserverLocal);
-    float NodeSize = (Config.PlanetRadius * PI * 0.5f) / (float)(1 << Node->Id.LODLevel);
+    return Dist < Node->SplitDistance;
+}
+
+
+bool FPlanetQuadtree::ShouldMerge(const FQuadtreeNode *Node, float Dist) const
+{
+    if (Node->Id.LODLevel >= Config.MaxLOD)
+        return true;
 
     // Merge only when observer has moved meaningfully farther than the split threshold.
     // The hysteresis ratio prevents oscillation at the boundary.
-    return Dist >= (NodeSize * Config.LODSplitDistanceMultiplier * Config.LODMergeHysteresisRatio);
+    return Dist >= Node->MergeDistance;
+}
+
+
+void FPlanetQuadtree::GetPrefetchLeaves(const TArray<FVector> &FuturePositions, int32 MaxLeaves, FChunkKeySet &OutLeaves) const
+{
+    OutLeaves.Reset();
+
+    for (const FVector &FuturePosition : FuturePositions)
+    {
+        for (const FQuadtreeNode &Root : RootNodes)
+        {
+            CollectPrefetchLeaves(Root.Id, FuturePosition, false, MaxLeaves, OutLeaves);
+        }
+    }
+}
+
+
+void FPlanetQuadtree::CollectPrefetchLeaves(const FChunkId &Id, const FVector &FuturePosition, bool bUnderDesiredLeaf, int32 MaxLeaves,
+                                            FChunkKeySet &OutLeaves) const
+{
+    if (OutLeaves.Num() >= MaxLeaves)
+        return;
+
+    // Nothing behind the horizon of that future position is worth generating early
+    if (Config.bEnableCulling && IsHiddenByHorizon(FMathUtils::GetChunkBounds(Id, Config.PlanetRadius, Config.MaxTerrainHeight), FuturePosition))
+        return;
+
+    const bool bIsDesiredLeaf = DesiredLeaves.Contains(Id);
+
+    const float Dist = FVector::Dist(FMathUtils::GetChunkCenter(Id, Config.PlanetRadius), FuturePosition);
+    if (Id.LODLevel < Config.MaxLOD && Dist < GetSplitDistance(Id.LODLevel))
+    {
+        const int32 NextLOD = Id.LODLevel + 1;
+        for (int32 i = 0; i < 4; i++)
+        {
+            const FChunkId ChildId(Id.FaceIndex, FIntVector(Id.Coords.X * 2 + (i & 1), Id.Coords.Y * 2 + (i >> 1), 0), NextLOD);
+            CollectPrefetchLeaves(ChildId, FuturePosition, bUnderDesiredLeaf || bIsDesiredLeaf, MaxLeaves, OutLeaves);
+        }
+    }
+    else if (bUnderDesiredLeaf)
+    {
+        // Finer than what is wanted now: this is a split the observer is heading into.
+        // Leaves equal to or coarser than the current ones are already resident or about to merge.
+        OutLeaves.Add(Id);
+    }
 }
 
 
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "DataTypes.h"
+#include "ChunkKeySet.h"
 
 
 // A logical node in the Quadtree.
@@ -9,15 +10,51 @@ struct FQuadtreeNode
 {
         FChunkId Id;
         FQuadtreeNode *Parent = nullptr;
-        TArray<TUniquePtr<FQuadtreeNode>> Children;
+        int32 FirstChild = INDEX_NONE;  // First of the 4 children, contiguous in FQuadtreeNodePool
 
-        FQuadtreeNode(const FChunkId &InId, FQuadtreeNode *InParent) :
-            Id(InId),
-            Parent(InParent)
-        {
-        }
+        // Cached at creation, the node geometry never changes
+        FVector Center = FVector::ZeroVector;
+        FSphereBounds Bounds;
+        float SplitDistance = 0.f;
+        float MergeDistance = 0.f;
+
+        // Incremental update: the output of this whole subtree cannot change while the observer stays within
+        // MoveMargin of EvalPosition and turns less than TurnMargin (radians) away from EvalForward.
+        FVector EvalPosition = FVector::ZeroVector;
+        FVector EvalForward = FVector::ZeroVector;
+        float MoveMargin = -1.f;  // < 0: never evaluated
+        float TurnMargin = -1.f;
+
+        bool bIsDesiredLeaf = false;  // Currently in FPlanetQuadtree::DesiredLeaves
+        uint8 CullState = 0;          // FPlanetQuadtree::ECullState
+
+        bool IsLeaf() const { return FirstChild == INDEX_NONE; }
+};
+
+
+// Storage for quadtree children: blocks of 4 siblings, contiguous and addressed by the index of the first one.
+// Blocks live in fixed-size pages that never move while the tree exists, so node pointers stay valid as the pool grows,
+// and a block freed by a merge is recycled by the next split instead of going back to the allocator.
+class FQuadtreeNodePool
+{
+    public:
+        // Returns the index of the first node of a block of 4 default nodes.
+        int32 AllocateBlock();
+        void FreeBlock(int32 FirstIndex);
+
+        FQuadtreeNode &operator[](int32 Index) { return Pages[Index / NodesPerPage][Index % NodesPerPage]; }
+        const FQuadtreeNode &operator[](int32 Index) const { return Pages[Index / NodesPerPage][Index % NodesPerPage]; }
+
+        int32 GetUsedBlockCount() const { return CreatedBlockCount - FreeBlocks.Num(); }
+        int64 GetAllocatedSize() const { return (int64)Pages.Num() * NodesPerPage * sizeof(FQuadtreeNode) + FreeBlocks.GetAllocatedSize(); }
 
-        bool IsLeaf() const { return Children.Num() == 0; }
+    private:
+        static constexpr int32 BlocksPerPage = 256;
+        static constexpr int32 NodesPerPage = BlocksPerPage * 4;
+
+        TArray<TUniquePtr<FQuadtreeNode[]>> Pages;
+        TArray<int32> FreeBlocks;    // First node index of each free block
+        int32 CreatedBlockCount = 0;  // Blocks handed out at least once
 };
 
 
@@ -29,22 +66,80 @@ class FPlanetQuadtree
         FPlanetQuadtree(const FPlanetConfig &InConfig);
         ~FPlanetQuadtree();
 
-        // Rebuilds the visibility lists based on the view context.
-        // IsChunkReady: A callback to check if a specific chunk ID has mesh data loaded (used for hysteresis).
+        // Updates the visibility lists based on the view context.
+        // Incremental: only subtrees whose split/merge/cull decision may have changed since their last evaluation are revisited.
         void Update(const FPlanetViewContext &Context);
 
         // The ideal set of leaf IDs this frame. Manager diffs this against RenderSet.
         const TSet<FChunkId> &GetDesiredLeaves() const { return DesiredLeaves; }
 
+        // Changes to DesiredLeaves made by the last Update. Both empty when nothing changed.
+        const TArray<FChunkId> &GetAddedLeaves() const { return AddedLeaves; }
+        const TArray<FChunkId> &GetRemovedLeaves() const { return RemovedLeaves; }
+        bool HasLeafChanges() const { return AddedLeaves.Num() > 0 || RemovedLeaves.Num() > 0; }
+
+        // Nodes re-evaluated by the last Update, and nodes currently in the tree.
+        int32 GetVisitedNodeCount() const { return VisitedNodeCount; }
+        int32 GetNodeCount() const { return NodeCount; }
+
+        // Leaves the quadtree would want at each of the given future observer positions that refine the current DesiredLeaves.
+        // Stateless descent (no hysteresis, no view cone), capped at MaxLeaves.
+        void GetPrefetchLeaves(const TArray<FVector> &FuturePositions, int32 MaxLeaves, FChunkKeySet &OutLeaves) const;
+
+        // Nodes currently culled, at any depth (the children kept under a culled node are culled too).
+        int32 GetHorizonCulledCount() const { return HorizonCulledCount; }
+        int32 GetFrustumCulledCount() const { return FrustumCulledCount; }
+
         // Debug drawing for the logical grid
         void DrawDebugGrid(const UWorld *World, const FTransform &PlanetTransform) const;
 
     private:
+        enum ECullState : uint8
+        {
+            NotCulled,
+            HorizonCulled,
+            FrustumCulled
+        };
+
         FPlanetConfig Config;
-        TArray<TUniquePtr<FQuadtreeNode>> RootNodes;
+        FQuadtreeNode RootNodes[6];
+        FQuadtreeNodePool NodePool;
         TSet<FChunkId> DesiredLeaves;
+        TArray<FChunkId> AddedLeaves;
+        TArray<FChunkId> RemovedLeaves;
+
+        int32 HorizonCulledCount = 0;
+        int32 FrustumCulledCount = 0;
+        int32 VisitedNodeCount = 0;
+        int32 NodeCount = 0;
+
+        int32 FramesSinceFullRefresh = 0;
+        bool bHadForward = false;  // Whether the last Update had a view direction
+
+        void InitNode(FQuadtreeNode &Node, const FChunkId &Id, FQuadtreeNode *Parent);
+
+        // bFullRefresh: ignore the cached margins and re-evaluate every node.
+        void UpdateNode(FQuadtreeNode *Node, const FPlanetViewContext &Context, const FVector &Forward, bool bFullRefresh);
+
+        // Returns the node's children to the pool, removing their leaves from DesiredLeaves.
+        void ReleaseChildren(FQuadtreeNode *Node);
+
+        void SetDesiredLeaf(FQuadtreeNode *Node, bool bIsLeaf);
+        void SetCullState(FQuadtreeNode *Node, uint8 NewState);
+
+        // Conservative visibility of a node's whole subtree, terrain displacement included.
+        // A culled node keeps its resident children but is never refined further.
+        // OutMoveMargin / OutTurnMargin: how far the observer can move / turn before the result may flip.
+        bool IsHiddenByHorizon(const FSphereBounds &Bounds, const FVector &ObserverLocal, float *OutMoveMargin = nullptr) const;
+        bool IsOutsideViewCone(const FSphereBounds &Bounds, const FVector &ObserverLocal, const FVector &Forward, float &OutMoveMargin,
+                               float &OutTurnMargin) const;
+
+        // Node size (arc length of its edge) times the split multiplier.
+        float GetSplitDistance(int32 LODLevel) const;
+        bool ShouldSplit(const FQuadtreeNode *Node, float Dist) const;
+        bool ShouldMerge(const FQuadtreeNode *Node, float Dist) const;
 
-        void UpdateNode(FQuadtreeNode *Node, const FVector &ObserverLocal);
-        bool ShouldSplit(const FQuadtreeNode *Node, const FVector &ObserverLocal) const;
-        bool ShouldMerge(const FQuadtreeNode *Node, const FVector &ObserverLocal) const;
+        // bUnderDesiredLeaf: an ancestor of Id is a current desired leaf, so Id would be a refinement of it.
+        void CollectPrefetchLeaves(const FChunkId &Id, const FVector &FuturePosition, bool bUnderDesiredLeaf, int32 MaxLeaves,
+                                   FChunkKeySet &OutLeaves) const;
 };
\ No newline at end of file
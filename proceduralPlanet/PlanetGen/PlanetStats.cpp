@@ -0,0 +1,46 @@
+#include "PlanetStats.h"
+
+
+UE_TRACE_CHANNEL_DEFINE(PlanetChannel);
+
+DEFINE_STAT(STAT_PlanetManagerUpdate);
+DEFINE_STAT(STAT_PlanetReconcileTransitions);
+DEFINE_STAT(STAT_PlanetRefreshSeams);
+DEFINE_STAT(STAT_PlanetAdvanceLoading);
+DEFINE_STAT(STAT_PlanetPrepareChunk);
+DEFINE_STAT(STAT_PlanetCommitTransitions);
+DEFINE_STAT(STAT_PlanetPruneOrphans);
+DEFINE_STAT(STAT_PlanetUpdateCollision);
+DEFINE_STAT(STAT_PlanetEnforceMemoryBudget);
+DEFINE_STAT(STAT_PlanetProcessCompleted);
+DEFINE_STAT(STAT_PlanetDispatch);
+
+DEFINE_STAT(STAT_PlanetGenerateChunk);
+DEFINE_STAT(STAT_PlanetDensitySlab);
+DEFINE_STAT(STAT_PlanetDensityCompute);
+DEFINE_STAT(STAT_PlanetMesh);
+DEFINE_STAT(STAT_PlanetPackMesh);
+DEFINE_STAT(STAT_PlanetCollisionBuild);
+
+DEFINE_STAT(STAT_PlanetChunks);
+DEFINE_STAT(STAT_PlanetVisibleChunks);
+DEFINE_STAT(STAT_PlanetQueuedRequests);
+DEFINE_STAT(STAT_PlanetTasksInFlight);
+DEFINE_STAT(STAT_PlanetUploads);
+DEFINE_STAT(STAT_PlanetComponents);
+DEFINE_STAT(STAT_PlanetUpdatedPlanets);
+DEFINE_STAT(STAT_PlanetGenerationBudget);
+DEFINE_STAT(STAT_PlanetResidentMeshData);
+DEFINE_STAT(STAT_PlanetMeshCacheData);
+DEFINE_STAT(STAT_PlanetResidentGPUData);
+
+DEFINE_STAT(STAT_PlanetCancelledQueued);
+DEFINE_STAT(STAT_PlanetCancelledInFlight);
+
+DEFINE_STAT(STAT_PlanetLatency100);
+DEFINE_STAT(STAT_PlanetLatency250);
+DEFINE_STAT(STAT_PlanetLatency500);
+DEFINE_STAT(STAT_PlanetLatency1000);
+DEFINE_STAT(STAT_PlanetLatency2000);
+DEFINE_STAT(STAT_PlanetLatencyOver);
+DEFINE_STAT(STAT_PlanetLatencyMax);
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+
+// Planet pipeline telemetry: "stat Planet" in game, and the "Planet" channel in Unreal Insights (-trace=cpu,Planet,stats).
+// Stats compile out where STATS is 0 (shipping without FORCE_USE_STATS): use the Test configuration for shipping-like captures.
+
+DECLARE_STATS_GROUP(TEXT("Planet"), STATGROUP_Planet, STATCAT_Advanced);
+
+UE_TRACE_CHANNEL_EXTERN(PlanetChannel);
+
+
+// Game thread stages
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Manager Update"), STAT_PlanetManagerUpdate, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Reconcile Transitions"), STAT_PlanetReconcileTransitions, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Refresh Seams"), STAT_PlanetRefreshSeams, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Advance Loading"), STAT_PlanetAdvanceLoading, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Prepare Chunk (upload)"), STAT_PlanetPrepareChunk, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Commit Transitions"), STAT_PlanetCommitTransitions, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Prune Orphans"), STAT_PlanetPruneOrphans, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Collision"), STAT_PlanetUpdateCollision, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enforce Memory Budget"), STAT_PlanetEnforceMemoryBudget, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Process Completed Tasks"), STAT_PlanetProcessCompleted, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dispatch Generation"), STAT_PlanetDispatch, STATGROUP_Planet, );
+
+// Worker stages
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Generate Chunk (worker)"), STAT_PlanetGenerateChunk, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Density Slab (worker)"), STAT_PlanetDensitySlab, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Density Compute Wait (worker)"), STAT_PlanetDensityCompute, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Mesh (worker)"), STAT_PlanetMesh, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pack Mesh (worker)"), STAT_PlanetPackMesh, STATGROUP_Planet, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Collision Build (worker)"), STAT_PlanetCollisionBuild, STATGROUP_Planet, );
+
+// Pipeline state, set once per frame
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Chunks"), STAT_PlanetChunks, STATGROUP_Planet, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Visible Chunks"), STAT_PlanetVisibleChunks, STATGROUP_Planet, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Queued Requests"), STAT_PlanetQueuedRequests, STATGROUP_Planet, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Tasks In Flight"), STAT_PlanetTasksInFlight, STATGROUP_Planet, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Uploads"), STAT_PlanetUploads, STATGROUP_Planet, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Render Components"), STAT_PlanetComponents, STATGROUP_Planet, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Planets Updated"), STAT_PlanetUpdatedPlanets, STATGROUP_Planet, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Generation Budget (all planets)"), STAT_PlanetGenerationBudget, STATGROUP_Planet, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Resident Mesh Data"), STAT_PlanetResidentMeshData, STATGROUP_Planet, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Mesh Cache"), STAT_PlanetMeshCacheData, STATGROUP_Planet, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Resident GPU Buffers (estimate)"), STAT_PlanetResidentGPUData, STATGROUP_Planet, );
+
+// Totals since startup
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Cancelled Requests (queued)"), STAT_PlanetCancelledQueued, STATGROUP_Planet, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Cancelled Tasks (in flight)"), STAT_PlanetCancelledInFlight, STATGROUP_Planet, );
+
+// Request -> visible latency histogram, from the first time a chunk is needed to the frame it is shown
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Latency < 100 ms"), STAT_PlanetLatency100, STATGROUP_Planet, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Latency < 250 ms"), STAT_PlanetLatency250, STATGROUP_Planet, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Latency < 500 ms"), STAT_PlanetLatency500, STATGROUP_Planet, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Latency < 1 s"), STAT_PlanetLatency1000, STATGROUP_Planet, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Latency < 2 s"), STAT_PlanetLatency2000, STATGROUP_Planet, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Latency >= 2 s"), STAT_PlanetLatencyOver, STATGROUP_Planet, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Latency Max (ms, this frame)"), STAT_PlanetLatencyMax, STATGROUP_Planet, );
+
+
+// CPU scope recorded both as a stat and as a Planet channel trace event.
+#define PLANET_SCOPE_CYCLE_COUNTER(Stat) \
+    SCOPE_CYCLE_COUNTER(Stat);           \
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, PlanetChannel)
+
+
+// Adds one request -> visible latency to the histogram.
+inline void RecordPlanetLatencyStat(double LatencySeconds)
+{
+#if STATS
+    const double Ms = LatencySeconds * 1000.0;
+    if (Ms < 100.0)
+        INC_DWORD_STAT(STAT_PlanetLatency100);
+    else if (Ms < 250.0)
+        INC_DWORD_STAT(STAT_PlanetLatency250);
+    else if (Ms < 500.0)
+        INC_DWORD_STAT(STAT_PlanetLatency500);
+    else if (Ms < 1000.0)
+        INC_DWORD_STAT(STAT_PlanetLatency1000);
+    else if (Ms < 2000.0)
+        INC_DWORD_STAT(STAT_PlanetLatency2000);
+    else
+        INC_DWORD_STAT(STAT_PlanetLatencyOver);
+#endif
+}
@@ -0,0 +1,114 @@
+#include "PlanetSubsystem.h"
+#include "HAL/IConsoleManager.h"
+#include "Planet.h"
+#include "PlanetStats.h"
+
+
+static TAutoConsoleVariable<int32> CVarPlanetGenerationBudget(TEXT("Planet.GenerationBudget"),
+                                                              FPlanetStatics::DefaultGenerationBudget,
+                                                              TEXT("Chunk generation tasks in flight at once, shared by every planet of the world."),
+                                                              ECVF_Default);
+
+
+void UPlanetSubsystem::RegisterPlanet(APlanet *Planet)
+{
+    if (!Planet || Shares.ContainsByPredicate([Planet](const FPlanetBudgetShare &Share) { return Share.Planet == Planet; }))
+        return;
+
+    FPlanetBudgetShare &Share = Shares.AddDefaulted_GetRef();
+    Share.Planet = Planet;
+    SharesFrame = MAX_uint64;  // Re-split on the next request
+}
+
+
+void UPlanetSubsystem::UnregisterPlanet(APlanet *Planet)
+{
+    Shares.RemoveAll([Planet](const FPlanetBudgetShare &Share) { return Share.Planet == Planet; });
+    SharesFrame = MAX_uint64;
+}
+
+
+const FPlanetBudgetShare *UPlanetSubsystem::GetShare(const APlanet *Planet, const FVector &ObserverLocation)
+{
+    if (SharesFrame != GFrameCounter)
+    {
+        SharesFrame = GFrameCounter;
+        UpdateShares(ObserverLocation);
+    }
+
+    return Shares.FindByPredicate([Planet](const FPlanetBudgetShare &Share) { return Share.Planet == Planet; });
+}
+
+
+int32 UPlanetSubsystem::GetTotalBudget() { return FMath::Max(1, CVarPlanetGenerationBudget.GetValueOnGameThread()); }
+
+
+void UPlanetSubsystem::UpdateShares(const FVector &ObserverLocation)
+{
+    Shares.RemoveAll([](const FPlanetBudgetShare &Share) { return !Share.Planet.IsValid(); });
+
+    TArray<FPlanetBudgetShare *, TInlineAllocator<16>> Active;
+    float TotalWeight = 0.f;
+
+    for (FPlanetBudgetShare &Share : Shares)
+    {
+        const APlanet *Planet = Share.Planet.Get();
+        Share.bSkipUpdate = !Planet->NeedsChunkUpdate(ObserverLocation);
+        Share.Weight = 0.f;
+        Share.Budget = 0;
+        if (Share.bSkipUpdate)
+            continue;
+
+        // Solid angle of the planet's sphere over a hemisphere: 1 on (or in) the planet, ~(R / D)^2 / 2 far away
+        const float Radius = Planet->GenSettings.PlanetRadius;
+        const float Dist = FMath::Max(FVector::Dist(Planet->GetActorLocation(), ObserverLocation), Radius);
+        const float SinHalfAngle = Dist > 0.f ? Radius / Dist : 1.f;
+        const float Coverage = 1.f - FMath::Sqrt(FMath::Max(0.f, 1.f - SinHalfAngle * SinHalfAngle));
+
+        Share.Weight = FMath::Max(Coverage, FPlanetStatics::MinGenerationWeight);
+        TotalWeight += Share.Weight;
+        Active.Add(&Share);
+    }
+
+    // Water filling: the planets whose own cap is the tightest relative to their weight are served first,
+    // so whatever a capped planet cannot use flows on to the others. The shares never add up to more than the budget.
+    auto Cap = [](const FPlanetBudgetShare *Share) { return FMath::Max(0, Share->Planet->PerformanceSettings.MaxConcurrentGenerations); };
+    Active.Sort([&Cap](const FPlanetBudgetShare &A, const FPlanetBudgetShare &B) { return Cap(&A) / A.Weight < Cap(&B) / B.Weight; });
+
+    int32 Remaining = GetTotalBudget();
+    for (FPlanetBudgetShare *Share : Active)
+    {
+        const int32 Fair = FMath::FloorToInt(Remaining * Share->Weight / FMath::Max(TotalWeight, SMALL_NUMBER));
+        Share->Budget = FMath::Max(0, FMath::Min(FMath::Min(Fair, Remaining), Cap(Share)));
+        Remaining -= Share->Budget;
+        TotalWeight -= Share->Weight;
+    }
+
+    // The rounding leftovers go one task at a time to the planets left below their cap, the ones with no task first.
+    // The round starts one planet further every frame: with more planets than tasks, the starved ones take turns.
+    const int32 NumShares = Shares.Num();
+    RotationOffset = NumShares > 0 ? (RotationOffset + 1) % NumShares : 0;
+    for (int32 Pass = 0; Pass < 2 && Remaining > 0; Pass++)
+    {
+        bool bGaveTask = true;
+        while (Remaining > 0 && bGaveTask)
+        {
+            bGaveTask = false;
+            for (int32 i = 0; i < NumShares && Remaining > 0; i++)
+            {
+                FPlanetBudgetShare &Share = Shares[(RotationOffset + i) % NumShares];
+                if (Share.bSkipUpdate || Share.Budget >= Cap(&Share) || (Pass == 0 && Share.Budget > 0))
+                    continue;
+
+                Share.Budget++;
+                Remaining--;
+                bGaveTask = true;
+            }
+            if (Pass == 0)
+                break;  // Starved planets get one task each, then the rest is shared by everyone
+        }
+    }
+
+    SET_DWORD_STAT(STAT_PlanetUpdatedPlanets, Active.Num());
+    SET_DWORD_STAT(STAT_PlanetGenerationBudget, GetTotalBudget());
+}
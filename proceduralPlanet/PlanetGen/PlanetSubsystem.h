@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PlanetSubsystem.generated.h"
+
+class APlanet;
+
+
+// One planet's slice of the world's generation budget, refreshed once per frame.
+struct FPlanetBudgetShare
+{
+        TWeakObjectPtr<APlanet> Planet;
+        float Weight = 0.f;        // Fraction of the observer's view the planet covers, floored at MinGenerationWeight. 0 if skipped
+        int32 Budget = 0;          // Generation tasks the planet may have in flight, 0 = none started this frame
+        bool bSkipUpdate = false;  // Far model shown and nothing left to generate or release: the chunk manager is not ticked
+};
+
+
+// Shares one generation budget between every planet of the world, so a system of planets cannot flood the task graph
+// with one MaxConcurrentGenerations each. Each planet's share follows the part of the view it covers, capped by its own
+// MaxConcurrentGenerations. A share can be 0 when there are more planets than tasks: those planets take turns.
+// Planets showing their far model with no chunks left are not updated at all.
+// Budget: "Planet.GenerationBudget" tasks in flight over the whole world.
+UCLASS()
+class PROCEDURALPLANET_API UPlanetSubsystem : public UWorldSubsystem
+{
+        GENERATED_BODY()
+
+    public:
+        void RegisterPlanet(APlanet *Planet);
+        void UnregisterPlanet(APlanet *Planet);
+
+        // This frame's share of Planet, null if it is not registered. The shares are recomputed on the first call of each frame,
+        // against that caller's observer location (world space).
+        const FPlanetBudgetShare *GetShare(const APlanet *Planet, const FVector &ObserverLocation);
+
+        const TArray<FPlanetBudgetShare> &GetShares() const { return Shares; }
+
+        // Tasks in flight allowed over all planets.
+        static int32 GetTotalBudget();
+
+    private:
+        TArray<FPlanetBudgetShare> Shares;
+        uint64 SharesFrame = MAX_uint64;  // GFrameCounter of the last UpdateShares
+        int32 RotationOffset = 0;         // First share served with the leftover tasks, advanced every UpdateShares
+
+        void UpdateShares(const FVector &ObserverLocation);
+};
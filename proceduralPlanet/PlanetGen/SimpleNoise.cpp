@@ -5,7 +5,7 @@
 int32 SimpleNoise::floor(float x) { return x >= 0 ? (int32)x : (int32)x - 1; }
 
 
-float SimpleNoise::getNoise(const FVector &Position, int32 Seed) const
+void SimpleNoise::findSimplexCell(const FVector &Position, int32 Seed, FSimplexCell &OutCell)
 {
     // Simplex noise constants
     const float F3 = 1.0f / 3.0f;
@@ -104,17 +104,215 @@ float SimpleNoise::getNoise(const FVector &Position, int32 Seed) const
     float y3 = y0 - 1.0f + 3.0f * G3;
     float z3 = z0 - 1.0f + 3.0f * G3;
 
+    const float Offsets[4][3] = {{x0, y0, z0}, {x1, y1, z1}, {x2, y2, z2}, {x3, y3, z3}};
+    FMemory::Memcpy(OutCell.Offsets, Offsets, sizeof(Offsets));
+
+    OutCell.Hashes[0] = hash(i, j, k, Seed);
+    OutCell.Hashes[1] = hash(i + i1, j + j1, k + k1, Seed);
+    OutCell.Hashes[2] = hash(i + i2, j + j2, k + k2, Seed);
+    OutCell.Hashes[3] = hash(i + 1, j + 1, k + 1, Seed);
+}
+
+
+float SimpleNoise::getNoise(const FVector &Position, int32 Seed) const
+{
+    FSimplexCell Cell;
+    findSimplexCell(Position, Seed, Cell);
+
     // Calculate the contribution from the four corners
     float n = 0.0f;
-    n += calculateCorner(x0, y0, z0, grad(hash(i, j, k, Seed), x0, y0, z0));
-    n += calculateCorner(x1, y1, z1, grad(hash(i + i1, j + j1, k + k1, Seed), x1, y1, z1));
-    n += calculateCorner(x2, y2, z2, grad(hash(i + i2, j + j2, k + k2, Seed), x2, y2, z2));
-    n += calculateCorner(x3, y3, z3, grad(hash(i + 1, j + 1, k + 1, Seed), x3, y3, z3));
+    for (int32 c = 0; c < 4; c++)
+    {
+        const float *d = Cell.Offsets[c];
+        n += calculateCorner(d[0], d[1], d[2], grad(Cell.Hashes[c], d[0], d[1], d[2]));
+    }
 
     // The result is scaled to stay just inside [-1,1]
     return 32.0f * n;
 }
 
+
+float SimpleNoise::getNoiseWithGradient(const FVector &Position, int32 Seed, FVector &OutGradient) const
+{
+    FSimplexCell Cell;
+    findSimplexCell(Position, Seed, Cell);
+
+    // Each corner contributes n = t^4 * dot(g, d) with t = 0.6 - |d|^2 and d = Position - Corner.
+    // Its derivative is dn/dd = t^4 * g - 8 * t^3 * dot(g, d) * d, and dd/dPosition is the identity.
+    float n = 0.0f;
+    float gx = 0.0f, gy = 0.0f, gz = 0.0f;
+    for (int32 c = 0; c < 4; c++)
+    {
+        const float *d = Cell.Offsets[c];
+        float t = 0.6f - d[0] * d[0] - d[1] * d[1] - d[2] * d[2];
+        if (t < 0)
+            continue;
+
+        const FVector &g = gradTable[Cell.Hashes[c] & 15];
+        const float gDotD = dot(g, d[0], d[1], d[2]);
+        const float t2 = t * t;
+        const float t3 = t2 * t;
+        const float t4 = t2 * t2;
+
+        n += t4 * gDotD;
+        gx += t4 * (float)g.X - 8.0f * t3 * gDotD * d[0];
+        gy += t4 * (float)g.Y - 8.0f * t3 * gDotD * d[1];
+        gz += t4 * (float)g.Z - 8.0f * t3 * gDotD * d[2];
+    }
+
+    // Same scale as getNoise()
+    OutGradient = FVector(gx, gy, gz) * 32.0f;
+    return 32.0f * n;
+}
+
+
+void SimpleNoise::getNoiseBatch(const float *X, const float *Y, const float *Z, int32 Count, int32 Seed, float *Out) const
+{
+    int32 Index = 0;
+    for (; Index + 4 <= Count; Index += 4)
+    {
+        getNoise4(X + Index, Y + Index, Z + Index, Seed, Out + Index);
+    }
+
+    // Tail: pad to a full lane group so every sample goes through the same kernel (keeps results bit-identical).
+    const int32 Remaining = Count - Index;
+    if (Remaining > 0)
+    {
+        float TailX[4] = {0.f, 0.f, 0.f, 0.f};
+        float TailY[4] = {0.f, 0.f, 0.f, 0.f};
+        float TailZ[4] = {0.f, 0.f, 0.f, 0.f};
+        float TailOut[4];
+        for (int32 Lane = 0; Lane < Remaining; ++Lane)
+        {
+            TailX[Lane] = X[Index + Lane];
+            TailY[Lane] = Y[Index + Lane];
+            TailZ[Lane] = Z[Index + Lane];
+        }
+
+        getNoise4(TailX, TailY, TailZ, Seed, TailOut);
+
+        for (int32 Lane = 0; Lane < Remaining; ++Lane)
+        {
+            Out[Index + Lane] = TailOut[Lane];
+        }
+    }
+}
+
+
+void SimpleNoise::getNoise4(const float *X, const float *Y, const float *Z, int32 Seed, float *Out)
+{
+    // Same algorithm as getNoise(), 4 samples at a time. Branches on the simplex ordering become lane masks,
+    // only the hash/gradient lookup stays scalar per lane.
+    const VectorRegister4Float One = VectorOne();
+    const VectorRegister4Float F3 = VectorSetFloat1(1.0f / 3.0f);
+    const VectorRegister4Float G3 = VectorSetFloat1(1.0f / 6.0f);
+    const VectorRegister4Float G3x2 = VectorSetFloat1(2.0f / 6.0f);
+    const VectorRegister4Float G3x3Minus1 = VectorSetFloat1(3.0f / 6.0f - 1.0f);
+
+    const VectorRegister4Float PX = VectorLoad(X);
+    const VectorRegister4Float PY = VectorLoad(Y);
+    const VectorRegister4Float PZ = VectorLoad(Z);
+
+    // Skew the input space to determine which simplex cell we're in
+    const VectorRegister4Float S = VectorMultiply(VectorAdd(VectorAdd(PX, PY), PZ), F3);
+    const VectorRegister4Float I = VectorFloor(VectorAdd(PX, S));
+    const VectorRegister4Float J = VectorFloor(VectorAdd(PY, S));
+    const VectorRegister4Float K = VectorFloor(VectorAdd(PZ, S));
+
+    // Unskew the cell origin back to (x,y,z) space and get the distances from it
+    const VectorRegister4Float T = VectorMultiply(VectorAdd(VectorAdd(I, J), K), G3);
+    const VectorRegister4Float X0 = VectorSubtract(PX, VectorSubtract(I, T));
+    const VectorRegister4Float Y0 = VectorSubtract(PY, VectorSubtract(J, T));
+    const VectorRegister4Float Z0 = VectorSubtract(PZ, VectorSubtract(K, T));
+
+    // Simplex ordering. Equivalent to the if/else tree in getNoise(), including tie-breaking.
+    const VectorRegister4Float XGeY = VectorCompareGE(X0, Y0);
+    const VectorRegister4Float XLtY = VectorCompareLT(X0, Y0);
+    const VectorRegister4Float YGeZ = VectorCompareGE(Y0, Z0);
+    const VectorRegister4Float YLtZ = VectorCompareLT(Y0, Z0);
+    const VectorRegister4Float XGeZ = VectorCompareGE(X0, Z0);
+    const VectorRegister4Float XLtZ = VectorCompareLT(X0, Z0);
+
+    const VectorRegister4Float I1 = VectorBitwiseAnd(VectorBitwiseAnd(XGeY, VectorBitwiseOr(YGeZ, XGeZ)), One);
+    const VectorRegister4Float J1 = VectorBitwiseAnd(VectorBitwiseAnd(XLtY, YGeZ), One);
+    const VectorRegister4Float K1 =
+        VectorBitwiseAnd(VectorBitwiseOr(VectorBitwiseAnd(XGeY, VectorBitwiseAnd(YLtZ, XLtZ)), VectorBitwiseAnd(XLtY, YLtZ)), One);
+    const VectorRegister4Float I2 = VectorBitwiseAnd(VectorBitwiseOr(XGeY, VectorBitwiseAnd(YGeZ, XGeZ)), One);
+    const VectorRegister4Float J2 = VectorBitwiseAnd(VectorBitwiseOr(XLtY, YGeZ), One);
+    const VectorRegister4Float K2 =
+        VectorBitwiseAnd(VectorBitwiseOr(VectorBitwiseAnd(XGeY, YLtZ), VectorBitwiseAnd(XLtY, VectorBitwiseOr(YLtZ, XLtZ))), One);
+
+    // Offsets of the remaining three corners
+    const VectorRegister4Float X1 = VectorAdd(VectorSubtract(X0, I1), G3);
+    const VectorRegister4Float Y1 = VectorAdd(VectorSubtract(Y0, J1), G3);
+    const VectorRegister4Float Z1 = VectorAdd(VectorSubtract(Z0, K1), G3);
+    const VectorRegister4Float X2 = VectorAdd(VectorSubtract(X0, I2), G3x2);
+    const VectorRegister4Float Y2 = VectorAdd(VectorSubtract(Y0, J2), G3x2);
+    const VectorRegister4Float Z2 = VectorAdd(VectorSubtract(Z0, K2), G3x2);
+    const VectorRegister4Float X3 = VectorAdd(X0, G3x3Minus1);
+    const VectorRegister4Float Y3 = VectorAdd(Y0, G3x3Minus1);
+    const VectorRegister4Float Z3 = VectorAdd(Z0, G3x3Minus1);
+
+    // Hashing is integer math with table lookups: do it per lane, then gather the gradients back into registers.
+    alignas(16) float CellI[4], CellJ[4], CellK[4];
+    alignas(16) float OffI1[4], OffJ1[4], OffK1[4], OffI2[4], OffJ2[4], OffK2[4];
+    VectorStoreAligned(I, CellI);
+    VectorStoreAligned(J, CellJ);
+    VectorStoreAligned(K, CellK);
+    VectorStoreAligned(I1, OffI1);
+    VectorStoreAligned(J1, OffJ1);
+    VectorStoreAligned(K1, OffK1);
+    VectorStoreAligned(I2, OffI2);
+    VectorStoreAligned(J2, OffJ2);
+    VectorStoreAligned(K2, OffK2);
+
+    alignas(16) float GX[4][4], GY[4][4], GZ[4][4];  // [Corner][Lane]
+    for (int32 Lane = 0; Lane < 4; ++Lane)
+    {
+        const int32 i = (int32)CellI[Lane];
+        const int32 j = (int32)CellJ[Lane];
+        const int32 k = (int32)CellK[Lane];
+        const int32 i1 = (int32)OffI1[Lane], j1 = (int32)OffJ1[Lane], k1 = (int32)OffK1[Lane];
+        const int32 i2 = (int32)OffI2[Lane], j2 = (int32)OffJ2[Lane], k2 = (int32)OffK2[Lane];
+
+        const int32 Hashes[4] = {
+            hash(i, j, k, Seed), hash(i + i1, j + j1, k + k1, Seed), hash(i + i2, j + j2, k + k2, Seed), hash(i + 1, j + 1, k + 1, Seed)};
+        for (int32 Corner = 0; Corner < 4; ++Corner)
+        {
+            const FVector &G = gradTable[Hashes[Corner] & 15];
+            GX[Corner][Lane] = (float)G.X;
+            GY[Corner][Lane] = (float)G.Y;
+            GZ[Corner][Lane] = (float)G.Z;
+        }
+    }
+
+    // Contribution of one corner: max(0, 0.6 - r^2)^4 * dot(grad, offset). Same as calculateCorner().
+    const VectorRegister4Float Falloff = VectorSetFloat1(0.6f);
+    const VectorRegister4Float Zero = VectorZero();
+    auto Corner = [&](const VectorRegister4Float &CX, const VectorRegister4Float &CY, const VectorRegister4Float &CZ, int32 CornerIndex)
+    {
+        VectorRegister4Float R2 = VectorMultiply(CX, CX);
+        R2 = VectorMultiplyAdd(CY, CY, R2);
+        R2 = VectorMultiplyAdd(CZ, CZ, R2);
+        VectorRegister4Float Tc = VectorMax(VectorSubtract(Falloff, R2), Zero);
+        Tc = VectorMultiply(Tc, Tc);
+        Tc = VectorMultiply(Tc, Tc);
+
+        VectorRegister4Float Dot = VectorMultiply(VectorLoadAligned(GX[CornerIndex]), CX);
+        Dot = VectorMultiplyAdd(VectorLoadAligned(GY[CornerIndex]), CY, Dot);
+        Dot = VectorMultiplyAdd(VectorLoadAligned(GZ[CornerIndex]), CZ, Dot);
+        return VectorMultiply(Tc, Dot);
+    };
+
+    VectorRegister4Float N = Corner(X0, Y0, Z0, 0);
+    N = VectorAdd(N, Corner(X1, Y1, Z1, 1));
+    N = VectorAdd(N, Corner(X2, Y2, Z2, 2));
+    N = VectorAdd(N, Corner(X3, Y3, Z3, 3));
+
+    // The result is scaled to stay just inside [-1,1]
+    VectorStore(VectorMultiply(N, VectorSetFloat1(32.0f)), Out);
+}
+
 // Initialize the gradient table
 const FVector SimpleNoise::gradTable[16] = {FVector(1, 1, 0),
                                             FVector(-1, 1, 0),
@@ -9,9 +9,30 @@
 class SimpleNoise : public IPlanetNoise
 {
     public:
+        virtual const TCHAR *getName() const override { return TEXT("SimpleNoise"); }
+        virtual uint32 getVersion() const override { return 1; }
+
         virtual float getNoise(const FVector &_position, int32 _seed) const override;
 
+        // Analytic derivative of the simplex kernel: same cost as a single getNoise() call.
+        virtual float getNoiseWithGradient(const FVector &_position, int32 _seed, FVector &_outGradient) const override;
+
+        // 4-wide SIMD kernel (SSE or NEON through the engine's VectorRegister layer).
+        virtual void getNoiseBatch(const float *_x, const float *_y, const float *_z, int32 _count, int32 _seed, float *_out) const override;
+
     private:
+        // The simplex containing a sample: offsets from its 4 corners and their gradient hashes.
+        struct FSimplexCell
+        {
+                float Offsets[4][3];
+                int32 Hashes[4];
+        };
+
+        static void findSimplexCell(const FVector &_position, int32 _seed, FSimplexCell &_outCell);
+
+        // Evaluates exactly 4 samples. Inputs and output must hold 4 floats.
+        static void getNoise4(const float *_x, const float *_y, const float *_z, int32 _seed, float *_out);
+
         // Helper for the Simplex algorithm
         static int32 floor(float x);
 
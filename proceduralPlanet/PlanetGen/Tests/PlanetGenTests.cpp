@@ -0,0 +1,770 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PlanetGen/ChunkCollisionManager.h"
+#include "PlanetGen/ChunkGenerator.h"
+#include "PlanetGen/ChunkKeySet.h"
+#include "PlanetGen/ChunkManager.h"
+#include "PlanetGen/DataTypes.h"
+#include "PlanetGen/DensityGenerator.h"
+#include "PlanetGen/MathUtils.h"
+#include "PlanetGen/MeshGenerator.h"
+#include "PlanetGen/PlanetBenchmark.h"
+#include "PlanetGen/SimpleNoise.h"
+
+#include "Components/SceneComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+
+// Session Frontend / -ExecCmds="Automation RunTests Planet". Everything here is headless and runs in a few seconds.
+
+namespace
+{
+// Angle between two directions, in degrees. Computed in double: float dot products cannot resolve 0.01 degree.
+double AngleDegrees(const FVector3f &A, const FVector3f &B)
+{
+    const FVector DA(A), DB(B);
+    return FMath::RadiansToDegrees(FMath::Atan2(FVector::CrossProduct(DA, DB).Size(), FVector::DotProduct(DA, DB)));
+}
+
+// Small planet shared by the generation tests: one root chunk per face, voxel size as APlanet::CalculateAutoGrid
+constexpr float TestRadius = 10000.f;
+constexpr int32 TestResolution = 16;
+
+DensityConfig MakeTestDensityConfig()
+{
+    DensityConfig Config;
+    Config.PlanetRadius = TestRadius;
+    Config.VoxelSize = (TestRadius * HALF_PI) / TestResolution;
+    return Config;
+}
+
+// Chunk field set up exactly as FChunkGenerator::StartAsyncTask. The densities are left to the caller.
+GenData BeginChunkField(const DensityGenerator &Generator, const FChunkId &Id)
+{
+    FVector2D UVMin, UVMax;
+    FMathUtils::GetChunkUVBounds(Id, UVMin, UVMax);
+    return Generator.BeginDensityField(TestResolution, FMathUtils::getFaceNormal(Id.FaceIndex), FMathUtils::getFaceRight(Id.FaceIndex),
+                                       FMathUtils::getFaceUp(Id.FaceIndex), UVMin * 2.0f - 1.0f, UVMax * 2.0f - 1.0f);
+}
+
+GenData GenerateChunkField(const DensityGenerator &Generator, const FChunkId &Id)
+{
+    GenData Field = BeginChunkField(Generator, Id);
+    Generator.GenerateDensitySlab(Field, 0, Field.SampleCount);
+    return Field;
+}
+
+FTransform GetTestChunkTransform(const FChunkId &Id)
+{
+    const FChunkTransform ChunkTransform = FMathUtils::ComputeChunkTransform(Id, TestRadius);
+    return FTransform(ChunkTransform.Rotation, ChunkTransform.Location);
+}
+}  // namespace
+
+
+#if PLANET_WITH_BENCHMARK
+// Stress filter: opt-in until golden hashes are recorded for the platform that runs it
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetBenchmarkGoldenTest, "Planet.Benchmark.Golden",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::StressFilter)
+
+bool FPlanetBenchmarkGoldenTest::RunTest(const FString &Parameters)
+{
+    // Two iterations: a case whose hash differs between them is reported as unstable
+    FPlanetBenchmark Benchmark(2);
+    Benchmark.Run();
+
+    FString Message;
+    const bool bMatches = Benchmark.CheckGolden(FPlanetBenchmark::GetGoldenPath(), false, Message);
+    TestTrue(FString::Printf(TEXT("Golden hashes: %s"), *Message), bMatches);
+    return true;
+}
+#endif  // PLANET_WITH_BENCHMARK
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetChunkKeyTest, "Planet.ChunkKey.Morton",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetChunkKeyTest::RunTest(const FString &Parameters)
+{
+    const int32 MaxCoord = (1 << FChunkKey::MaxLOD) - 1;
+    struct FKeyCase
+    {
+            uint8 Face;
+            int32 LOD, X, Y;
+    };
+    const FKeyCase Cases[] = {
+        {0, 0, 0, 0}, {1, 1, 1, 0}, {2, 5, 17, 30}, {4, 12, 0, 4095}, {3, FChunkKey::MaxLOD, MaxCoord, 0}, {5, FChunkKey::MaxLOD, MaxCoord, MaxCoord}};
+
+    for (const FKeyCase &Case : Cases)
+    {
+        const FChunkKey Key(Case.Face, Case.X, Case.Y, Case.LOD);
+        const FString Name = FString::Printf(TEXT("F%d L%d (%d, %d)"), Case.Face, Case.LOD, Case.X, Case.Y);
+        TestEqual(Name + TEXT(" face"), (int32)Key.GetFace(), (int32)Case.Face);
+        TestEqual(Name + TEXT(" LOD"), Key.GetLOD(), Case.LOD);
+        TestEqual(Name + TEXT(" X"), Key.GetX(), Case.X);
+        TestEqual(Name + TEXT(" Y"), Key.GetY(), Case.Y);
+
+        const FChunkId Id(Case.Face, FIntVector(Case.X, Case.Y, 0), Case.LOD);
+        TestTrue(Name + TEXT(" FChunkId from key"), FChunkId(Key) == Id);
+        TestTrue(Name + TEXT(" key from FChunkId"), Id.GetKey() == Key);
+
+        if (Case.LOD == FChunkKey::MaxLOD)
+            continue;
+
+        for (int32 i = 0; i < 4; i++)
+        {
+            const FChunkKey Child = Key.GetChild(i);
+            TestEqual(Name + TEXT(" child X"), Child.GetX(), Case.X * 2 + (i & 1));
+            TestEqual(Name + TEXT(" child Y"), Child.GetY(), Case.Y * 2 + (i >> 1));
+            TestEqual(Name + TEXT(" child LOD"), Child.GetLOD(), Case.LOD + 1);
+            TestEqual(Name + TEXT(" child face"), (int32)Child.GetFace(), (int32)Case.Face);
+            TestTrue(Name + TEXT(" parent of child"), Child.GetParent() == Key);
+        }
+    }
+
+    // Face first, then LOD, then Z-order with X on the even bits
+    TestTrue(TEXT("Face sorts before LOD"), FChunkKey(0, MaxCoord, MaxCoord, FChunkKey::MaxLOD) < FChunkKey(1, 0, 0, 0));
+    TestTrue(TEXT("LOD sorts before coordinates"), FChunkKey(0, 7, 7, 3) < FChunkKey(0, 0, 0, 4));
+    TestTrue(TEXT("X on the low Morton bit"), FChunkKey(0, 1, 0, 1) < FChunkKey(0, 0, 1, 1));
+    return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetChunkKeySetTest, "Planet.ChunkKeySet",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetChunkKeySetTest::RunTest(const FString &Parameters)
+{
+    TArray<FChunkId> Ids;
+    for (int32 i = 0; i < 200; i++)
+        Ids.Add(FChunkId(i % 6, FIntVector(i, i / 2, 0), 8));
+
+    FChunkKeySet Set;
+    for (const FChunkId &Id : Ids)
+        TestTrue(TEXT("Add a new ID"), Set.Add(Id));
+
+    TestFalse(TEXT("Add a duplicate"), Set.Add(Ids[0]));
+    TestEqual(TEXT("Num"), Set.Num(), Ids.Num());
+    TestFalse(TEXT("Contains an ID never added"), Set.Contains(FChunkId(0, FIntVector(201, 0, 0), 8)));
+    TestFalse(TEXT("Same coordinates on another LOD"), Set.Contains(FChunkId(Ids[5].FaceIndex, Ids[5].Coords, 9)));
+
+    int32 Index = 0;
+    for (const FChunkId &Id : Set)
+    {
+        TestTrue(TEXT("Contains every added ID"), Set.Contains(Id));
+        TestTrue(TEXT("Iterates in insertion order"), Id == Ids[Index++]);
+    }
+
+    Set.RemoveAll([](const FChunkId &Id) { return Id.Coords.X % 2 == 1; });
+    TestEqual(TEXT("Num after RemoveAll"), Set.Num(), Ids.Num() / 2);
+    Index = 0;
+    for (const FChunkId &Id : Set)
+    {
+        TestTrue(TEXT("RemoveAll keeps the order of the others"), Id == Ids[Index]);
+        Index += 2;
+    }
+    for (const FChunkId &Id : Ids)
+        TestTrue(TEXT("Contains after RemoveAll"), Set.Contains(Id) == (Id.Coords.X % 2 == 0));
+
+    // Rebuilding the set to the same size must not allocate
+    for (const FChunkId &Id : Ids)
+        Set.Add(Id);
+    const int64 AllocatedSize = (int64)Set.GetAllocatedSize();
+    Set.Reset();
+    TestEqual(TEXT("Num after Reset"), Set.Num(), 0);
+    TestFalse(TEXT("Contains after Reset"), Set.Contains(Ids[0]));
+    for (const FChunkId &Id : Ids)
+        Set.Add(Id);
+    TestEqual(TEXT("Reset keeps the memory"), (int64)Set.GetAllocatedSize(), AllocatedSize);
+    return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetNormalEncodingTest, "Planet.MeshData.NormalEncoding",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetNormalEncodingTest::RunTest(const FString &Parameters)
+{
+    TArray<FVector3f> Normals = {FVector3f::UpVector,
+                                 -FVector3f::UpVector,
+                                 FVector3f::ForwardVector,
+                                 -FVector3f::ForwardVector,
+                                 FVector3f::RightVector,
+                                 -FVector3f::RightVector,
+                                 FVector3f(1.f, 1.f, 1.f).GetSafeNormal(),
+                                 FVector3f(-1.f, 1.f, -1.f).GetSafeNormal(),
+                                 FVector3f(1.f, -1.f, 0.f).GetSafeNormal()};
+
+    FRandomStream Random(1337);
+    for (int32 i = 0; i < 4096; i++)
+        Normals.Add(FVector3f(Random.GetUnitVector()));
+
+    double MaxError = 0.0;
+    for (const FVector3f &N : Normals)
+        MaxError = FMath::Max(MaxError, AngleDegrees(N, FChunkMeshData::DecodeNormal(FChunkMeshData::EncodeNormal(N))));
+
+    TestTrue(FString::Printf(TEXT("Angular error %.5f degrees < 0.01"), MaxError), MaxError < 0.01);
+    TestTrue(TEXT("Zero vector encodes as up"),
+             FChunkMeshData::DecodeNormal(FChunkMeshData::EncodeNormal(FVector3f::ZeroVector)).Equals(FVector3f::UpVector, 1e-4f));
+    return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetPositionQuantizationTest, "Planet.MeshData.PositionQuantization",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetPositionQuantizationTest::RunTest(const FString &Parameters)
+{
+    constexpr float Radius = 10000.f;
+    constexpr int32 Resolution = 32;
+    constexpr float SurfaceHalfHeight = 400.f;
+
+    // The fixed box holds the surface band of every chunk of its LOD, corner chunks (strongest warp) and center ones alike
+    for (int32 LOD = 0; LOD <= 8; LOD++)
+    {
+        const FBox3f Box = FMathUtils::GetChunkQuantizationBox(LOD, Radius, SurfaceHalfHeight);
+        const int32 Center = (1 << LOD) / 2;
+        for (const FChunkId &Id : {FChunkId(0, FIntVector(0, 0, 0), LOD), FChunkId(2, FIntVector(Center, Center, 0), LOD)})
+        {
+            const FChunkTransform ChunkTransform = FMathUtils::ComputeChunkTransform(Id, Radius);
+            const FTransform Transform(ChunkTransform.Rotation, ChunkTransform.Location);
+
+            FVector2D UVMin, UVMax;
+            FMathUtils::GetChunkUVBounds(Id, UVMin, UVMax);
+            const FVector FaceNormal = FMathUtils::getFaceNormal(Id.FaceIndex);
+            const FVector FaceRight = FMathUtils::getFaceRight(Id.FaceIndex);
+            const FVector FaceUp = FMathUtils::getFaceUp(Id.FaceIndex);
+
+            for (int32 y = 0; y <= Resolution; y += Resolution / 4)
+            {
+                for (int32 x = 0; x <= Resolution; x += Resolution / 4)
+                {
+                    const FVector Direction = DensityGenerator::GetColumnDirection(x, y, Resolution, FaceNormal, FaceRight, FaceUp, UVMin * 2.0f - 1.0f,
+                                                                                   UVMax * 2.0f - 1.0f);
+                    for (float Height : {-SurfaceHalfHeight, SurfaceHalfHeight})
+                    {
+                        const FVector3f Local(Transform.InverseTransformPosition(Direction * (Radius + Height)));
+                        TestTrue(FString::Printf(TEXT("LOD %d chunk (%d, %d) column (%d, %d) inside the box"), LOD, Id.Coords.X, Id.Coords.Y, x, y),
+                                 Box.IsInsideOrOn(Local));
+                    }
+                }
+            }
+        }
+    }
+
+    const FBox3f Box = FMathUtils::GetChunkQuantizationBox(4, Radius, SurfaceHalfHeight);
+    const FVector3f Tolerance = (Box.Max - Box.Min) / (2.f * MAX_uint16) + FVector3f(1e-3f);  // Half a step, plus float rounding
+
+    FRandomStream Random(42);
+    TArray<FVector3f> Positions = {Box.Min, Box.Max};
+    for (int32 i = 0; i < 512; i++)
+    {
+        Positions.Add(FVector3f(Random.FRandRange(Box.Min.X, Box.Max.X), Random.FRandRange(Box.Min.Y, Box.Max.Y), Random.FRandRange(Box.Min.Z, Box.Max.Z)));
+    }
+
+    FChunkMeshData Mesh;
+    Mesh.SetPositions(Positions, {}, Box);
+    Mesh.Normals.Init(FChunkMeshData::EncodeNormal(FVector3f::UpVector), Positions.Num());
+
+    const FBox LocalBounds = Mesh.GetLocalBounds();
+    for (int32 i = 0; i < Positions.Num(); i++)
+    {
+        const FVector3f Error = (Mesh.GetPosition(i) - Positions[i]).GetAbs();
+        const bool bWithinHalfStep = Error.X <= Tolerance.X && Error.Y <= Tolerance.Y && Error.Z <= Tolerance.Z;
+        if (!TestTrue(FString::Printf(TEXT("Vertex %d within half a step"), i), bWithinHalfStep))
+            break;
+        TestTrue(TEXT("Culling bounds hold the decoded vertex"), LocalBounds.IsInsideOrOn(FVector(Mesh.GetPosition(i))));
+    }
+
+    // Seam vertices follow the interior ones and keep their exact position, so neighbours decode their shared copies alike
+    const FVector3f SeamVertex = Positions[7] + FVector3f(0.3f);
+    FChunkMeshData Neighbour;
+    Neighbour.SetPositions({Positions[7] * 0.5f, FVector3f::ZeroVector}, {SeamVertex}, Box);
+    Neighbour.Normals.Init(FChunkMeshData::EncodeNormal(FVector3f::UpVector), 3);
+    TestEqual(TEXT("Interior vertices first"), Neighbour.GetNumInteriorVertices(), 2);
+    TestTrue(TEXT("Seam vertex kept exactly"), Neighbour.GetPosition(2) == SeamVertex);
+    TestTrue(TEXT("Culling bounds hold the seam vertex"), Neighbour.GetLocalBounds().IsInsideOrOn(FVector(SeamVertex)));
+    TestTrue(TEXT("Culling bounds fit the mesh, not the quantization box"), Neighbour.BoundsSize.X < Box.GetSize().X);
+
+    TArray<FVector> Decoded;
+    FChunkMeshData::DecodePositions(Neighbour.Positions, Neighbour.SeamPositions, Neighbour.QuantizationMin, Neighbour.QuantizationSize, Decoded);
+    TestTrue(TEXT("DecodePositions appends the seam vertices"), Decoded.Num() == 3 && Decoded[2] == FVector(SeamVertex));
+    return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetNoiseBatchTest, "Planet.Noise.BatchMatchesScalar",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetNoiseBatchTest::RunTest(const FString &Parameters)
+{
+    SimpleNoise Noise;
+    constexpr int32 Seed = 1337;
+
+    // Not a multiple of the 4-wide kernel, so the tail is covered too. Lattice points first: the simplex cell lookup's edge cases.
+    constexpr int32 Count = 37;
+    float X[Count], Y[Count], Z[Count], Out[Count];
+    FRandomStream Random(7);
+    for (int32 i = 0; i < Count; i++)
+    {
+        X[i] = i < 3 ? (float)i : Random.FRandRange(-100.f, 100.f);
+        Y[i] = i < 3 ? (float)-i : Random.FRandRange(-100.f, 100.f);
+        Z[i] = i < 3 ? 0.f : Random.FRandRange(-100.f, 100.f);
+    }
+
+    Noise.getNoiseBatch(X, Y, Z, Count, Seed, Out);
+
+    for (int32 i = 0; i < Count; i++)
+    {
+        const FVector Position(X[i], Y[i], Z[i]);
+        const float Scalar = Noise.getNoise(Position, Seed);
+        TestEqual(FString::Printf(TEXT("Batch sample %d"), i), Out[i], Scalar, 1e-5f);
+
+        FVector Gradient;
+        TestEqual(FString::Printf(TEXT("Gradient value %d"), i), Noise.getNoiseWithGradient(Position, Seed, Gradient), Scalar, 1e-5f);
+    }
+
+    // Analytic gradient against central differences, close to the origin where float positions are precise
+    constexpr float Eps = 1e-3f;
+    for (int32 i = 0; i < 64; i++)
+    {
+        const FVector Position = FVector(Random.GetUnitVector()) * Random.FRandRange(0.f, 10.f);
+        FVector Gradient;
+        Noise.getNoiseWithGradient(Position, Seed, Gradient);
+
+        const FVector Numeric(Noise.getNoise(Position + FVector(Eps, 0, 0), Seed) - Noise.getNoise(Position - FVector(Eps, 0, 0), Seed),
+                              Noise.getNoise(Position + FVector(0, Eps, 0), Seed) - Noise.getNoise(Position - FVector(0, Eps, 0), Seed),
+                              Noise.getNoise(Position + FVector(0, 0, Eps), Seed) - Noise.getNoise(Position - FVector(0, 0, Eps), Seed));
+        TestTrue(FString::Printf(TEXT("Analytic gradient %d"), i), Gradient.Equals(Numeric / (2.f * Eps), 1e-2f));
+    }
+    return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetCollisionMeshTest, "Planet.Collision.BuildCollisionMesh",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetCollisionMeshTest::RunTest(const FString &Parameters)
+{
+    // Flat 17 x 17 vertex grid, unit spacing, two triangles per quad
+    constexpr int32 Size = 17;
+    TArray<FVector> Vertices;
+    TArray<int32> Triangles;
+    for (int32 y = 0; y < Size; y++)
+    {
+        for (int32 x = 0; x < Size; x++)
+        {
+            Vertices.Add(FVector(x, y, 0.f));
+            if (x + 1 < Size && y + 1 < Size)
+            {
+                const int32 V = x + y * Size;
+                Triangles.Append({V, V + Size, V + 1, V + 1, V + Size, V + Size + 1});
+            }
+        }
+    }
+
+    TArray<FVector> OutVertices;
+    TArray<int32> OutTriangles;
+
+    FChunkCollisionManager::BuildCollisionMesh(Vertices, Triangles, 0.f, Vertices.Num(), OutVertices, OutTriangles);
+    TestTrue(TEXT("No cell size copies the mesh"), OutVertices == Vertices && OutTriangles == Triangles);
+
+    // Cells smaller than the spacing: one vertex per cell, nothing collapses
+    FChunkCollisionManager::BuildCollisionMesh(Vertices, Triangles, 0.5f, Vertices.Num(), OutVertices, OutTriangles);
+    TestEqual(TEXT("Fine cells keep every vertex"), OutVertices.Num(), Vertices.Num());
+    TestEqual(TEXT("Fine cells keep every triangle"), OutTriangles.Num(), Triangles.Num());
+
+    FChunkCollisionManager::BuildCollisionMesh(Vertices, Triangles, 4.f, Vertices.Num(), OutVertices, OutTriangles);
+    TestTrue(TEXT("Coarse cells merge vertices"), OutVertices.Num() <= 25 && OutVertices.Num() > 0);
+    TestTrue(TEXT("Coarse cells drop triangles"), OutTriangles.Num() > 0 && OutTriangles.Num() < Triangles.Num());
+    TestEqual(TEXT("Whole triangles"), OutTriangles.Num() % 3, 0);
+
+    const FBox InputBounds(Vertices);
+    for (const FVector &V : OutVertices)
+        TestTrue(TEXT("Clusters stay within the source mesh"), InputBounds.IsInsideOrOn(V));
+
+    for (int32 t = 0; t + 2 < OutTriangles.Num(); t += 3)
+    {
+        const int32 A = OutTriangles[t], B = OutTriangles[t + 1], C = OutTriangles[t + 2];
+        TestTrue(TEXT("Valid indices"), OutVertices.IsValidIndex(A) && OutVertices.IsValidIndex(B) && OutVertices.IsValidIndex(C));
+        TestTrue(TEXT("No degenerate triangle"), A != B && B != C && A != C);
+    }
+
+    // Border vertices last, as the mesher stores seam vertices: pinned, they must come out unchanged and still in use
+    TArray<int32> NewIndex;
+    NewIndex.SetNumUninitialized(Vertices.Num());
+    TArray<FVector> Ordered;
+    for (int32 Pass = 0; Pass < 2; Pass++)
+    {
+        for (int32 i = 0; i < Vertices.Num(); i++)
+        {
+            const int32 x = i % Size, y = i / Size;
+            const bool bBorder = x == 0 || y == 0 || x == Size - 1 || y == Size - 1;
+            if (bBorder == (Pass == 1))
+                NewIndex[i] = Ordered.Add(Vertices[i]);
+        }
+    }
+    const int32 FirstBorder = (Size - 2) * (Size - 2);
+    TArray<int32> OrderedTriangles;
+    for (int32 Index : Triangles)
+        OrderedTriangles.Add(NewIndex[Index]);
+
+    FChunkCollisionManager::BuildCollisionMesh(Ordered, OrderedTriangles, 4.f, FirstBorder, OutVertices, OutTriangles);
+    TestTrue(TEXT("Pinned mesh is decimated"), OutTriangles.Num() < OrderedTriangles.Num());
+    for (int32 i = FirstBorder; i < Ordered.Num(); i++)
+    {
+        const int32 Out = OutVertices.IndexOfByKey(Ordered[i]);
+        if (!TestTrue(FString::Printf(TEXT("Border vertex %d kept"), i), Out != INDEX_NONE))
+            break;
+        TestTrue(FString::Printf(TEXT("Border vertex %d still used"), i), OutTriangles.Contains(Out));
+    }
+    return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetMeshWeldTest, "Planet.Mesher.WeldedVertices",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetMeshWeldTest::RunTest(const FString &Parameters)
+{
+    SimpleNoise Noise;
+    const DensityGenerator DensityGen(MakeTestDensityConfig(), &Noise);
+    const FChunkId Id(0, FIntVector(1, 2, 0), 2);
+    const GenData Field = GenerateChunkField(DensityGen, Id);
+    const FChunkMeshData Mesh = MeshGenerator::GenerateMesh(Field, TestResolution, GetTestChunkTransform(Id), FTransform::Identity, Id.LODLevel, DensityGen);
+
+    const int32 NumVertices = Mesh.GetNumVertices();
+    const int32 NumTriangles = Mesh.Triangles.Num() / 3;
+    TestTrue(TEXT("Surface crosses the chunk"), NumTriangles > 0);
+    TestEqual(TEXT("Whole triangles"), Mesh.Triangles.Num() % 3, 0);
+    TestEqual(TEXT("One normal per vertex"), Mesh.Normals.Num(), NumVertices);
+
+    // The edge cache emits each crossing once: a surface sheet has about half as many vertices as triangles, a triangle soup three times as many
+    TestTrue(FString::Printf(TEXT("Welded (%d vertices, %d triangles)"), NumVertices, NumTriangles), NumVertices < NumTriangles);
+
+    TArray<bool> Used;
+    Used.SetNumZeroed(NumVertices);
+    TMap<uint64, int32> EdgeUses;
+    bool bIndicesValid = true;
+    for (int32 t = 0; t < Mesh.Triangles.Num(); t += 3)
+    {
+        for (int32 c = 0; c < 3; c++)
+        {
+            const int32 A = Mesh.Triangles[t + c];
+            const int32 B = Mesh.Triangles[t + (c + 1) % 3];
+            bIndicesValid &= A >= 0 && A < NumVertices;
+            if (!bIndicesValid)
+                break;
+            Used[A] = true;
+            EdgeUses.FindOrAdd(((uint64)FMath::Min(A, B) << 32) | (uint32)FMath::Max(A, B))++;
+        }
+    }
+    if (!TestTrue(TEXT("Indices in range"), bIndicesValid))
+        return true;
+    TestFalse(TEXT("Every vertex is used"), Used.Contains(false));
+
+    // Neighbouring cubes share the vertices of their common face: interior edges belong to two triangles, only border edges to one
+    int32 SharedEdges = 0;
+    for (const TPair<uint64, int32> &Edge : EdgeUses)
+    {
+        SharedEdges += Edge.Value >= 2 ? 1 : 0;
+    }
+    TestTrue(FString::Printf(TEXT("Most edges shared (%d / %d)"), SharedEdges, EdgeUses.Num()), SharedEdges * 2 > EdgeUses.Num());
+    return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetSeamStitchTest, "Planet.Mesher.SeamStitchCoarserNeighbour",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetSeamStitchTest::RunTest(const FString &Parameters)
+{
+    SimpleNoise Noise;
+    const DensityGenerator DensityGen(MakeTestDensityConfig(), &Noise);
+
+    // The +X neighbour of the fine chunk is a child of the coarse one: the fine +X edge is the lower half of the coarse -X edge
+    const FChunkId Fine(0, FIntVector(1, 0, 0), 2);
+    const FChunkId Coarse(0, FIntVector(1, 0, 0), 1);
+    FChunkSeams Seams;
+    Seams.CoarserLODs[FChunkSeams::PosX] = 1;
+
+    const FTransform FineTransform = GetTestChunkTransform(Fine);
+    const FChunkMeshData FineMesh = MeshGenerator::GenerateMesh(GenerateChunkField(DensityGen, Fine), TestResolution, FineTransform, FTransform::Identity,
+                                                                Fine.LODLevel, DensityGen, [](int32) {}, nullptr, Seams);
+    TestTrue(TEXT("Stitched mesh keeps its seams"), FineMesh.Seams == Seams);
+
+    TArray<FVector> FineSeamVertices;
+    for (int32 i = FineMesh.GetNumInteriorVertices(); i < FineMesh.GetNumVertices(); i++)
+    {
+        FineSeamVertices.Add(FineTransform.TransformPosition(FVector(FineMesh.GetPosition(i))));
+    }
+
+    // The crossings the coarse mesher finds on its side of the seam, from the coarse field itself
+    const GenData CoarseField = GenerateChunkField(DensityGen, Coarse);
+    TArray<FVector> CoarseCrossings;
+    auto AddCrossing = [&CoarseField, &CoarseCrossings](int32 y0, int32 z0, int32 y1, int32 z1)
+    {
+        const float D0 = CoarseField.Densities[CoarseField.GetIndex(0, y0, z0)];
+        const float D1 = CoarseField.Densities[CoarseField.GetIndex(0, y1, z1)];
+        if ((D0 > 0.f) != (D1 > 0.f))
+        {
+            const FVector P0 = CoarseField.GetPosition(0, y0, z0);
+            CoarseCrossings.Add(P0 + FMathUtils::computeInterpAlpha(D0, D1) * (CoarseField.GetPosition(0, y1, z1) - P0));
+        }
+    };
+    for (int32 z = 0; z < CoarseField.SampleCount; z++)
+    {
+        for (int32 y = 0; y <= TestResolution / 2; y++)
+        {
+            if (y < TestResolution / 2)
+                AddCrossing(y, z, y + 1, z);
+            if (z + 1 < CoarseField.SampleCount)
+                AddCrossing(y, z, y, z + 1);
+        }
+    }
+    TestTrue(TEXT("Surface crosses the seam"), CoarseCrossings.Num() > 0);
+
+    // Without stitching, the fine edge would cross the surface between the coarse grid points instead
+    constexpr double Tolerance = 1.0;  // World units, about a thousandth of a voxel
+    for (int32 i = 0; i < CoarseCrossings.Num(); i++)
+    {
+        double Closest = DBL_MAX;
+        for (const FVector &Vertex : FineSeamVertices)
+        {
+            Closest = FMath::Min(Closest, FVector::Dist(Vertex, CoarseCrossings[i]));
+        }
+        if (!TestTrue(FString::Printf(TEXT("Coarse crossing %d has a fine vertex (%.3f away)"), i, Closest), Closest <= Tolerance))
+            break;
+    }
+    return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetParentDensityReuseTest, "Planet.Density.ParentReuseIdentical",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetParentDensityReuseTest::RunTest(const FString &Parameters)
+{
+    SimpleNoise Noise;
+    const DensityGenerator DensityGen(MakeTestDensityConfig(), &Noise);
+
+    const FChunkId Parent(0, FIntVector(0, 1, 0), 1);
+    const FRetainedDensityPtr Retained = DensityGen.RetainDensity(GenerateChunkField(DensityGen, Parent));
+    TestTrue(TEXT("Parent retains its noise band"), Retained->NumSlices > 0);
+
+    // Shared samples sit on power-of-two fractions of the face, so parent and child compute bit-identical positions:
+    // copying them must give exactly the field evaluated from scratch
+    for (int32 Child = 0; Child < 4; Child++)
+    {
+        const FChunkId Id(0, FIntVector(Parent.Coords.X * 2 + (Child & 1), Parent.Coords.Y * 2 + (Child >> 1), 0), Parent.LODLevel + 1);
+        const GenData Evaluated = GenerateChunkField(DensityGen, Id);
+
+        GenData Seeded = BeginChunkField(DensityGen, Id);
+        const FIntPoint ParentOffset((Id.Coords.X & 1) * (TestResolution / 2), (Id.Coords.Y & 1) * (TestResolution / 2));  // As StartAsyncTask
+        DensityGen.GenerateDensitySlab(Seeded, 0, Seeded.SampleCount, nullptr, Retained.Get(), ParentOffset);
+
+        const bool bIdentical = Seeded.Densities.Num() == Evaluated.Densities.Num() &&
+                                FMemory::Memcmp(Seeded.Densities.GetData(), Evaluated.Densities.GetData(), Seeded.Densities.Num() * sizeof(float)) == 0;
+        TestTrue(FString::Printf(TEXT("Child %d seeded field is byte-identical"), Child), bIdentical);
+    }
+    return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetSurfaceQueryTest, "Planet.Density.SurfaceQueries",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetSurfaceQueryTest::RunTest(const FString &Parameters)
+{
+    SimpleNoise Noise;
+    const DensityConfig Config = MakeTestDensityConfig();
+    const DensityGenerator DensityGen(Config, &Noise);
+
+    // More than one block of FindSurfaceRadii
+    constexpr int32 Count = FPlanetStatics::SurfaceQueryBatchSize * 2 + 5;
+    TArray<FVector> Directions;
+    FRandomStream Random(11);
+    for (int32 i = 0; i < Count; i++)
+    {
+        Directions.Add(FVector(Random.GetUnitVector()));
+    }
+    TArray<float> Radii;
+    Radii.SetNumUninitialized(Count);
+    DensityGen.FindSurfaceRadii(Directions.GetData(), nullptr, Count, Radii.GetData());
+
+    // The crossing is bisected inside one sphere-tracing step, which never exceeds the terrain shell
+    const float Shell = 2.f * (DensityGen.GetNoiseBound() + FPlanetStatics::SurfaceQueryMinStep) * Config.VoxelSize;
+    const float DistanceTolerance = Shell / (1 << FPlanetStatics::SurfaceQueryRefineSteps);
+    const float DensityTolerance = DistanceTolerance * DensityGen.GetLipschitzBound();
+
+    for (int32 i = 0; i < Count; i++)
+    {
+        const FString Name = FString::Printf(TEXT("Direction %d"), i);
+        TestTrue(Name + TEXT(" inside the terrain shell"), FMath::Abs(Radii[i] - Config.PlanetRadius) <= 0.5f * Shell);
+
+        const float WorldDensity = DensityGen.SampleDensity(Directions[i] * Radii[i]) * Config.VoxelSize;
+        TestTrue(FString::Printf(TEXT("%s on the surface (density %.3f)"), *Name, WorldDensity), FMath::Abs(WorldDensity) <= DensityTolerance);
+
+        // Straight down from above the terrain: the same first surface
+        const FVector Origin = Directions[i] * (Config.PlanetRadius + Shell);
+        float Distance = 0.f;
+        if (TestTrue(Name + TEXT(" ray hits"), DensityGen.RaycastSurface(Origin, -Directions[i], 2.f * Shell, Distance)))
+        {
+            TestEqual(Name + TEXT(" ray agrees with the radius query"), (float)Origin.Size() - Distance, Radii[i], 2.f * DistanceTolerance);
+        }
+    }
+
+    // A ray starting underground hits at once
+    float Distance = -1.f;
+    TestTrue(TEXT("Underground ray hits"), DensityGen.RaycastSurface(FVector(0.f, 0.f, Config.PlanetRadius * 0.5f), FVector::UpVector, 10.f, Distance));
+    TestEqual(TEXT("Underground hit distance"), Distance, 0.f);
+    return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetCancellationTest, "Planet.Generator.Cancellation",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetCancellationTest::RunTest(const FString &Parameters)
+{
+    SimpleNoise Noise;
+    const DensityConfig DensityCfg = MakeTestDensityConfig();
+    const DensityGenerator DensityGen(DensityCfg, &Noise);
+
+    // The mesher drops a cancelled mesh instead of returning a partial one
+    const FChunkId Id(0, FIntVector(0, 0, 0), 1);
+    const GenData Field = GenerateChunkField(DensityGen, Id);
+    const FTransform Transform = GetTestChunkTransform(Id);
+    FThreadSafeBool CancelFlag = false;
+    TestTrue(TEXT("Mesh without cancellation"),
+             MeshGenerator::GenerateMesh(Field, TestResolution, Transform, FTransform::Identity, Id.LODLevel, DensityGen, &CancelFlag).Triangles.Num() > 0);
+    CancelFlag = true;
+    const FChunkMeshData CancelledMesh =
+        MeshGenerator::GenerateMesh(Field, TestResolution, Transform, FTransform::Identity, Id.LODLevel, DensityGen, &CancelFlag);
+    TestTrue(TEXT("Cancelled mesh is empty"), CancelledMesh.Triangles.Num() == 0 && CancelledMesh.GetNumVertices() == 0);
+
+    FPlanetConfig Config;
+    Config.PlanetRadius = DensityCfg.PlanetRadius;
+    Config.VoxelSize = DensityCfg.VoxelSize;
+    Config.GridResolution = TestResolution;
+    Config.MaxLOD = 3;
+
+    FChunkGenerator Generator(Config, &DensityGen);
+    TArray<FChunkId> Delivered;
+    Generator.SetOnChunkGeneratedCallback([&Delivered](const FChunkId &ChunkId, uint32, TUniquePtr<FChunkMeshData>, FRetainedDensityPtr)
+                                          { Delivered.Add(ChunkId); });
+
+    // Queued: dropped on the spot
+    const FChunkId Queued(1, FIntVector(0, 0, 0), 0);
+    Generator.RequestChunk(Queued, 1);
+    TestEqual(TEXT("Request queued"), Generator.GetPendingCount(), 1);
+    Generator.CancelRequest(Queued);
+    TestEqual(TEXT("Cancelled request leaves the queue"), Generator.GetPendingCount(), 0);
+
+    // In flight: the worker is told to stop and its result never reaches the callback, the other chunk's does
+    const FChunkId Kept(2, FIntVector(0, 0, 0), 0);
+    const FChunkId Dropped(3, FIntVector(0, 0, 0), 0);
+    Generator.RequestChunk(Kept, 1);
+    Generator.RequestChunk(Dropped, 1);
+
+    FPlanetViewContext Context;
+    Context.ObserverLocation = FVector(0.f, 0.f, Config.PlanetRadius * 2.f);
+    Context.ObserverForward = FVector(1.f, 0.f, 0.f);
+    Context.ObserverVelocity = FVector::ZeroVector;
+    Context.ViewDistance = 100000.f;
+    Generator.Update(Context);
+    TestTrue(TEXT("Both chunks dispatched"), Generator.IsTaskActive(Kept) && Generator.IsTaskActive(Dropped));
+
+    Generator.CancelRequest(Dropped);
+    const double Timeout = FPlatformTime::Seconds() + 10.0;
+    while (Generator.GetActiveTaskCount() > 0 && FPlatformTime::Seconds() < Timeout)
+    {
+        Generator.ProcessCompletedTasks();
+        FPlatformProcess::Sleep(0.001f);
+    }
+
+    TestEqual(TEXT("Workers drained"), Generator.GetActiveTaskCount(), 0);
+    TestTrue(TEXT("Only the kept chunk was delivered"), Delivered.Num() == 1 && Delivered[0] == Kept);
+    TestEqual(TEXT("Cancellation counted"), Generator.GetCancelStats().CancelledCount, 1);
+    TestEqual(TEXT("Nothing pending"), Generator.GetPendingCount(), 0);
+
+    Generator.Stop();
+    return true;
+}
+
+#if PLANET_TRACK_UPDATE_ALLOCATIONS
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetSteadyStateAllocationTest, "Planet.ChunkManager.SteadyStateAllocations",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetSteadyStateAllocationTest::RunTest(const FString &Parameters)
+{
+    // Small planet in a transient world: a few hundred chunks, settled in well under a second
+    FPlanetConfig Config;
+    Config.PlanetRadius = 10000.f;
+    Config.GridResolution = 16;
+    Config.MaxLOD = 3;
+    Config.VoxelSize = (Config.PlanetRadius * HALF_PI) / Config.GridResolution;  // As APlanet::CalculateAutoGrid
+    Config.MeshCacheBudgetMB = 0;
+
+    DensityConfig DensityCfg;
+    DensityCfg.PlanetRadius = Config.PlanetRadius;
+    DensityCfg.VoxelSize = Config.VoxelSize;
+    SimpleNoise Noise;
+    const DensityGenerator DensityGen(DensityCfg, &Noise);
+
+    UWorld *World = UWorld::CreateWorld(EWorldType::Game, false);
+    FWorldContext &WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+
+    AActor *Owner = World->SpawnActor<AActor>();
+    USceneComponent *Root = NewObject<USceneComponent>(Owner);
+    Owner->SetRootComponent(Root);
+    Root->RegisterComponent();
+
+    {
+        FChunkManager Manager(Config, &DensityGen);
+        Manager.Initialize(Owner, nullptr);
+
+        FPlanetViewContext Context;
+        Context.ObserverLocation = FVector(0.f, 0.f, Config.PlanetRadius + 2000.f);
+        Context.ObserverForward = FVector(1.f, 0.f, 0.f);
+        Context.ObserverVelocity = FVector::ZeroVector;
+        Context.ViewDistance = 100000.f;
+
+        // Settled: nothing queued, running, uploading or changing LOD for longer than a demotion takes to release
+        const int32 SettleFrames = Config.ChunkDemotionFrameDelay * 4;
+        int32 QuietFrames = 0;
+        const double Timeout = FPlatformTime::Seconds() + 30.0;
+        while (QuietFrames < SettleFrames && FPlatformTime::Seconds() < Timeout)
+        {
+            Manager.Update(Context);
+            const bool bQuiet = Manager.GetPendingCount() == 0 && Manager.GetActiveGenerationCount() == 0 &&
+                                Manager.GetUploadStats().UploadedLastFrame == 0 && !Manager.GetQuadtree()->HasLeafChanges();
+            QuietFrames = bQuiet ? QuietFrames + 1 : 0;
+            FPlatformProcess::Sleep(0.001f);
+        }
+        TestTrue(TEXT("Manager settled"), QuietFrames >= SettleFrames);
+        TestTrue(TEXT("Chunks generated"), Manager.GetVisibleChunkCount() > 0);
+
+        // Hovering: the observer moves a little, never enough to change a LOD decision
+        const int32 GrowthBefore = Manager.GetUpdateAllocationStats().GrowthFrames;
+        for (int32 Frame = 0; Frame < 120; Frame++)
+        {
+            Context.ObserverLocation.X = FMath::Sin(Frame * 0.1f) * 10.f;
+            Manager.Update(Context);
+        }
+        TestFalse(TEXT("LOD unchanged while hovering"), Manager.GetQuadtree()->HasLeafChanges());
+        TestEqual(TEXT("Steady updates grow no container"), Manager.GetUpdateAllocationStats().GrowthFrames, GrowthBefore);
+    }
+
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    return true;
+}
+#endif  // PLANET_TRACK_UPDATE_ALLOCATIONS
+
+#endif  // WITH_DEV_AUTOMATION_TESTS
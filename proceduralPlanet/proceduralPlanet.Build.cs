@@ -11,6 +11,8 @@ public class proceduralPlanet : ModuleRules
 		PublicDependencyModuleNames.AddRange(new string[] { "Core",
 															"CoreUObject",
 															"Engine",
+															"RenderCore",
+															"RHI",
 															"InputCore",
 															"HeadMountedDisplay",
 															"ProceduralMeshComponent",
@@ -18,7 +20,8 @@ public class proceduralPlanet : ModuleRules
 															"Slate",
 															"SlateCore" });
 
-		PrivateDependencyModuleNames.AddRange(new string[] { });
+		// Optional GPU density backend (EChunkDensityBackend::GPUCompute). FChunkGenerator falls back to the CPU if it is not loaded.
+		PrivateDependencyModuleNames.AddRange(new string[] { "proceduralPlanetCompute" });
 
 		// Uncomment if you are using Slate UI
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
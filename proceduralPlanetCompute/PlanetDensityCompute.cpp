@@ -0,0 +1,246 @@
+#include "PlanetDensityCompute.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "DataDrivenShaderPlatformInfo.h"
+#include "GlobalShader.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "RHI.h"
+#include "RHIGPUReadback.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderingThread.h"
+#include "ShaderCore.h"
+#include "ShaderParameterStruct.h"
+#include "Tasks/Task.h"
+
+
+// Shaders/PlanetDensity.usf: one thread per sample of the field
+class FPlanetDensityCS : public FGlobalShader
+{
+    public:
+        DECLARE_GLOBAL_SHADER(FPlanetDensityCS);
+        SHADER_USE_PARAMETER_STRUCT(FPlanetDensityCS, FGlobalShader);
+
+        static constexpr int32 ThreadGroupSize = 4;  // 4^3 threads per group
+
+        BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+            SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<float3>, ColumnDirections)
+            SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<float>, AltitudeRadii)
+            SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<float>, OutDensities)
+            SHADER_PARAMETER(uint32, SampleCount)
+            SHADER_PARAMETER(float, PlanetRadius)
+            SHADER_PARAMETER(float, VoxelSize)
+            SHADER_PARAMETER(int32, Seed)
+            SHADER_PARAMETER(int32, Octaves)
+            SHADER_PARAMETER(float, Frequency)
+            SHADER_PARAMETER(float, Lacunarity)
+            SHADER_PARAMETER(float, Persistence)
+            SHADER_PARAMETER(float, Amplitude)
+        END_SHADER_PARAMETER_STRUCT()
+
+        static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters &Parameters)
+        {
+            return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+        }
+
+        static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters &Parameters, FShaderCompilerEnvironment &OutEnvironment)
+        {
+            FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+            OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZE"), ThreadGroupSize);
+        }
+};
+
+IMPLEMENT_GLOBAL_SHADER(FPlanetDensityCS, "/PlanetCompute/PlanetDensity.usf", "MainCS", SF_Compute);
+
+
+namespace
+{
+    // One field, shared by the waiting worker and the render thread. The worker may give up and drop it first.
+    struct FPlanetDensityRequest
+    {
+            FPlanetDensityDispatch Dispatch;
+            TArray<float> Densities;
+            TUniquePtr<FRHIGPUBufferReadback> Readback;  // Render thread only
+            bool bSucceeded = false;                     // Written before Done is triggered
+            UE::Tasks::FTaskEvent Done{UE_SOURCE_LOCATION};
+    };
+
+    using FPlanetDensityRequestPtr = TSharedPtr<FPlanetDensityRequest, ESPMode::ThreadSafe>;
+
+
+    // Submitted fields wait here until the game thread ticker queues a render command, which dispatches all of them
+    // in one graph and completes the readbacks that arrived since the previous one.
+    class FPlanetDensityQueue
+    {
+        public:
+            // Any thread
+            void Submit(const FPlanetDensityRequestPtr &Request)
+            {
+                NumOutstanding.Increment();
+                Submitted.Enqueue(Request);
+            }
+
+            // Game thread, once per frame. At most one render command in flight.
+            void Tick(const TSharedRef<FPlanetDensityQueue, ESPMode::ThreadSafe> &Self)
+            {
+                if (NumOutstanding.GetValue() == 0 || bRenderCommandQueued)
+                    return;
+
+                bRenderCommandQueued = true;
+                ENQUEUE_RENDER_COMMAND(PlanetDensityCompute)([Self](FRHICommandListImmediate &RHICmdList) { Self->RenderThreadTick(RHICmdList); });
+            }
+
+        private:
+            TQueue<FPlanetDensityRequestPtr, EQueueMode::Mpsc> Submitted;
+            TArray<FPlanetDensityRequestPtr> InFlight;  // Render thread only
+            FThreadSafeCounter NumOutstanding;          // Submitted and not completed yet
+            FThreadSafeBool bRenderCommandQueued;
+
+            static void Complete(FPlanetDensityRequest &Request, bool bSucceeded)
+            {
+                Request.bSucceeded = bSucceeded;
+                Request.Readback.Reset();
+                Request.Done.Trigger();
+            }
+
+            void RenderThreadTick(FRHICommandListImmediate &RHICmdList)
+            {
+                bRenderCommandQueued = false;
+
+                for (int32 Index = InFlight.Num() - 1; Index >= 0; --Index)
+                {
+                    FPlanetDensityRequest &Request = *InFlight[Index];
+                    if (!Request.Readback->IsReady())
+                        continue;
+
+                    const uint32 NumBytes = Request.Densities.Num() * sizeof(float);
+                    FMemory::Memcpy(Request.Densities.GetData(), Request.Readback->Lock(NumBytes), NumBytes);
+                    Request.Readback->Unlock();
+                    Complete(Request, true);
+                    NumOutstanding.Decrement();
+                    InFlight.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+                }
+
+                if (Submitted.IsEmpty())
+                    return;
+
+                TShaderMapRef<FPlanetDensityCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+                FRDGBuilder GraphBuilder(RHICmdList);
+
+                FPlanetDensityRequestPtr Request;
+                while (Submitted.Dequeue(Request))
+                {
+                    // The module loaded too late for its shader to be compiled
+                    const FPlanetDensityDispatch &Dispatch = Request->Dispatch;
+                    if (!ComputeShader.IsValid() || Dispatch.SampleCount <= 0)
+                    {
+                        Complete(*Request, false);
+                        NumOutstanding.Decrement();
+                        continue;
+                    }
+
+                    const int32 NumSamples = Dispatch.SampleCount * Dispatch.SampleCount * Dispatch.SampleCount;
+                    Request->Densities.SetNumUninitialized(NumSamples);
+
+                    FRDGBufferRef Directions = CreateStructuredBuffer(GraphBuilder, TEXT("Planet.ColumnDirections"), sizeof(FVector3f),
+                                                                      Dispatch.ColumnDirections.Num(), Dispatch.ColumnDirections.GetData(),
+                                                                      Dispatch.ColumnDirections.Num() * sizeof(FVector3f));
+                    FRDGBufferRef Radii = CreateStructuredBuffer(GraphBuilder, TEXT("Planet.AltitudeRadii"), sizeof(float), Dispatch.AltitudeRadii.Num(),
+                                                                 Dispatch.AltitudeRadii.GetData(), Dispatch.AltitudeRadii.Num() * sizeof(float));
+                    FRDGBufferRef Densities =
+                        GraphBuilder.CreateBuffer(FRDGBufferDesc::CreateStructuredDesc(sizeof(float), NumSamples), TEXT("Planet.Densities"));
+
+                    FPlanetDensityCS::FParameters *Parameters = GraphBuilder.AllocParameters<FPlanetDensityCS::FParameters>();
+                    Parameters->ColumnDirections = GraphBuilder.CreateSRV(Directions);
+                    Parameters->AltitudeRadii = GraphBuilder.CreateSRV(Radii);
+                    Parameters->OutDensities = GraphBuilder.CreateUAV(Densities);
+                    Parameters->SampleCount = Dispatch.SampleCount;
+                    Parameters->PlanetRadius = Dispatch.PlanetRadius;
+                    Parameters->VoxelSize = Dispatch.VoxelSize;
+                    Parameters->Seed = Dispatch.Seed;
+                    Parameters->Octaves = Dispatch.Octaves;
+                    Parameters->Frequency = Dispatch.Frequency;
+                    Parameters->Lacunarity = Dispatch.Lacunarity;
+                    Parameters->Persistence = Dispatch.Persistence;
+                    Parameters->Amplitude = Dispatch.Amplitude;
+
+                    FComputeShaderUtils::AddPass(GraphBuilder,
+                                                 RDG_EVENT_NAME("PlanetDensity %d^3", Dispatch.SampleCount),
+                                                 ComputeShader,
+                                                 Parameters,
+                                                 FComputeShaderUtils::GetGroupCount(FIntVector(Dispatch.SampleCount), FPlanetDensityCS::ThreadGroupSize));
+
+                    Request->Readback = MakeUnique<FRHIGPUBufferReadback>(TEXT("Planet.DensityReadback"));
+                    AddEnqueueCopyPass(GraphBuilder, Request->Readback.Get(), Densities, NumSamples * sizeof(float));
+                    InFlight.Add(Request);
+                }
+
+                GraphBuilder.Execute();
+            }
+    };
+}
+
+
+class FPlanetDensityComputeModule : public IPlanetDensityCompute
+{
+    public:
+        virtual void StartupModule() override
+        {
+            // The shaders ship next to the module sources
+            AddShaderSourceDirectoryMapping(TEXT("/PlanetCompute"), FPaths::Combine(FPaths::GameSourceDir(), TEXT("proceduralPlanetCompute/Shaders")));
+
+            TSharedRef<FPlanetDensityQueue, ESPMode::ThreadSafe> Queue = DensityQueue.ToSharedRef();
+            TickHandle = FTSTicker::GetCoreTicker().AddTicker(TEXT("PlanetDensityCompute"),
+                                                              0.f,
+                                                              [Queue](float)
+                                                              {
+                                                                  Queue->Tick(Queue);
+                                                                  return true;
+                                                              });
+        }
+
+        virtual void ShutdownModule() override
+        {
+            // Fields still waiting are never completed: their workers time out and build them on the CPU
+            FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+        }
+
+        virtual bool IsAvailable() const override { return FApp::CanEverRender() && IsFeatureLevelSupported(GMaxRHIShaderPlatform, ERHIFeatureLevel::SM5); }
+
+        virtual bool ComputeDensities(const FPlanetDensityDispatch &Dispatch, float *OutDensities, const FThreadSafeBool *CancelFlag,
+                                      float TimeoutSeconds) override
+        {
+            check(!IsInGameThread() && !IsInRenderingThread());
+
+            FPlanetDensityRequestPtr Request = MakeShared<FPlanetDensityRequest, ESPMode::ThreadSafe>();
+            Request->Dispatch = Dispatch;
+            DensityQueue->Submit(Request);
+
+            // Short waits, so a cancelled chunk releases its worker without waiting for the readback
+            const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+            while (!Request->Done.Wait(FTimespan::FromMilliseconds(2.0)))
+            {
+                if ((CancelFlag && *CancelFlag) || FPlatformTime::Seconds() > Deadline)
+                    return false;
+            }
+
+            if (!Request->bSucceeded)
+                return false;
+
+            FMemory::Memcpy(OutDensities, Request->Densities.GetData(), Request->Densities.Num() * sizeof(float));
+            return true;
+        }
+
+    private:
+        // Never reset: a late worker may still submit to it during shutdown
+        TSharedPtr<FPlanetDensityQueue, ESPMode::ThreadSafe> DensityQueue = MakeShared<FPlanetDensityQueue, ESPMode::ThreadSafe>();
+        FTSTicker::FDelegateHandle TickHandle;
+};
+
+
+IPlanetDensityCompute *IPlanetDensityCompute::Get() { return FModuleManager::GetModulePtr<IPlanetDensityCompute>(TEXT("proceduralPlanetCompute")); }
+
+IMPLEMENT_MODULE(FPlanetDensityComputeModule, proceduralPlanetCompute);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Modules/ModuleInterface.h"
+
+
+// Inputs of one chunk density field. Mirrors what DensityGenerator::GenerateDensitySlab reads from GenData and DensityConfig,
+// so this module does not depend on the game module.
+struct FPlanetDensityDispatch
+{
+        int32 SampleCount = 0;
+        TArray<FVector3f> ColumnDirections;  // SampleCount^2 unit-sphere directions, x fastest
+        TArray<float> AltitudeRadii;         // Radius of each z slice
+        float PlanetRadius = 0.f;
+        float VoxelSize = 0.f;
+
+        // FBM of SimpleNoise, same parameters as FNoiseSettings. 0 octaves = sphere only.
+        int32 Seed = 0;
+        int32 Octaves = 0;
+        float Frequency = 0.f;
+        float Lacunarity = 0.f;
+        float Persistence = 0.f;
+        float Amplitude = 0.f;
+};
+
+
+// GPU evaluation of chunk density fields: the sphere term plus the SimpleNoise FBM, one compute dispatch per chunk.
+// Submitted fields are batched into one render graph per frame and read back asynchronously.
+// Optional: the module must be listed in the .uproject with "LoadingPhase": "PostConfigInit" for its shader to be compiled.
+class PROCEDURALPLANETCOMPUTE_API IPlanetDensityCompute : public IModuleInterface
+{
+    public:
+        // Null if the module is not loaded. Game thread.
+        static IPlanetDensityCompute *Get();
+
+        // False on the null RHI or below SM5: callers should stay on the CPU.
+        virtual bool IsAvailable() const = 0;
+
+        // Fills SampleCount^3 densities (x fastest, then y, then z) and returns true.
+        // Blocks the calling worker until the readback arrived: never call it from the game or render thread, which complete it.
+        // Returns false with OutDensities untouched if CancelFlag was raised, the GPU did not answer within TimeoutSeconds
+        // or the shader is missing.
+        virtual bool ComputeDensities(const FPlanetDensityDispatch &Dispatch, float *OutDensities, const FThreadSafeBool *CancelFlag,
+                                      float TimeoutSeconds) = 0;
+};
@@ -0,0 +1,21 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// GPU density backend of the planet generator. Has no UObjects and no dependency on the game module,
+// so it can load at PostConfigInit: its global shader must be registered before the shader map is built.
+public class proceduralPlanetCompute : ModuleRules
+{
+	public proceduralPlanetCompute(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicIncludePaths.Add(ModuleDirectory);
+
+		PublicDependencyModuleNames.AddRange(new string[] { "Core" });
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "CoreUObject",
+															 "RenderCore",
+															 "RHI" });
+	}
+}
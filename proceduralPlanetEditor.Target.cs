@@ -9,6 +9,6 @@ public class proceduralPlanetEditorTarget : TargetRules
 	{
 		Type = TargetType.Editor;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
-		ExtraModuleNames.AddRange( new string[] { "proceduralPlanet" } );
+		ExtraModuleNames.AddRange( new string[] { "proceduralPlanet", "proceduralPlanetCompute" } );
 	}
 }